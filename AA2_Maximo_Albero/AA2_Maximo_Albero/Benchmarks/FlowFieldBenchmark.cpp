@@ -0,0 +1,129 @@
+#include "../Game/FlowField.h"
+#include "../Game/Wall.h"
+#include "../NodeMap/NodeMap.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+
+// Cost of a FlowField update on a walled room of 20x10 (the game rooms), 200x200 and 1000x1000
+//   FlowFieldBenchmark
+// First update: obstacles read from the NodeMap and BFS (what MarkObstaclesDirty() costs)
+// BFS recompute: the target moved one cell, same obstacles
+// Unchanged target: what every tick costs while the player stands still
+// GetStep: the per enemy lookup
+
+struct CaseResult
+{
+    double firstUpdateUs;
+    double recomputeUs;
+    double unchangedNs;
+    double getStepNs;
+};
+
+// Runs action until at least minSeconds have passed, returns the average duration in seconds
+template<typename F>
+double TimeAverage(F action, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    int runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+
+    do
+    {
+        action();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed / runs;
+}
+
+CaseResult Run(Vector2 size)
+{
+    CaseResult result;
+    NodeMap map(size, Vector2(0, 0));
+    std::vector<std::unique_ptr<Wall>> walls;
+
+    // A wall border and 10% walls inside, the target cells stay free
+    Vector2 target(size.X / 2, size.Y / 2);
+    Vector2 movedTarget(size.X / 2 + 1, size.Y / 2);
+
+    for (int y = 0; y < size.Y; y++)
+    {
+        for (int x = 0; x < size.X; x++)
+        {
+            bool border = x == 0 || y == 0 || x == size.X - 1 || y == size.Y - 1;
+            bool isTarget = y == target.Y && (x == target.X || x == movedTarget.X);
+            if (!isTarget && (border || rand() % 100 < 10))
+            {
+                walls.push_back(std::unique_ptr<Wall>(new Wall()));
+                Wall* wall = walls.back().get();
+                map.SafePickNode(Vector2(x, y), [wall](Node* node) { node->SetContent(wall); });
+            }
+        }
+    }
+
+    FlowField field(&map);
+    field.Update(target);
+
+    result.firstUpdateUs = TimeAverage([&]() {
+        field.MarkObstaclesDirty();
+        field.Update(target);
+        }, 0.5) * 1e6;
+
+    // Two moves per run, each one a full BFS
+    result.recomputeUs = TimeAverage([&]() {
+        field.Update(movedTarget);
+        field.Update(target);
+        }, 0.5) / 2 * 1e6;
+
+    result.unchangedNs = TimeAverage([&]() {
+        for (int i = 0; i < 1000; i++)
+            field.Update(target);
+        }, 0.3) / 1000 * 1e9;
+
+    std::vector<Vector2> positions;
+    for (int i = 0; i < 1000; i++)
+    {
+        positions.push_back(Vector2(rand() % size.X, rand() % size.Y));
+    }
+
+    long long moved = 0;
+    result.getStepNs = TimeAverage([&]() {
+        for (Vector2 position : positions)
+            moved += field.GetStep(position).X;
+        }, 0.3) / positions.size() * 1e9;
+
+    // Keeps the lookups from being optimized away
+    if (moved == 0x7fffffff)
+        std::cout << moved;
+
+    return result;
+}
+
+int main()
+{
+    srand(1234);
+
+    const Vector2 sizes[] = { Vector2(20, 10), Vector2(200, 200), Vector2(1000, 1000) };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "room      | first update us | BFS recompute us | unchanged ns | GetStep ns" << std::endl;
+
+    for (Vector2 size : sizes)
+    {
+        CaseResult result = Run(size);
+
+        std::cout << std::setw(4) << size.X << "x" << std::setw(4) << size.Y << " | "
+            << std::setw(15) << result.firstUpdateUs << " | "
+            << std::setw(16) << result.recomputeUs << " | "
+            << std::setw(12) << result.unchangedNs << " | "
+            << std::setw(10) << result.getStepNs << std::endl;
+    }
+
+    return 0;
+}
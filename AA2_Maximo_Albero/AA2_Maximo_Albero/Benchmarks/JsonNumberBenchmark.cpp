@@ -0,0 +1,170 @@
+#include "../dist/json/json.h"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+// jsoncpp write and parse times on a synthetic save with 100k entities (100x100 rooms, 10 each)
+//   JsonNumberBenchmark / JsonNumberBenchmarkLegacy
+// Both are built from this file: JsonNumberBenchmark with the bundled jsoncpp (std::to_chars /
+// std::from_chars for doubles), JsonNumberBenchmarkLegacy with a copy built with
+// JSONCPP_HAS_CHARCONV=0 (snprintf and istringstream, the code before the change)
+// Integer save: the save layout, every number is an int
+// Doubles: the same entities with fractional positions, the path that changed. Its values are
+// also read back and compared, both builds must round-trip them exactly
+
+#if defined(JSONCPP_HAS_CHARCONV) && !JSONCPP_HAS_CHARCONV
+static const char* NUMBER_PATH = "legacy (snprintf / istringstream)";
+#else
+static const char* NUMBER_PATH = "charconv (to_chars / from_chars)";
+#endif
+
+static const int WORLD_SIDE = 100;
+static const int ENTITIES_PER_ROOM = 10;
+static const int RUNS = 7;
+
+// Same keys and nesting as Room::Code() and the entity snapshots
+static Json::Value MakeSave(bool fractional)
+{
+    Json::Value save;
+    Json::Value& rooms = save["rooms"];
+    int entity = 0;
+
+    for (int y = 0; y < WORLD_SIDE; y++)
+    {
+        for (int x = 0; x < WORLD_SIDE; x++)
+        {
+            Json::Value room;
+            room["x"] = x;
+            room["y"] = y;
+            room["initialized"] = true;
+
+            Json::Value& enemies = room["enemies"];
+            for (int i = 0; i < ENTITIES_PER_ROOM; i++, entity++)
+            {
+                Json::Value enemy;
+                enemy["type"] = 2;
+                if (fractional)
+                {
+                    // Values that need every significant digit to round-trip
+                    enemy["posX"] = 1 + (entity % 18) + entity / 7.0e5;
+                    enemy["posY"] = 1 + (entity % 8) + 1.0 / (entity + 3);
+                }
+                else
+                {
+                    enemy["posX"] = 1 + entity % 18;
+                    enemy["posY"] = 1 + entity % 8;
+                }
+                enemy["hp"] = 30;
+                enemy["damage"] = 10;
+                enemies.append(enemy);
+            }
+
+            rooms.append(room);
+        }
+    }
+
+    return save;
+}
+
+// Best of RUNS, in milliseconds
+template<typename F>
+static double BestMs(F action)
+{
+    double best = 1e30;
+
+    for (int run = 0; run < RUNS; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        action();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+static std::string Write(const Json::Value& save)
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, save);
+}
+
+static Json::Value Parse(const std::string& text)
+{
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+
+    Json::Value save;
+    std::string errors;
+    if (!reader->parse(text.data(), text.data() + text.size(), &save, &errors))
+    {
+        std::cerr << "Parse failed: " << errors << std::endl;
+        std::exit(1);
+    }
+
+    return save;
+}
+
+// Every posX/posY read back equals the written double
+static bool RoundTrips(const Json::Value& written, const Json::Value& read)
+{
+    const Json::Value& writtenRooms = written["rooms"];
+    const Json::Value& readRooms = read["rooms"];
+
+    for (Json::ArrayIndex room = 0; room < writtenRooms.size(); room++)
+    {
+        const Json::Value& writtenEnemies = writtenRooms[room]["enemies"];
+        const Json::Value& readEnemies = readRooms[room]["enemies"];
+
+        for (Json::ArrayIndex i = 0; i < writtenEnemies.size(); i++)
+        {
+            if (writtenEnemies[i]["posX"].asDouble() != readEnemies[i]["posX"].asDouble() ||
+                writtenEnemies[i]["posY"].asDouble() != readEnemies[i]["posY"].asDouble())
+                return false;
+        }
+    }
+
+    return true;
+}
+
+int main()
+{
+    std::cout << "Number path: " << NUMBER_PATH << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "save            |     size | write ms | parse ms" << std::endl;
+
+    bool passed = true;
+
+    for (bool fractional : { false, true })
+    {
+        Json::Value save = MakeSave(fractional);
+        std::string text = Write(save);
+
+        std::string written;
+        double writeMs = BestMs([&]() { written = Write(save); });
+
+        Json::Value read;
+        double parseMs = BestMs([&]() { read = Parse(text); });
+
+        std::cout << std::setw(15) << (fractional ? "100k doubles" : "integer save") << " | "
+            << std::setw(7) << text.size() / 1024 << "KB | "
+            << std::setw(8) << writeMs << " | "
+            << std::setw(8) << parseMs;
+
+        if (fractional)
+        {
+            bool exact = RoundTrips(save, read);
+            std::cout << " | round-trip " << (exact ? "exact" : "WRONG");
+            passed = passed && exact;
+        }
+
+        std::cout << std::endl;
+    }
+
+    return passed ? 0 : 1;
+}
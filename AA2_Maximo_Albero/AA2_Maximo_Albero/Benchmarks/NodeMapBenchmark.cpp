@@ -0,0 +1,209 @@
+#include "../NodeMap/NodeMap.h"
+#include "../Utils/ConsoleControl.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+
+// Lookup and full-map iteration throughput of NodeMap against the storage it replaced
+//   NodeMapBenchmark [lookups per map]
+// Lookup: SafePickNode on random cells
+// Scan: SafePickNode on every cell in row order (what FlowField and PathService do to load obstacles)
+// Draw: UnSafeDraw of the whole map into the headless frame buffer
+
+// The old layout: columns of heap-allocated nodes, a mutex per node and mutexes for size and grid
+class LegacyNodeMap
+{
+public:
+    struct LegacyNode
+    {
+        Vector2 position;
+        INodeContent* content = nullptr;
+        std::mutex nodeMutex;
+
+        LegacyNode(Vector2 position) : position(position) {}
+
+        INodeContent* GetContent() { return content; }
+
+        void DrawContent(Vector2 offset)
+        {
+            Vector2 pos = offset + position;
+            if (content == nullptr) {
+                CC::DrawCell(pos.X, pos.Y, ' ');
+                return;
+            }
+
+            content->Draw(pos);
+        }
+    };
+
+    typedef std::vector<LegacyNode*> NodeColumn;
+    typedef std::function<void(LegacyNode* node)> SafePick;
+
+    LegacyNodeMap(Vector2 size, Vector2 offset) : _offset(offset), _size(size)
+    {
+        for (int x = 0; x < _size.X; x++) {
+            NodeColumn* column = new NodeColumn();
+
+            for (int y = 0; y < _size.Y; y++) {
+                column->push_back(new LegacyNode(Vector2(x, y)));
+            }
+
+            _grid.push_back(column);
+        }
+    }
+
+    ~LegacyNodeMap()
+    {
+        for (NodeColumn* column : _grid) {
+            for (LegacyNode* node : *column) {
+                delete node;
+            }
+            delete column;
+        }
+    }
+
+    void UnSafeDraw()
+    {
+        for (NodeColumn* column : _grid) {
+            for (LegacyNode* node : *column) {
+                node->DrawContent(_offset);
+            }
+        }
+    }
+
+    void SafePickNode(Vector2 position, SafePick safePickAction)
+    {
+        _sizeMutex.lock();
+        _gridMutex.lock();
+
+        LegacyNode* node = nullptr;
+        if (position.X >= 0 && position.Y >= 0 && position.X < _size.X && position.Y < _size.Y)
+            node = (*_grid[position.X])[position.Y];
+
+        _gridMutex.unlock();
+        _sizeMutex.unlock();
+
+        node->nodeMutex.lock();
+        safePickAction(node);
+        node->nodeMutex.unlock();
+    }
+
+private:
+    Vector2 _offset;
+    Vector2 _size;
+    std::mutex _sizeMutex;
+    std::vector<NodeColumn*> _grid;
+    std::mutex _gridMutex;
+};
+
+struct MapResult
+{
+    double lookupsPerSecond;
+    double scannedCellsPerSecond;
+    double drawnCellsPerSecond;
+};
+
+template<typename Map, typename NodeType>
+MapResult Measure(Map& map, Vector2 size, const std::vector<Vector2>& lookups)
+{
+    typedef std::chrono::steady_clock Clock;
+    MapResult result;
+    long long cells = (long long)size.X * size.Y;
+    long long found = 0;
+
+    auto start = Clock::now();
+    for (Vector2 position : lookups)
+    {
+        map.SafePickNode(position, [&found](NodeType* node) { found += node != nullptr; });
+    }
+    result.lookupsPerSecond = lookups.size() / std::chrono::duration<double>(Clock::now() - start).count();
+
+    // At least 4M cells so the small maps are timed over enough work
+    int passes = (int)std::max(1LL, 4000000LL / cells);
+
+    start = Clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (int y = 0; y < size.Y; y++)
+        {
+            for (int x = 0; x < size.X; x++)
+            {
+                map.SafePickNode(Vector2(x, y), [&found](NodeType* node) { found += node->GetContent() == nullptr; });
+            }
+        }
+    }
+    result.scannedCellsPerSecond = cells * passes / std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        map.UnSafeDraw();
+    }
+    result.drawnCellsPerSecond = cells * passes / std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Keeps the picks from being optimized away
+    if (found < 0)
+        std::cout << found;
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    int lookupCount = argc > 1 ? atoi(argv[1]) : 2000000;
+    const Vector2 sizes[] = { Vector2(20, 10), Vector2(256, 256), Vector2(2048, 2048) };
+    MapResult legacyResults[3];
+    MapResult flatResults[3];
+
+    // Headless also silences std::cout, the table is printed after the runs
+    CC::SetHeadless(true);
+
+    for (int i = 0; i < 3; i++)
+    {
+        Vector2 size = sizes[i];
+
+        std::vector<Vector2> lookups;
+        lookups.reserve(lookupCount);
+        for (int n = 0; n < lookupCount; n++)
+        {
+            lookups.push_back(Vector2(rand() % size.X, rand() % size.Y));
+        }
+
+        {
+            LegacyNodeMap legacy(size, Vector2(0, 0));
+            legacyResults[i] = Measure<LegacyNodeMap, LegacyNodeMap::LegacyNode>(legacy, size, lookups);
+        }
+
+        {
+            NodeMap flat(size, Vector2(0, 0));
+            flatResults[i] = Measure<NodeMap, Node>(flat, size, lookups);
+        }
+    }
+
+    CC::SetHeadless(false);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "map        | storage | lookups M/s | scan M cells/s | draw M cells/s" << std::endl;
+
+    for (int i = 0; i < 3; i++)
+    {
+        const MapResult* results[] = { &legacyResults[i], &flatResults[i] };
+        const char* names[] = { "columns", "flat" };
+
+        for (int r = 0; r < 2; r++)
+        {
+            std::cout << std::setw(4) << sizes[i].X << "x" << std::left << std::setw(5) << sizes[i].Y << std::right << " | "
+                << std::setw(7) << names[r] << " | "
+                << std::setw(11) << results[r]->lookupsPerSecond / 1e6 << " | "
+                << std::setw(14) << results[r]->scannedCellsPerSecond / 1e6 << " | "
+                << std::setw(14) << results[r]->drawnCellsPerSecond / 1e6 << std::endl;
+        }
+    }
+
+    return 0;
+}
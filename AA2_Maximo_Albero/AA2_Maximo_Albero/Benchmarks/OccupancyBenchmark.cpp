@@ -0,0 +1,196 @@
+#include "../Game/OccupancyGrid.h"
+#include "../Game/Enemy.h"
+#include "../Game/Chest.h"
+#include "../Game/Item.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+
+// Entity queries through the OccupancyGrid against the list scans it replaced, with 1k and 10k entities
+//   OccupancyBenchmark [lookups]
+// Entities are 80% enemies, 10% chests and 10% items on distinct cells of a 200x200 room
+// Lookup: "which enemy is on this cell" (GetEntityAtPosition<Enemy>) on random cells
+// Enemy tick: every enemy asks to step to a neighbour cell (CanEnemyMoveTo), which scanned the three lists
+
+const Vector2 ROOM_SIZE(200, 200);
+
+// What the lists held: every GetPosition() locked the entity
+struct LegacyEntity
+{
+    Vector2 position;
+    std::mutex entityMutex;
+
+    Vector2 GetPosition()
+    {
+        entityMutex.lock();
+        Vector2 pos = position;
+        entityMutex.unlock();
+        return pos;
+    }
+};
+
+struct LegacyLists
+{
+    std::vector<LegacyEntity*> enemies;
+    std::vector<LegacyEntity*> chests;
+    std::vector<LegacyEntity*> items;
+
+    static LegacyEntity* FindAt(const std::vector<LegacyEntity*>& list, Vector2 position)
+    {
+        for (LegacyEntity* entity : list)
+        {
+            Vector2 pos = entity->GetPosition();
+            if (pos.X == position.X && pos.Y == position.Y)
+                return entity;
+        }
+        return nullptr;
+    }
+
+    bool CanMoveTo(Vector2 position)
+    {
+        return FindAt(enemies, position) == nullptr && FindAt(chests, position) == nullptr && FindAt(items, position) == nullptr;
+    }
+};
+
+struct ScalingResult
+{
+    double listLookupNs;
+    double gridLookupNs;
+    double listTickUs;
+    double gridTickUs;
+};
+
+// Runs action until at least minSeconds have passed, returns the average duration in seconds
+template<typename F>
+double TimeAverage(F action, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    int runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+
+    do
+    {
+        action();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed / runs;
+}
+
+ScalingResult Run(int entityCount, int lookupCount)
+{
+    ScalingResult result;
+    LegacyLists lists;
+    OccupancyGrid grid(ROOM_SIZE);
+    std::vector<EntityHandle> enemyHandles;
+    std::vector<Vector2> enemyPositions;
+
+    // Distinct cells: entity i goes to cell i * 3 (the room has 40000 cells)
+    for (int i = 0; i < entityCount; i++)
+    {
+        int cell = (i * 3) % (ROOM_SIZE.X * ROOM_SIZE.Y);
+        Vector2 position(cell % ROOM_SIZE.X, cell / ROOM_SIZE.X);
+
+        LegacyEntity* entity = new LegacyEntity();
+        entity->position = position;
+
+        EntityHandle handle;
+        handle.index = i;
+        handle.generation = 1;
+
+        if (i % 10 == 8)
+        {
+            lists.chests.push_back(entity);
+            grid.Set<Chest>(position, handle);
+        }
+        else if (i % 10 == 9)
+        {
+            lists.items.push_back(entity);
+            grid.Set<Item>(position, handle);
+        }
+        else
+        {
+            lists.enemies.push_back(entity);
+            grid.Set<Enemy>(position, handle);
+            enemyHandles.push_back(handle);
+            enemyPositions.push_back(position);
+        }
+    }
+
+    std::vector<Vector2> lookups;
+    for (int i = 0; i < lookupCount; i++)
+    {
+        lookups.push_back(Vector2(rand() % ROOM_SIZE.X, rand() % ROOM_SIZE.Y));
+    }
+
+    long long found = 0;
+
+    result.listLookupNs = TimeAverage([&]() {
+        for (Vector2 position : lookups)
+            found += LegacyLists::FindAt(lists.enemies, position) != nullptr;
+        }, 0.3) / lookupCount * 1e9;
+
+    result.gridLookupNs = TimeAverage([&]() {
+        for (Vector2 position : lookups)
+            found += grid.Get<Enemy>(position).IsValid();
+        }, 0.3) / lookupCount * 1e9;
+
+    // One step right and one back, so the positions stay the same between ticks
+    result.listTickUs = TimeAverage([&]() {
+        for (LegacyEntity* enemy : lists.enemies)
+        {
+            Vector2 position = enemy->GetPosition();
+            found += lists.CanMoveTo(Vector2(position.X + 1, position.Y));
+        }
+        }, 0.5) * 1e6;
+
+    result.gridTickUs = TimeAverage([&]() {
+        for (size_t i = 0; i < enemyHandles.size(); i++)
+        {
+            Vector2 from = enemyPositions[i];
+            Vector2 to(from.X + 1, from.Y);
+            if (grid.TryMove(enemyHandles[i], from, to))
+            {
+                grid.TryMove(enemyHandles[i], to, from);
+                found++;
+            }
+        }
+        }, 0.5) * 1e6;
+
+    for (std::vector<LegacyEntity*>* list : { &lists.enemies, &lists.chests, &lists.items })
+    {
+        for (LegacyEntity* entity : *list)
+            delete entity;
+    }
+
+    // Keeps the queries from being optimized away
+    if (found < 0)
+        std::cout << found;
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    int lookupCount = argc > 1 ? atoi(argv[1]) : 20000;
+    const int entityCounts[] = { 1000, 10000 };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "entities | lookup ns: lists   grid | enemy tick us: lists       grid" << std::endl;
+
+    for (int entityCount : entityCounts)
+    {
+        ScalingResult result = Run(entityCount, lookupCount);
+
+        std::cout << std::setw(8) << entityCount << " | "
+            << std::setw(16) << result.listLookupNs << std::setw(7) << result.gridLookupNs << " | "
+            << std::setw(20) << result.listTickUs << std::setw(11) << result.gridTickUs << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "../Game/PathService.h"
+#include "../NodeMap/NodeMap.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+// Paths per second of the PathService on a 20x10 room (10% obstacles) and a 200x200 grid (20%)
+//   PathServiceBenchmark
+// Cache miss: a new start/goal pair every query, a full A* (the evicted search storage is reused)
+// Cache hit: the same pair again with nothing changed
+// Repair: one cell is blocked and freed again, each next query repairs the search (LPA*)
+//   off path: a free cell the path does not use, the usual case (the path stays the same)
+//   on path: the middle cell of the path, the worst case (everything behind it is searched again)
+
+struct CaseResult
+{
+    double missPerSecond;
+    double hitPerSecond;
+    double offPathRepairPerSecond;
+    double onPathRepairPerSecond;
+    double averageLength;
+};
+
+// Runs action until at least minSeconds have passed, returns the average duration in seconds
+template<typename F>
+double TimeAverage(F action, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    int runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+
+    do
+    {
+        action();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed / runs;
+}
+
+static Vector2 RandomCell(Vector2 size)
+{
+    return Vector2(rand() % size.X, rand() % size.Y);
+}
+
+CaseResult Run(Vector2 size, int obstaclePercent)
+{
+    CaseResult result;
+    NodeMap map(size, Vector2(0, 0));
+    PathService service(&map);
+
+    for (int y = 0; y < size.Y; y++)
+    {
+        for (int x = 0; x < size.X; x++)
+            service.SetBlocked(Vector2(x, y), rand() % 100 < obstaclePercent);
+    }
+
+    // Reachable pairs only, more of them than the cache holds so every query misses
+    std::vector<PathService::PathQuery> pairs;
+    std::vector<Vector2> path;
+    long long totalLength = 0;
+
+    while (pairs.size() < PATH_CACHE_CAPACITY * 4)
+    {
+        PathService::PathQuery query = { RandomCell(size), RandomCell(size) };
+        if (service.IsBlocked(query.start) || !service.FindPath(query.start, query.goal, path) || path.empty())
+            continue;
+
+        pairs.push_back(query);
+        totalLength += path.size();
+    }
+
+    result.averageLength = (double)totalLength / pairs.size();
+
+    long long found = 0;
+
+    double missSeconds = TimeAverage([&]() {
+        for (const PathService::PathQuery& query : pairs)
+            found += service.FindPath(query.start, query.goal, path);
+        }, 0.5) / pairs.size();
+
+    const PathService::PathQuery& hitPair = pairs[0];
+    service.FindPath(hitPair.start, hitPair.goal, path);
+
+    double hitSeconds = TimeAverage([&]() {
+        for (int i = 0; i < 1000; i++)
+            found += service.FindPath(hitPair.start, hitPair.goal, path);
+        }, 0.5) / 1000;
+
+    service.FindPath(hitPair.start, hitPair.goal, path);
+    Vector2 onPath = path[path.size() / 2];
+
+    Vector2 offPath;
+    bool usedByPath = true;
+    while (usedByPath)
+    {
+        offPath = RandomCell(size);
+        usedByPath = service.IsBlocked(offPath) || (offPath.X == hitPair.start.X && offPath.Y == hitPair.start.Y);
+        for (Vector2 cell : path)
+            usedByPath = usedByPath || (cell.X == offPath.X && cell.Y == offPath.Y);
+    }
+
+    // Blocked and freed again: two repairs per run
+    auto timeRepair = [&](Vector2 toggled) {
+        return TimeAverage([&]() {
+            service.SetBlocked(toggled, true);
+            found += service.FindPath(hitPair.start, hitPair.goal, path);
+            service.SetBlocked(toggled, false);
+            found += service.FindPath(hitPair.start, hitPair.goal, path);
+            }, 0.5) / 2;
+        };
+
+    double offPathSeconds = timeRepair(offPath);
+    double onPathSeconds = timeRepair(onPath);
+
+    // Keeps the queries from being optimized away
+    if (found < 0)
+        std::cout << found;
+
+    result.missPerSecond = 1.0 / missSeconds;
+    result.hitPerSecond = 1.0 / hitSeconds;
+    result.offPathRepairPerSecond = 1.0 / offPathSeconds;
+    result.onPathRepairPerSecond = 1.0 / onPathSeconds;
+    return result;
+}
+
+int main()
+{
+    srand(1234);
+
+    struct Case { Vector2 size; int obstaclePercent; };
+    const Case cases[] = { { Vector2(20, 10), 10 }, { Vector2(200, 200), 20 } };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "grid    | avg length | paths/s: miss          hit  off path repair  on path repair | us: miss  off path   on path" << std::endl;
+
+    for (const Case& testCase : cases)
+    {
+        CaseResult result = Run(testCase.size, testCase.obstaclePercent);
+
+        std::cout << std::setw(3) << testCase.size.X << "x" << std::setw(3) << testCase.size.Y << " | "
+            << std::setw(10) << result.averageLength << " | "
+            << std::setw(19) << result.missPerSecond << std::setw(13) << result.hitPerSecond
+            << std::setw(17) << result.offPathRepairPerSecond << std::setw(16) << result.onPathRepairPerSecond << " | "
+            << std::setw(9) << 1e6 / result.missPerSecond << std::setw(10) << 1e6 / result.offPathRepairPerSecond
+            << std::setw(10) << 1e6 / result.onPathRepairPerSecond << std::endl;
+    }
+
+    return 0;
+}
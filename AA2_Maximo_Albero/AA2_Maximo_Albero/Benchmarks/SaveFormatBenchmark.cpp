@@ -0,0 +1,171 @@
+#include "../Game/SaveManager.h"
+#include "../Game/DungeonMap.h"
+#include "../Game/Player.h"
+#include "../Game/Room.h"
+#include "../Utils/ConsoleControl.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+// File size, save time and load time of the JSON and binary saves, for worlds of 9, 100 and 10000 rooms
+//   SaveFormatBenchmark
+// Each room has 4 enemies, 1 chest and 2 items (a room the player has not cleared yet)
+// Save: SaveManager::WriteSnapshotFile(), the same path as the autosave checkpoint
+// LoadGame: SaveManager::LoadGame() into a new DungeonMap, binary rooms are only indexed
+// (lazy load), the active one is decoded
+// Read all: SaveManager::ReadSnapshotFile() decoding every room, what a JSON load always does
+
+static const char* JSON_PATH = "save_format_benchmark.json";
+static const char* BINARY_PATH = "save_format_benchmark.bin";
+static const int RUNS = 5;
+
+struct CaseResult
+{
+    long long bytes;
+    double saveMs;
+    double loadGameMs;
+    double readAllMs;
+};
+
+static SaveManager::Snapshot MakeWorld(int width, int height)
+{
+    SaveManager::Snapshot snapshot;
+    snapshot.player = { Vector2(2, 2), 50, 50, 12, 1, 0 };
+    snapshot.currentX = width / 2;
+    snapshot.currentY = height / 2;
+    snapshot.worldWidth = width;
+    snapshot.worldHeight = height;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            SaveManager::Snapshot::RoomEntry entry = { x, y, 1, Room::Snapshot(), SaveSegment() };
+            entry.room.initialized = true;
+
+            int cell = (y * width + x) % 7;
+            auto nextPosition = [&cell]() { Vector2 position(1 + cell % 18, 1 + cell / 18 % 8); cell += 5; return position; };
+
+            for (int i = 0; i < 4; i++)
+                entry.room.enemies.push_back({ nextPosition(), 30, 10 });
+            entry.room.chests.push_back({ nextPosition(), 20, false });
+            entry.room.items.push_back({ nextPosition(), ItemType::COIN });
+            entry.room.items.push_back({ nextPosition(), ItemType::POTION });
+
+            snapshot.rooms.push_back(entry);
+        }
+    }
+
+    return snapshot;
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long long FileSize(const char* path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.is_open() ? (long long)file.tellg() : -1;
+}
+
+// Best of RUNS, rooms are built outside the measured time
+static double MeasureLoadGame(const char* path, int width, int height)
+{
+    double best = 1e30;
+
+    for (int run = 0; run < RUNS; run++)
+    {
+        DungeonMap dungeonMap(width, height);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+                dungeonMap.SetRoom(x, y, new Room(Vector2(20, 10), Vector2(0, 0)));
+        }
+
+        Player player;
+        SaveManager saveManager(path, 10);
+
+        // LoadGame() writes to std::cout, headless keeps it quiet
+        CC::SetHeadless(true);
+        auto start = std::chrono::steady_clock::now();
+        bool loaded = saveManager.LoadGame(&dungeonMap, &player);
+        double elapsed = ElapsedMs(start);
+
+        saveManager.StopPrefetch();
+        CC::SetHeadless(false);
+        std::remove((std::string(path) + ".journal").c_str());
+
+        if (!loaded)
+            return -1;
+
+        best = std::min(best, elapsed);
+    }
+
+    return best;
+}
+
+static CaseResult Run(const SaveManager::Snapshot& snapshot, const char* path, SaveFormat format)
+{
+    CaseResult result;
+    result.saveMs = 1e30;
+    result.readAllMs = 1e30;
+
+    for (int run = 0; run < RUNS; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SaveManager::WriteSnapshotFile(path, snapshot, format);
+        result.saveMs = std::min(result.saveMs, ElapsedMs(start));
+    }
+
+    result.bytes = FileSize(path);
+
+    for (int run = 0; run < RUNS; run++)
+    {
+        SaveManager::Snapshot read;
+        auto start = std::chrono::steady_clock::now();
+        SaveManager::ReadSnapshotFile(path, read);
+        result.readAllMs = std::min(result.readAllMs, ElapsedMs(start));
+    }
+
+    result.loadGameMs = MeasureLoadGame(path, snapshot.worldWidth, snapshot.worldHeight);
+    return result;
+}
+
+int main()
+{
+    struct Case { int width; int height; };
+    const Case cases[] = { { 3, 3 }, { 10, 10 }, { 100, 100 } };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "rooms | format |      bytes |  save ms | LoadGame ms | read all ms" << std::endl;
+
+    for (const Case& testCase : cases)
+    {
+        SaveManager::Snapshot snapshot = MakeWorld(testCase.width, testCase.height);
+
+        CaseResult json = Run(snapshot, JSON_PATH, SaveFormat::JSON);
+        CaseResult binary = Run(snapshot, BINARY_PATH, SaveFormat::BINARY);
+
+        const CaseResult* results[] = { &json, &binary };
+        for (int i = 0; i < 2; i++)
+        {
+            std::cout << std::setw(5) << testCase.width * testCase.height << " | "
+                << std::setw(6) << (i == 0 ? "json" : "binary") << " | "
+                << std::setw(10) << results[i]->bytes << " | "
+                << std::setw(8) << results[i]->saveMs << " | "
+                << std::setw(11) << results[i]->loadGameMs << " | "
+                << std::setw(11) << results[i]->readAllMs << std::endl;
+        }
+    }
+
+    std::remove(JSON_PATH);
+    std::remove(BINARY_PATH);
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "../Game/SimulationScheduler.h"
+#include "../Game/Enemy.h"
+#include "../Game/EntityStore.h"
+#include "../Utils/ConsoleControl.h"
+#include "../Utils/GameStats.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+
+// Ticks per second and CPU use of the SimulationScheduler with 10, 100 and 1000 enemies
+//   SimulationBenchmark [seconds per run]
+// Game rate: the fixed 100 ms timestep of the game, the CPU use is what the enemy thread costs
+// Unthrottled: 0 ms timestep, the tick loop runs as fast as it can
+// Every enemy random walks (no player in reach) and acts once per ENEMY_ACTION_COOLDOWN_MS
+//
+// Tick cost: one Tick() called directly over one EntityStore with 1000, 5000 and 10000 enemies
+// Idle: every enemy in cooldown, the pass over the store only reads the arrays
+// All act: every cooldown expired before the tick, so CollectActions() picks an action for each
+// enemy and RunAction() runs it (the callbacks do nothing, it is the cost of the enemy system itself)
+
+struct RunResult
+{
+    double ticksPerSecond;
+    double cpuPercent;
+};
+
+RunResult Run(int enemyCount, int tickMs, double seconds)
+{
+    EntityStore store;
+    std::vector<Enemy*> enemies;
+
+    SimulationScheduler scheduler(tickMs);
+    scheduler.SetEnemyCallbacks(
+        [](EntityStore*, EntityHandle, Vector2) { return true; },
+        []() { return Vector2(-50, -50); },
+        [](EntityStore*, EntityHandle) {});
+
+    for (int i = 0; i < enemyCount; i++)
+    {
+        Enemy* enemy = new Enemy(&store, Vector2(i % 200, i / 200));
+        enemy->StartMovement(&scheduler);
+        enemies.push_back(enemy);
+    }
+
+    GameStats::Reset();
+    std::clock_t cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+
+    scheduler.Start();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    scheduler.Stop();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    for (Enemy* enemy : enemies)
+    {
+        delete enemy;
+    }
+
+    RunResult result;
+    result.ticksPerSecond = GameStats::Get(GameStats::TICKS) / elapsed.count();
+    result.cpuPercent = cpuSeconds / elapsed.count() * 100.0;
+    return result;
+}
+
+struct TickCost
+{
+    double idleUs;
+    double allActUs;
+};
+
+// Runs action until at least minSeconds have passed, returns the average duration in seconds
+template<typename F>
+double TimeAverage(F action, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    int runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+
+    do
+    {
+        action();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed / runs;
+}
+
+TickCost MeasureTick(int enemyCount)
+{
+    EntityStore store;
+    std::vector<Enemy*> enemies;
+
+    // Not started: Tick() runs on this thread
+    SimulationScheduler scheduler(100);
+    scheduler.SetEnemyCallbacks(
+        [](EntityStore*, EntityHandle, Vector2) { return true; },
+        []() { return Vector2(-50, -50); },
+        [](EntityStore*, EntityHandle) {});
+
+    for (int i = 0; i < enemyCount; i++)
+    {
+        Enemy* enemy = new Enemy(&store, Vector2(i % 200, i / 200));
+        enemy->StartMovement(&scheduler);
+        enemies.push_back(enemy);
+    }
+
+    // Fresh enemies wait one cooldown, every tick of the idle run skips them
+    TickCost cost;
+    cost.idleUs = TimeAverage([&]() { scheduler.Tick(); }, 0.5) * 1e6;
+
+    auto expireCooldowns = [&]() {
+        store.Lock();
+        for (size_t i = 0; i < store.Size(); i++)
+            store.CooldownAt(i) = EntityStore::TimePoint();
+        store.Unlock();
+        };
+
+    // The reset is timed on its own and taken out
+    double resetSeconds = TimeAverage(expireCooldowns, 0.2);
+    double actSeconds = TimeAverage([&]() { expireCooldowns(); scheduler.Tick(); }, 0.5);
+    cost.allActUs = (actSeconds - resetSeconds) * 1e6;
+
+    for (Enemy* enemy : enemies)
+    {
+        delete enemy;
+    }
+
+    return cost;
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    const int enemyCounts[] = { 10, 100, 1000 };
+
+    // Headless also silences std::cout, the table is printed after the runs
+    CC::SetHeadless(true);
+
+    RunResult gameRate[3];
+    RunResult unthrottled[3];
+    for (int i = 0; i < 3; i++)
+    {
+        gameRate[i] = Run(enemyCounts[i], 100, seconds);
+        unthrottled[i] = Run(enemyCounts[i], 0, seconds);
+    }
+
+    const int tickCounts[] = { 1000, 5000, 10000 };
+    TickCost tickCosts[3];
+    for (int i = 0; i < 3; i++)
+    {
+        tickCosts[i] = MeasureTick(tickCounts[i]);
+    }
+
+    CC::SetHeadless(false);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "enemies | game rate (100 ms): ticks/s  CPU | unthrottled: ticks/s  CPU" << std::endl;
+
+    for (int i = 0; i < 3; i++)
+    {
+        std::cout << std::setw(7) << enemyCounts[i] << " | "
+            << std::setw(27) << gameRate[i].ticksPerSecond << std::setw(6) << gameRate[i].cpuPercent << "% | "
+            << std::setw(20) << unthrottled[i].ticksPerSecond << std::setw(6) << unthrottled[i].cpuPercent << "%" << std::endl;
+    }
+
+    std::cout << std::endl << "enemies | tick us: idle  all act" << std::endl;
+
+    for (int i = 0; i < 3; i++)
+    {
+        std::cout << std::setw(7) << tickCounts[i] << " | "
+            << std::setw(13) << tickCosts[i].idleUs << std::setw(9) << tickCosts[i].allActUs << std::endl;
+    }
+
+    return 0;
+}
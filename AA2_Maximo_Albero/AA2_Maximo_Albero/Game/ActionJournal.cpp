@@ -0,0 +1,540 @@
+#include "ActionJournal.h"
+#include "../Utils/GameStats.h"
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+static const size_t RECORD_HEADER_SIZE = 8; // u32 bodyLength, u32 crc
+static const size_t MAX_RECORD_BODY = 1 << 16;
+static const size_t FLUSH_BUFFER_SIZE = 64 * 1024; // Wakes the flush thread before the interval
+
+// CRC-32 (IEEE), detects records torn by a crash mid-write
+static uint32_t Crc32(const char* data, size_t size)
+{
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> values(256);
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            values[i] = crc;
+        }
+        return values;
+        }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ (uint8_t)data[i]) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Calls onRecord for every valid record of data, in order
+// Returns the length of the valid prefix, anything after it is a torn or corrupt tail
+static size_t ForEachRecord(const std::string& data,
+    std::function<void(ActionJournal::RecordType, uint64_t, ByteReader&, size_t, size_t)> onRecord)
+{
+    ByteReader reader(data.c_str(), data.size());
+
+    while (reader.GetRemaining() > 0)
+    {
+        size_t recordOffset = reader.GetOffset();
+        uint32_t bodyLength, crc;
+
+        if (!reader.ReadU32(bodyLength) || !reader.ReadU32(crc))
+            return recordOffset;
+
+        if (bodyLength < 9 || bodyLength > MAX_RECORD_BODY || reader.GetRemaining() < bodyLength)
+            return recordOffset;
+
+        if (Crc32(reader.GetCurrent(), bodyLength) != crc)
+            return recordOffset;
+
+        ByteReader body(reader.GetCurrent(), bodyLength);
+        uint8_t type;
+        uint64_t sequence;
+        body.ReadU8(type);
+        body.ReadU64(sequence);
+
+        onRecord((ActionJournal::RecordType)type, sequence, body, recordOffset, RECORD_HEADER_SIZE + bodyLength);
+        reader.Skip(bodyLength);
+    }
+
+    return data.size();
+}
+
+static bool ReadFile(const std::string& path, std::string& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    data = contents.str();
+    return true;
+}
+
+ActionJournal::~ActionJournal()
+{
+    Close();
+}
+
+bool ActionJournal::Open(bool discardExisting)
+{
+    _fileMutex.lock();
+
+    if (_open)
+    {
+        _fileMutex.unlock();
+        return true;
+    }
+
+    if (discardExisting)
+    {
+        _lastSequence = 0;
+        _file.open(_path, std::ios::binary | std::ios::trunc);
+    }
+    else
+    {
+        _file.open(_path, std::ios::binary | std::ios::app);
+    }
+
+    if (!_file.is_open())
+    {
+        std::cerr << "Error: No se pudo abrir el diario de acciones: " << _path << std::endl;
+        _fileMutex.unlock();
+        return false;
+    }
+
+    _buffer.clear();
+    _open = true;
+    _flushThread = new std::thread(&ActionJournal::FlushLoop, this);
+
+    _fileMutex.unlock();
+    return true;
+}
+
+void ActionJournal::Close()
+{
+    _journalMutex.lock();
+    if (!_open)
+    {
+        _journalMutex.unlock();
+        return;
+    }
+    _open = false;
+    _journalMutex.unlock();
+    _flushCondition.notify_all();
+
+    if (_flushThread != nullptr)
+    {
+        if (_flushThread->joinable())
+            _flushThread->join();
+
+        delete _flushThread;
+        _flushThread = nullptr;
+    }
+
+    _fileMutex.lock();
+    WriteBuffer();
+    _file.close();
+    _fileMutex.unlock();
+}
+
+// ===== RECORDS =====
+
+size_t ActionJournal::BeginRecord(ByteWriter& writer, RecordType type)
+{
+    size_t recordOffset = writer.GetSize();
+
+    writer.WriteU32(0); // bodyLength, patched in EndRecord()
+    writer.WriteU32(0); // crc
+    writer.WriteU8(type);
+    writer.WriteU64(++_lastSequence);
+
+    return recordOffset;
+}
+
+void ActionJournal::EndRecord(size_t recordOffset)
+{
+    ByteWriter writer(_buffer);
+
+    size_t bodyOffset = recordOffset + RECORD_HEADER_SIZE;
+    size_t bodyLength = _buffer.size() - bodyOffset;
+
+    writer.PatchU32(recordOffset, (uint32_t)bodyLength);
+    writer.PatchU32(recordOffset + 4, Crc32(_buffer.c_str() + bodyOffset, bodyLength));
+
+    GameStats::Add(GameStats::JOURNAL_RECORDS);
+
+    if (_buffer.size() >= FLUSH_BUFFER_SIZE)
+        _flushCondition.notify_all();
+}
+
+void ActionJournal::RecordPlayer(const Player::Snapshot& player)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, PLAYER_STATE);
+    BinarySaveFormat::WritePlayer(writer, player);
+    EndRecord(record);
+}
+
+void ActionJournal::RecordRoomChange(int roomX, int roomY)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, ROOM_CHANGE);
+    writer.WriteI32(roomX);
+    writer.WriteI32(roomY);
+    EndRecord(record);
+}
+
+void ActionJournal::RecordEntity(Vector2 room, const Enemy::Snapshot& enemy)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, ENTITY_SET);
+    writer.WriteI32(room.X);
+    writer.WriteI32(room.Y);
+    BinarySaveFormat::WriteEntity(writer, enemy);
+    EndRecord(record);
+}
+
+void ActionJournal::RecordEntity(Vector2 room, const Chest::Snapshot& chest)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, ENTITY_SET);
+    writer.WriteI32(room.X);
+    writer.WriteI32(room.Y);
+    BinarySaveFormat::WriteEntity(writer, chest);
+    EndRecord(record);
+}
+
+void ActionJournal::RecordEntity(Vector2 room, const Item::Snapshot& item)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, ENTITY_SET);
+    writer.WriteI32(room.X);
+    writer.WriteI32(room.Y);
+    BinarySaveFormat::WriteEntity(writer, item);
+    EndRecord(record);
+}
+
+void ActionJournal::RecordMove(Vector2 room, BinarySaveFormat::TypeTag tag, Vector2 from, Vector2 to)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, ENTITY_MOVE);
+    writer.WriteI32(room.X);
+    writer.WriteI32(room.Y);
+    writer.WriteU8(tag);
+    writer.WriteI32(from.X);
+    writer.WriteI32(from.Y);
+    writer.WriteI32(to.X);
+    writer.WriteI32(to.Y);
+    EndRecord(record);
+}
+
+void ActionJournal::RecordRemove(Vector2 room, BinarySaveFormat::TypeTag tag, Vector2 position)
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    if (!_open)
+        return;
+
+    ByteWriter writer(_buffer);
+    size_t record = BeginRecord(writer, ENTITY_REMOVE);
+    writer.WriteI32(room.X);
+    writer.WriteI32(room.Y);
+    writer.WriteU8(tag);
+    writer.WriteI32(position.X);
+    writer.WriteI32(position.Y);
+    EndRecord(record);
+}
+
+uint64_t ActionJournal::GetLastSequence()
+{
+    std::lock_guard<std::mutex> lock(_journalMutex);
+    return _lastSequence;
+}
+
+// ===== DISK =====
+
+// Caller holds _fileMutex
+void ActionJournal::WriteBuffer()
+{
+    std::string pending;
+
+    _journalMutex.lock();
+    pending.swap(_buffer);
+    _journalMutex.unlock();
+
+    if (pending.empty() || !_file.is_open())
+        return;
+
+    _file.write(pending.c_str(), pending.size());
+    _file.flush();
+}
+
+void ActionJournal::Flush()
+{
+    _fileMutex.lock();
+    WriteBuffer();
+    _fileMutex.unlock();
+}
+
+// Group commit: every record buffered during the interval goes out in a single write
+// A crash loses at most the last flushIntervalMs of play
+void ActionJournal::FlushLoop()
+{
+    while (_open)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_journalMutex);
+            _flushCondition.wait_for(lock, std::chrono::milliseconds(_flushIntervalMs),
+                [this]() { return !_open || _buffer.size() >= FLUSH_BUFFER_SIZE; });
+        }
+
+        Flush();
+    }
+}
+
+// Rewrites the journal without the records covered by the checkpoint
+// Records appended meanwhile stay in _buffer and are written after the new file
+bool ActionJournal::Compact(uint64_t checkpointSequence)
+{
+    _fileMutex.lock();
+
+    if (!_open)
+    {
+        _fileMutex.unlock();
+        return false;
+    }
+
+    WriteBuffer();
+    _file.close();
+
+    std::string data, kept;
+    ReadFile(_path, data);
+
+    ForEachRecord(data, [&](RecordType, uint64_t sequence, ByteReader&, size_t offset, size_t length) {
+        if (sequence > checkpointSequence)
+            kept.append(data, offset, length);
+        });
+
+    bool compacted = SaveManager::WriteFileAtomically(_path, kept);
+
+    _file.open(_path, std::ios::binary | std::ios::app);
+    bool reopened = _file.is_open();
+
+    _fileMutex.unlock();
+
+    if (!reopened)
+        std::cerr << "Error: No se pudo reabrir el diario de acciones: " << _path << std::endl;
+
+    return compacted && reopened;
+}
+
+int ActionJournal::Replay(SaveManager::Snapshot& snapshot)
+{
+    std::string data;
+    if (!ReadFile(_path, data))
+        return 0;
+
+    int applied = 0;
+    uint64_t lastSequence = snapshot.journalSequence;
+
+    size_t validLength = ForEachRecord(data, [&](RecordType type, uint64_t sequence, ByteReader& payload, size_t, size_t) {
+        if (sequence > lastSequence)
+            lastSequence = sequence;
+
+        if (sequence > snapshot.journalSequence && ApplyRecord(type, payload, snapshot))
+            applied++;
+        });
+
+    // Cut the torn tail, otherwise the new records would be appended after it and never replayed
+    if (validLength < data.size())
+    {
+        std::cerr << "Diario de acciones: " << (data.size() - validLength) << " bytes corruptos descartados" << std::endl;
+        SaveManager::WriteFileAtomically(_path, data.substr(0, validLength));
+    }
+
+    // New records must stay newer than the checkpoint even if the journal was already compacted
+    _journalMutex.lock();
+    _lastSequence = lastSequence;
+    _journalMutex.unlock();
+
+    return applied;
+}
+
+// ===== REPLAY =====
+
+static Room::Snapshot* FindRoom(SaveManager::Snapshot& snapshot, int x, int y)
+{
+    if (x < 0 || x >= snapshot.worldWidth || y < 0 || y >= snapshot.worldHeight)
+        return nullptr;
+
+    for (SaveManager::Snapshot::RoomEntry& entry : snapshot.rooms)
+    {
+        if (entry.x == x && entry.y == y)
+        {
+            // Lazy loaded room, the record needs its entities
+            if (!BinarySaveFormat::DecodeRoomSegment(entry))
+                return nullptr;
+
+            return &entry.room;
+        }
+    }
+
+    // Room initialized after the checkpoint, its spawns are the next records
+    SaveManager::Snapshot::RoomEntry entry;
+    entry.x = x;
+    entry.y = y;
+    entry.revision = 0;
+    entry.room.initialized = true;
+    snapshot.rooms.push_back(entry);
+
+    return &snapshot.rooms.back().room;
+}
+
+template<typename T>
+static typename std::vector<T>::iterator FindAt(std::vector<T>& list, Vector2 position)
+{
+    return std::find_if(list.begin(), list.end(), [position](const T& entity) {
+        return entity.position.X == position.X && entity.position.Y == position.Y;
+        });
+}
+
+template<typename T>
+static void SetEntity(std::vector<T>& list, const T& entity)
+{
+    auto it = FindAt(list, entity.position);
+    if (it != list.end())
+        *it = entity;
+    else
+        list.push_back(entity);
+}
+
+template<typename T>
+static void MoveEntity(std::vector<T>& list, Vector2 from, Vector2 to)
+{
+    auto it = FindAt(list, from);
+    if (it != list.end() && FindAt(list, to) == list.end())
+        it->position = to;
+}
+
+template<typename T>
+static void RemoveEntity(std::vector<T>& list, Vector2 position)
+{
+    auto it = FindAt(list, position);
+    if (it != list.end())
+        list.erase(it);
+}
+
+bool ActionJournal::ApplyRecord(RecordType type, ByteReader& payload, SaveManager::Snapshot& snapshot)
+{
+    switch (type)
+    {
+    case PLAYER_STATE:
+        return BinarySaveFormat::ReadPlayer(payload, snapshot.player);
+
+    case ROOM_CHANGE:
+    {
+        int32_t roomX, roomY;
+        if (!payload.ReadI32(roomX) || !payload.ReadI32(roomY))
+            return false;
+
+        snapshot.currentX = roomX;
+        snapshot.currentY = roomY;
+        return true;
+    }
+
+    case ENTITY_SET:
+    {
+        int32_t roomX, roomY;
+        Room::Snapshot entity;
+        if (!payload.ReadI32(roomX) || !payload.ReadI32(roomY) || !BinarySaveFormat::ReadEntity(payload, entity))
+            return false;
+
+        Room::Snapshot* room = FindRoom(snapshot, roomX, roomY);
+        if (room == nullptr)
+            return false;
+
+        for (const Enemy::Snapshot& enemy : entity.enemies)
+            SetEntity(room->enemies, enemy);
+        for (const Chest::Snapshot& chest : entity.chests)
+            SetEntity(room->chests, chest);
+        for (const Item::Snapshot& item : entity.items)
+            SetEntity(room->items, item);
+        return true;
+    }
+
+    case ENTITY_MOVE:
+    case ENTITY_REMOVE:
+    {
+        int32_t roomX, roomY, posX, posY;
+        uint8_t tag;
+        if (!payload.ReadI32(roomX) || !payload.ReadI32(roomY) || !payload.ReadU8(tag) ||
+            !payload.ReadI32(posX) || !payload.ReadI32(posY))
+            return false;
+
+        Room::Snapshot* room = FindRoom(snapshot, roomX, roomY);
+        if (room == nullptr)
+            return false;
+
+        Vector2 position(posX, posY);
+
+        if (type == ENTITY_MOVE)
+        {
+            int32_t toX, toY;
+            if (!payload.ReadI32(toX) || !payload.ReadI32(toY))
+                return false;
+
+            Vector2 to(toX, toY);
+            switch (tag)
+            {
+            case BinarySaveFormat::TAG_ENEMY: MoveEntity(room->enemies, position, to); break;
+            case BinarySaveFormat::TAG_CHEST: MoveEntity(room->chests, position, to); break;
+            case BinarySaveFormat::TAG_ITEM:  MoveEntity(room->items, position, to); break;
+            default: return false;
+            }
+        }
+        else
+        {
+            switch (tag)
+            {
+            case BinarySaveFormat::TAG_ENEMY: RemoveEntity(room->enemies, position); break;
+            case BinarySaveFormat::TAG_CHEST: RemoveEntity(room->chests, position); break;
+            case BinarySaveFormat::TAG_ITEM:  RemoveEntity(room->items, position); break;
+            default: return false;
+            }
+        }
+        return true;
+    }
+
+    default:
+        return false; // Unknown record from a newer version, skipped
+    }
+}
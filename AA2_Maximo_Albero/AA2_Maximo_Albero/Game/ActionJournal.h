@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "SaveManager.h"
+#include "BinarySaveFormat.h"
+
+// Append-only log of the state changes made between two autosaves (checkpoints)
+// After a crash, LoadGame() replays the records newer than the checkpoint on top of it
+// Every record stores the resulting state (not the action), so replaying one twice is harmless
+//
+// Not write-ahead: a record is taken after its change is applied and written by the flush thread
+// (group commit), so a crash loses the changes of the last flushIntervalMs. The game already
+// showed them. What was written is still consistent, the replay stops at the last complete record
+// Record layout, little-endian:
+//   u32 bodyLength, u32 crc32(body)
+//   body: u8 type, u64 sequence, payload
+//     PLAYER_STATE:  player fields (BinarySaveFormat::WritePlayer)
+//     ROOM_CHANGE:   i32 roomX, roomY
+//     ENTITY_SET:    i32 roomX, roomY, tagged entity (BinarySaveFormat::WriteEntity), spawn or damage
+//     ENTITY_MOVE:   i32 roomX, roomY, u8 tag, i32 fromX, fromY, toX, toY
+//     ENTITY_REMOVE: i32 roomX, roomY, u8 tag, i32 posX, posY, death or pickup
+// A torn or corrupt record ends the replay, everything after it is discarded
+class ActionJournal
+{
+public:
+    enum RecordType : uint8_t
+    {
+        PLAYER_STATE = 1,
+        ROOM_CHANGE = 2,
+        ENTITY_SET = 3,
+        ENTITY_MOVE = 4,
+        ENTITY_REMOVE = 5
+    };
+
+    ActionJournal(const std::string& path, int flushIntervalMs = 100)
+        : _path(path),
+        _flushIntervalMs(flushIntervalMs),
+        _lastSequence(0),
+        _flushThread(nullptr),
+        _open(false) {
+    }
+
+    ~ActionJournal();
+
+    // Starts appending. discardExisting drops the records of a previous game
+    bool Open(bool discardExisting);
+    // Writes what is still buffered and stops the flush thread
+    void Close();
+
+    // Only copy into memory, the flush thread writes them every flushIntervalMs (the loss window)
+    void RecordPlayer(const Player::Snapshot& player);
+    void RecordRoomChange(int roomX, int roomY);
+    void RecordEntity(Vector2 room, const Enemy::Snapshot& enemy);
+    void RecordEntity(Vector2 room, const Chest::Snapshot& chest);
+    void RecordEntity(Vector2 room, const Item::Snapshot& item);
+    void RecordMove(Vector2 room, BinarySaveFormat::TypeTag tag, Vector2 from, Vector2 to);
+    void RecordRemove(Vector2 room, BinarySaveFormat::TypeTag tag, Vector2 position);
+
+    // Sequence of the last record, stored in the checkpoint (Snapshot::journalSequence)
+    uint64_t GetLastSequence();
+
+    void Flush();
+
+    // Drops the records already included in a checkpoint
+    bool Compact(uint64_t checkpointSequence);
+
+    // Applies the records newer than snapshot.journalSequence to snapshot
+    // Call before Open(false); new records continue the sequence of the file
+    // Returns the number of records applied
+    int Replay(SaveManager::Snapshot& snapshot);
+
+private:
+    std::string _path;
+    int _flushIntervalMs;
+
+    uint64_t _lastSequence;
+    std::string _buffer; // Records not yet written to the file
+
+    std::ofstream _file;
+    std::thread* _flushThread;
+    std::atomic<bool> _open;
+
+    std::mutex _journalMutex; // _buffer and _lastSequence
+    std::mutex _fileMutex; // _file, always taken before _journalMutex
+    std::condition_variable _flushCondition;
+
+    // Starts a record, returns the offset of its header to pass to EndRecord()
+    size_t BeginRecord(ByteWriter& writer, RecordType type);
+    void EndRecord(size_t recordOffset);
+
+    void WriteBuffer();
+    void FlushLoop();
+
+    static bool ApplyRecord(RecordType type, ByteReader& payload, SaveManager::Snapshot& snapshot);
+};
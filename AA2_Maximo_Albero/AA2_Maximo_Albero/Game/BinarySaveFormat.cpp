@@ -0,0 +1,293 @@
+#include "BinarySaveFormat.h"
+
+static const char MAGIC[4] = { 'A', 'A', '2', 'B' };
+
+bool BinarySaveFormat::IsBinary(const std::string& data)
+{
+    return data.size() >= sizeof(MAGIC) && data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// ===== WRITE =====
+
+void BinarySaveFormat::Write(const SaveManager::Snapshot& snapshot, std::ostream& output)
+{
+    std::string buffer;
+    WriteHeader(snapshot, (uint32_t)snapshot.rooms.size(), buffer);
+    output.write(buffer.c_str(), buffer.size());
+
+    for (const SaveManager::Snapshot::RoomEntry& entry : snapshot.rooms)
+    {
+        // The buffer keeps its capacity, after the first rooms there are no more allocations
+        buffer.clear();
+        WriteRoomSegment(entry, buffer);
+        output.write(buffer.c_str(), buffer.size());
+    }
+}
+
+void BinarySaveFormat::WriteHeader(const SaveManager::Snapshot& snapshot, uint32_t roomCount, std::string& output)
+{
+    ByteWriter writer(output);
+
+    writer.WriteBytes(MAGIC, sizeof(MAGIC));
+    writer.WriteU16(VERSION);
+    writer.WriteU64(snapshot.journalSequence);
+
+    writer.WriteI32(snapshot.currentX);
+    writer.WriteI32(snapshot.currentY);
+    writer.WriteI32(snapshot.worldWidth);
+    writer.WriteI32(snapshot.worldHeight);
+
+    WritePlayer(writer, snapshot.player);
+
+    writer.WriteU32(roomCount);
+}
+
+void BinarySaveFormat::WritePlayer(ByteWriter& writer, const Player::Snapshot& player)
+{
+    writer.WriteI32(player.position.X);
+    writer.WriteI32(player.position.Y);
+    writer.WriteI32(player.hp);
+    writer.WriteI32(player.maxHp);
+    writer.WriteI32(player.coins);
+    writer.WriteI32(player.potionCount);
+    writer.WriteI32(player.weapon);
+}
+
+void BinarySaveFormat::WriteRoomSegment(const SaveManager::Snapshot::RoomEntry& entry, std::string& output)
+{
+    if (entry.segment != nullptr)
+    {
+        output.append(entry.segment.GetData(), entry.segment.GetSize());
+        return;
+    }
+
+    ByteWriter writer(output);
+
+    // Length prefix, patched once the room body is written
+    size_t lengthOffset = writer.GetSize();
+    writer.WriteU32(0);
+
+    WriteRoom(writer, entry);
+
+    writer.PatchU32(lengthOffset, (uint32_t)(writer.GetSize() - lengthOffset - 4));
+}
+
+void BinarySaveFormat::WriteRoom(ByteWriter& writer, const SaveManager::Snapshot::RoomEntry& entry)
+{
+    const Room::Snapshot& room = entry.room;
+
+    writer.WriteI32(entry.x);
+    writer.WriteI32(entry.y);
+    writer.WriteU8(room.initialized ? 1 : 0);
+    writer.WriteU32((uint32_t)(room.enemies.size() + room.chests.size() + room.items.size()));
+
+    for (const Enemy::Snapshot& enemy : room.enemies)
+        WriteEntity(writer, enemy);
+
+    for (const Chest::Snapshot& chest : room.chests)
+        WriteEntity(writer, chest);
+
+    for (const Item::Snapshot& item : room.items)
+        WriteEntity(writer, item);
+}
+
+void BinarySaveFormat::WriteEntity(ByteWriter& writer, const Enemy::Snapshot& enemy)
+{
+    writer.WriteU8(TAG_ENEMY);
+    writer.WriteI32(enemy.position.X);
+    writer.WriteI32(enemy.position.Y);
+    writer.WriteI32(enemy.hp);
+    writer.WriteI32(enemy.damage);
+}
+
+void BinarySaveFormat::WriteEntity(ByteWriter& writer, const Chest::Snapshot& chest)
+{
+    writer.WriteU8(TAG_CHEST);
+    writer.WriteI32(chest.position.X);
+    writer.WriteI32(chest.position.Y);
+    writer.WriteI32(chest.hp);
+    writer.WriteU8(chest.broken ? 1 : 0);
+}
+
+void BinarySaveFormat::WriteEntity(ByteWriter& writer, const Item::Snapshot& item)
+{
+    writer.WriteU8(TAG_ITEM);
+    writer.WriteI32(item.position.X);
+    writer.WriteI32(item.position.Y);
+    writer.WriteU8((uint8_t)item.type);
+}
+
+// ===== READ =====
+
+bool BinarySaveFormat::Read(const std::shared_ptr<const std::string>& data, SaveManager::Snapshot& snapshot, bool lazyRooms)
+{
+    if (!IsBinary(*data))
+        return false;
+
+    ByteReader reader(data->c_str(), data->size());
+    reader.Skip(sizeof(MAGIC));
+
+    uint16_t version;
+    if (!reader.ReadU16(version) || version == 0 || version > VERSION)
+        return false;
+
+    // Version 1 saves predate the journal, every journal record is newer
+    snapshot.journalSequence = 0;
+    if (version >= 2 && !reader.ReadU64(snapshot.journalSequence))
+        return false;
+
+    int32_t currentX, currentY, worldWidth, worldHeight;
+    if (!reader.ReadI32(currentX) || !reader.ReadI32(currentY) ||
+        !reader.ReadI32(worldWidth) || !reader.ReadI32(worldHeight))
+        return false;
+
+    snapshot.currentX = currentX;
+    snapshot.currentY = currentY;
+    snapshot.worldWidth = worldWidth;
+    snapshot.worldHeight = worldHeight;
+
+    if (!ReadPlayer(reader, snapshot.player))
+        return false;
+
+    uint32_t roomCount;
+    if (!reader.ReadU32(roomCount))
+        return false;
+
+    snapshot.rooms.clear();
+    // Every room takes at least its u32 length, a corrupt count cannot reserve more than the file holds
+    snapshot.rooms.reserve(roomCount <= reader.GetRemaining() / 4 ? roomCount : 0);
+    for (uint32_t i = 0; i < roomCount; i++)
+    {
+        uint32_t roomLength;
+        if (!reader.ReadU32(roomLength) || reader.GetRemaining() < roomLength)
+            return false;
+
+        // Each room is read from its own bounded reader
+        ByteReader roomReader(reader.GetCurrent(), roomLength);
+        SaveManager::Snapshot::RoomEntry entry;
+        entry.revision = 0;
+
+        if (lazyRooms)
+        {
+            // Index only, the entities are decoded when the room is entered
+            int32_t x, y;
+            if (!roomReader.ReadI32(x) || !roomReader.ReadI32(y))
+                return false;
+
+            entry.x = x;
+            entry.y = y;
+            entry.room.initialized = true;
+            entry.segment = SaveSegment(data, reader.GetOffset() - 4, roomLength + 4);
+        }
+        else if (!ReadRoom(roomReader, entry))
+        {
+            return false;
+        }
+
+        snapshot.rooms.push_back(std::move(entry));
+        reader.Skip(roomLength);
+    }
+
+    return true;
+}
+
+bool BinarySaveFormat::DecodeRoomSegment(SaveManager::Snapshot::RoomEntry& entry)
+{
+    if (entry.segment == nullptr)
+        return true;
+
+    // Skip the length prefix, Read() already checked it
+    ByteReader reader(entry.segment.GetData() + 4, entry.segment.GetSize() - 4);
+
+    SaveManager::Snapshot::RoomEntry decoded;
+    if (!ReadRoom(reader, decoded))
+        return false;
+
+    entry.room = std::move(decoded.room);
+    entry.segment = nullptr;
+    return true;
+}
+
+bool BinarySaveFormat::ReadPlayer(ByteReader& reader, Player::Snapshot& player)
+{
+    int32_t fields[7];
+    for (int i = 0; i < 7; i++)
+    {
+        if (!reader.ReadI32(fields[i]))
+            return false;
+    }
+
+    player.position = Vector2(fields[0], fields[1]);
+    player.hp = fields[2];
+    player.maxHp = fields[3];
+    player.coins = fields[4];
+    player.potionCount = fields[5];
+    player.weapon = fields[6];
+    return true;
+}
+
+bool BinarySaveFormat::ReadRoom(ByteReader& reader, SaveManager::Snapshot::RoomEntry& entry)
+{
+    int32_t x, y;
+    uint8_t initialized;
+    uint32_t entityCount;
+
+    if (!reader.ReadI32(x) || !reader.ReadI32(y) ||
+        !reader.ReadU8(initialized) || !reader.ReadU32(entityCount))
+        return false;
+
+    entry.x = x;
+    entry.y = y;
+    entry.room.initialized = initialized != 0;
+
+    for (uint32_t i = 0; i < entityCount; i++)
+    {
+        if (!ReadEntity(reader, entry.room))
+            return false;
+    }
+
+    return true;
+}
+
+bool BinarySaveFormat::ReadEntity(ByteReader& reader, Room::Snapshot& room)
+{
+    uint8_t tag;
+    int32_t posX, posY;
+
+    if (!reader.ReadU8(tag) || !reader.ReadI32(posX) || !reader.ReadI32(posY))
+        return false;
+
+    switch (tag)
+    {
+    case TAG_ENEMY:
+    {
+        int32_t hp, damage;
+        if (!reader.ReadI32(hp) || !reader.ReadI32(damage))
+            return false;
+
+        room.enemies.push_back({ Vector2(posX, posY), hp, damage });
+        return true;
+    }
+    case TAG_CHEST:
+    {
+        int32_t hp;
+        uint8_t broken;
+        if (!reader.ReadI32(hp) || !reader.ReadU8(broken))
+            return false;
+
+        room.chests.push_back({ Vector2(posX, posY), hp, broken != 0 });
+        return true;
+    }
+    case TAG_ITEM:
+    {
+        uint8_t type;
+        if (!reader.ReadU8(type))
+            return false;
+
+        room.items.push_back({ Vector2(posX, posY), (ItemType)type });
+        return true;
+    }
+    default:
+        return false; // Unknown tag, the size of its fields is unknown
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <ostream>
+#include <memory>
+#include <cstdint>
+#include "SaveManager.h"
+#include "../Utils/ByteStream.h"
+
+// Compact save format, selected with SaveManager::SetSaveFormat(SaveFormat::BINARY)
+// All integers are little-endian:
+//   "AA2B", u16 version
+//   u64 journalSequence (version 2+, last ActionJournal record included in this save)
+//   i32 currentX, currentY, worldWidth, worldHeight
+//   player: i32 posX, posY, hp, maxHp, coins, potions, weapon
+//   u32 roomCount, then per room: u32 byteLength + room body
+//   room body: i32 x, y, u8 initialized, u32 entityCount, entities
+//   entity: u8 type tag + fields
+//     enemy: i32 posX, posY, hp, damage
+//     chest: i32 posX, posY, hp, u8 broken
+//     item:  i32 posX, posY, u8 type
+// The room length lets a reader skip rooms, and ignore fields added by newer versions
+class BinarySaveFormat
+{
+public:
+    static const uint16_t VERSION = 2;
+
+    // Replace the typeid(T).name() strings of the JSON format
+    enum TypeTag : uint8_t
+    {
+        TAG_ENEMY = 1,
+        TAG_CHEST = 2,
+        TAG_ITEM = 3
+    };
+
+    static bool IsBinary(const std::string& data);
+
+    // Rooms are encoded and written one at a time, the whole file is never in memory
+    static void Write(const SaveManager::Snapshot& snapshot, std::ostream& output);
+
+    // Write() in two parts, so the autosave can reuse the segments of the rooms that did not change
+    // A file is WriteHeader(roomCount) followed by roomCount segments
+    static void WriteHeader(const SaveManager::Snapshot& snapshot, uint32_t roomCount, std::string& output);
+    // A still encoded entry (lazy load) is copied as it is
+    static void WriteRoomSegment(const SaveManager::Snapshot::RoomEntry& entry, std::string& output);
+
+    // false if the data is truncated, corrupt or from a newer version
+    // With lazyRooms only x and y of each room are read, the rest stays in RoomEntry::segment,
+    // which points into data: the rooms keep the buffer alive instead of copying their bytes
+    static bool Read(const std::shared_ptr<const std::string>& data, SaveManager::Snapshot& snapshot, bool lazyRooms = false);
+
+    // Decodes entry.segment into entry.room and releases it, true if there was nothing to decode
+    static bool DecodeRoomSegment(SaveManager::Snapshot::RoomEntry& entry);
+
+    // Single player and entity codecs, shared with the ActionJournal records
+    static void WritePlayer(ByteWriter& writer, const Player::Snapshot& player);
+    static bool ReadPlayer(ByteReader& reader, Player::Snapshot& player);
+
+    static void WriteEntity(ByteWriter& writer, const Enemy::Snapshot& enemy);
+    static void WriteEntity(ByteWriter& writer, const Chest::Snapshot& chest);
+    static void WriteEntity(ByteWriter& writer, const Item::Snapshot& item);
+    // Reads a tagged entity and appends it to the matching list of room
+    static bool ReadEntity(ByteReader& reader, Room::Snapshot& room);
+
+private:
+    static void WriteRoom(ByteWriter& writer, const SaveManager::Snapshot::RoomEntry& entry);
+    static bool ReadRoom(ByteReader& reader, SaveManager::Snapshot::RoomEntry& entry);
+};
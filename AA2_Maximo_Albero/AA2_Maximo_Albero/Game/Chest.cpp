@@ -2,58 +2,139 @@
 
 void Chest::Draw(Vector2 pos)
 {
-    CC::Lock();
-    CC::SetColor(CC::YELLOW);
-    CC::SetPosition(pos.X, pos.Y);
-    std::cout << "C";
-    CC::SetColor(CC::WHITE);
-    CC::Unlock();
+    CC::DrawCell(pos.X, pos.Y, 'C', CC::YELLOW);
 }
 
 
+// Once the components are removed it reads as a broken chest at (0, 0)
 Vector2 Chest::GetPosition() {
-    Lock();
-    Vector2 pos = _position;
-    Unlock();
+    _store->Lock();
+    int i = _store->Find(_components);
+    Vector2 pos = i != SlotIndex::NOT_FOUND ? _store->PositionAt(i) : Vector2(0, 0);
+    _store->Unlock();
     return pos;
 }
 
 
-void Chest::ReceiveDamage(int damageToReceive) {
-    Lock();
-    _hp -= damageToReceive;
+bool Chest::ReceiveDamage(int damageToReceive) {
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i == SlotIndex::NOT_FOUND)
+    {
+        _store->Unlock();
+        return false;
+    }
 
-    if (_hp <= 0)
+    int& hp = _store->HealthAt(i);
+    hp -= damageToReceive;
+
+    if (hp <= 0)
     {
-        _hp = 0;
-        _broken = true;
+        hp = 0;
         //std::cout << "Cofre destruido!" << std::endl;
     }
 
-    Unlock();
+    _store->Unlock();
+    return true;
 }
 
 bool Chest::IsBroken() {
-    Lock();
-    bool isBroken = _broken;
-    Unlock();
+    _store->Lock();
+    int i = _store->Find(_components);
+    bool isBroken = i == SlotIndex::NOT_FOUND || _store->HealthAt(i) <= 0;
+    _store->Unlock();
     return isBroken;
 }
 
 
-Json::Value Chest::Code() {
+Chest::Snapshot Chest::GetSnapshot() {
+    _store->Lock();
+    int i = _store->Find(_components);
+    Snapshot snapshot = { Vector2(0, 0), 0, true };
+    if (i != SlotIndex::NOT_FOUND)
+        snapshot = { _store->PositionAt(i), _store->HealthAt(i), _store->HealthAt(i) <= 0 };
+    _store->Unlock();
+    return snapshot;
+}
+
+Json::Value Chest::CodeSnapshot(const Snapshot& snapshot) {
     Json::Value json;
     CodeSubClassType<Chest>(json);
-    json["posX"] = _position.X;
-    json["posY"] = _position.Y;
-    json["hp"] = _hp;
-    json["broken"] = _broken;
+    json["posX"] = snapshot.position.X;
+    json["posY"] = snapshot.position.Y;
+    json["hp"] = snapshot.hp;
+    json["broken"] = snapshot.broken;
     return json;
 }
 
-void Chest::Decode(Json::Value json) {
-    _position.X = json["posX"].asInt();
-    _position.Y = json["posY"].asInt();
-    _hp = json["hp"].asInt();
-    _broken = json["broken"].asBool();
+Json::Value Chest::Code() {
+    return CodeSnapshot(GetSnapshot());
+}
+
+Chest::Snapshot Chest::DecodeSnapshot(const Json::Value& json) {
+    Snapshot snapshot;
+    snapshot.position = Vector2(json["posX"].asInt(), json["posY"].asInt());
+    snapshot.hp = json["hp"].asInt();
+    snapshot.broken = json["broken"].asBool();
+    return snapshot;
+}
+
+void Chest::ApplySnapshot(const Snapshot& snapshot) {
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i != SlotIndex::NOT_FOUND)
+    {
+        _store->PositionAt(i) = snapshot.position;
+        _store->HealthAt(i) = snapshot.broken ? 0 : snapshot.hp;
+    }
+    _store->Unlock();
+}
+
+void Chest::Decode(const Json::Value& json) {
+    ApplySnapshot(DecodeSnapshot(json));
+}
+
+void Chest::EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer) {
+    writer.BeginObject();
+    CodeSubClassType<Chest>(writer);
+    writer.IntField("posX", snapshot.position.X);
+    writer.IntField("posY", snapshot.position.Y);
+    writer.IntField("hp", snapshot.hp);
+    writer.BoolField("broken", snapshot.broken);
+    writer.EndObject();
+}
+
+void Chest::Encode(CodableWriter& writer) {
+    EncodeSnapshot(GetSnapshot(), writer);
+}
+
+bool Chest::DecodeSnapshot(CodableReader& reader, Snapshot& snapshot) {
+    snapshot = Snapshot();
+
+    if (!reader.BeginObject())
+        return false;
+
+    std::string key;
+    while (reader.NextKey(key)) {
+        bool read;
+        if (key == "posX") read = reader.ReadInt(snapshot.position.X);
+        else if (key == "posY") read = reader.ReadInt(snapshot.position.Y);
+        else if (key == "hp") read = reader.ReadInt(snapshot.hp);
+        else if (key == "broken") read = reader.ReadBool(snapshot.broken);
+        else read = reader.Skip();
+
+        if (!read)
+            return false;
+    }
+
+    return !reader.Failed();
+}
+
+bool Chest::Decode(CodableReader& reader) {
+    Snapshot snapshot;
+    if (!DecodeSnapshot(reader, snapshot))
+        return false;
+
+    ApplySnapshot(snapshot);
+    return true;
 }
@@ -3,35 +3,53 @@
 #include "../Utils/ConsoleControl.h"
 #include "../NodeMap/Vector2.h"
 #include "../Utils/IDamageable.h"
-#include <mutex>
-#include <thread>
+#include "EntityStore.h"
 
 #include "../Json/ICodable.h"
 
+// View of a chest, position and hp live in the EntityStore of the room
+// It is broken once its hp reaches 0
 class Chest : public INodeContent, public IDamageable, public ICodable {
 private:
-    Vector2 _position;
-    int _hp;
-
-    std::mutex _chestMutex;
-    bool _broken; //necesita empezar como "= false"
+    EntityStore* _store;
+    EntityHandle _components;
 
 public:
-    Chest() : Chest(Vector2(0, 0)) {}
+    static constexpr uint8_t CODABLE_TYPE_ID = ICodable::CODABLE_CHEST;
+    static constexpr const char* CODABLE_TYPE_NAME = "Chest";
+
+    // Copia de los datos que se guardan, se toma con el lock del store
+    struct Snapshot
+    {
+        Vector2 position;
+        int hp;
+        bool broken;
+    };
+
+    Chest() : Chest(&EntityStore::GetDetached()) {}
 
-    Chest(Vector2 position, int hp = 20)
-        : _position(position), _hp(hp), _broken(false) {}
+    Chest(EntityStore* store, Vector2 position = Vector2(0, 0), int hp = 20)
+        : _store(store)
+    {
+        _components = _store->Add(EntityKind::CHEST, this, position, hp, 0);
+    }
 
-    ~Chest() {}
+    ~Chest() { _store->Remove(_components); }
 
     void Draw(Vector2 pos) override;
     Vector2 GetPosition();
-    void ReceiveDamage(int damageToReceive) override;
+    bool ReceiveDamage(int damageToReceive) override;
     bool IsBroken();
 
-    void Lock() { _chestMutex.lock(); }
-    void Unlock() { _chestMutex.unlock(); }
+    Snapshot GetSnapshot();
+    static Json::Value CodeSnapshot(const Snapshot& snapshot);
+    static Snapshot DecodeSnapshot(const Json::Value& json);
+    static void EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer);
+    static bool DecodeSnapshot(CodableReader& reader, Snapshot& snapshot);
+    void ApplySnapshot(const Snapshot& snapshot);
 
     Json::Value Code() override;
-    void Decode(Json::Value json) override;
+    void Decode(const Json::Value& json) override;
+    void Encode(CodableWriter& writer) override;
+    bool Decode(CodableReader& reader) override;
 };
\ No newline at end of file
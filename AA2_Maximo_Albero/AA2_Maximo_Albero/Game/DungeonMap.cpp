@@ -5,6 +5,9 @@ void DungeonMap::SetRoom(int x, int y, Room* room)
     if (x >= 0 && x < _worldWidth && y >= 0 && y < _worldHeight)
     {
         _rooms[y][x] = room;
+
+        if (room != nullptr)
+            room->SetWorldPosition(Vector2(x, y));
     }
 }
 
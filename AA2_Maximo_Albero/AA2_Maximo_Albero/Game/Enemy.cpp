@@ -1,237 +1,209 @@
 #include "Enemy.h"
+#include "SimulationScheduler.h"
+#include "../Utils/GameConstants.h"
 
 void Enemy::Draw(Vector2 pos)
 {
-    CC::Lock();
-    CC::SetColor(CC::DARKRED);
-    CC::SetPosition(pos.X, pos.Y);
-    std::cout << "E";
-    CC::SetColor(CC::WHITE);
-    CC::Unlock();
+    CC::DrawCell(pos.X, pos.Y, 'E', CC::DARKRED);
 }
 
-Vector2 Enemy::GetPosition() {
-    _enemyMutex.lock();
-    Vector2 pos = _position;
-    _enemyMutex.unlock();
-    return pos;
+Enemy::Enemy(EntityStore* store, Vector2 startPosition, int hp, int damage)
+    : _store(store), _scheduler(nullptr)
+{
+    _components = _store->Add(EntityKind::ENEMY, this, startPosition, hp, damage);
+
+    // Like a fresh enemy always did, it waits one cooldown before its first action
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i != SlotIndex::NOT_FOUND)
+        _store->CooldownAt(i) = std::chrono::steady_clock::now() + std::chrono::milliseconds(ENEMY_ACTION_COOLDOWN_MS);
+    _store->Unlock();
 }
 
-void Enemy::SetPosition(Vector2 newPos) {
-    _enemyMutex.lock();
-    _position = newPos;
-    _enemyMutex.unlock();
+Enemy::~Enemy()
+{
+    StopMovement();
+    _store->Remove(_components);
 }
 
-bool Enemy::CanPerformAction()
-{
-    _enemyMutex.lock();
-    auto currentTime = std::chrono::steady_clock::now();
-    auto timeSinceLastAction = std::chrono::duration_cast<std::chrono::milliseconds>(
-        currentTime - _lastActionTime
-    ).count();
-    bool canAct = timeSinceLastAction >= _actionCooldownMs;
-    _enemyMutex.unlock();
-    return canAct;
+Vector2 Enemy::GetPosition() {
+    _store->Lock();
+    int i = _store->Find(_components);
+    Vector2 pos = i != SlotIndex::NOT_FOUND ? _store->PositionAt(i) : Vector2(0, 0);
+    _store->Unlock();
+    return pos;
 }
 
-void Enemy::UpdateActionTime()
-{
-    _enemyMutex.lock();
-    _lastActionTime = std::chrono::steady_clock::now();
-    _enemyMutex.unlock();
+bool Enemy::SetPosition(Vector2 newPos) {
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i != SlotIndex::NOT_FOUND)
+        _store->PositionAt(i) = newPos;
+    _store->Unlock();
+    return i != SlotIndex::NOT_FOUND;
 }
 
 void Enemy::Attack(IDamageable* entity) const {
-    if (entity != nullptr)
+    if (entity == nullptr)
+        return;
+
+    _store->Lock();
+    int i = _store->Find(_components);
+    int damage = i != SlotIndex::NOT_FOUND ? _store->DamageAt(i) : 0;
+    _store->Unlock();
+
+    // A removed enemy does not attack
+    if (i != SlotIndex::NOT_FOUND)
+        entity->ReceiveDamage(damage);
+}
+
+bool Enemy::ReceiveDamage(int damageToReceive) {
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i == SlotIndex::NOT_FOUND)
     {
-        entity->ReceiveDamage(_damage);
+        _store->Unlock();
+        return false;
     }
-}
 
-void Enemy::ReceiveDamage(int damageToReceive) {
-    _enemyMutex.lock();
-    _hp -= damageToReceive;
+    int& hp = _store->HealthAt(i);
+    hp -= damageToReceive;
 
-    if (_hp <= 0)
+    if (hp <= 0)
     {
-        _hp = 0;
+        hp = 0;
     }
 
-    _enemyMutex.unlock();
+    _store->Unlock();
+    return true;
 }
 
 bool Enemy::IsAlive() {
-    _enemyMutex.lock();
-    bool alive = _hp > 0;
-    _enemyMutex.unlock();
-    return alive;
+    return GetHP() > 0;
 }
 
 int Enemy::GetHP() {
-    _enemyMutex.lock();
-    int hp = _hp;
-    _enemyMutex.unlock();
+    _store->Lock();
+    int i = _store->Find(_components);
+    int hp = i != SlotIndex::NOT_FOUND ? _store->HealthAt(i) : 0;
+    _store->Unlock();
     return hp;
 }
 
-Vector2 Enemy::GetRandomDirection()
+// Registers the enemy in the simulation scheduler
+// From then on the scheduler moves it and makes it attack every tick
+void Enemy::StartMovement(SimulationScheduler* scheduler)
 {
-    int direction = rand() % 4;
+    if (scheduler == nullptr)
+        return;
 
-    switch (direction)
-    {
-    case 0: return Vector2(0, -1);  // Arriba
-    case 1: return Vector2(0, 1);   // Abajo
-    case 2: return Vector2(-1, 0);  // Izquierda
-    case 3: return Vector2(1, 0);   // Derecha
-    default: return Vector2(0, 0);
-    }
+    SimulationScheduler* expected = nullptr;
+    if (!_scheduler.compare_exchange_strong(expected, scheduler))
+        return;
+
+    scheduler->Register(this);
 }
 
-// Starts the enemy's individual movement thread
-// Each enemy manages its own movement autonomously
-void Enemy::StartMovement()
+// Unregisters the enemy from the simulation scheduler
+// When it returns the scheduler is no longer updating this enemy
+void Enemy::StopMovement()
 {
-    _enemyMutex.lock();
+    SimulationScheduler* scheduler = _scheduler.exchange(nullptr);
 
-    if (_isActive)
-    {
-        _enemyMutex.unlock();
-        return;
-    }
-
-    _shouldStop = false;
-    _isActive = true;
-    _enemyMutex.unlock();
+    if (scheduler != nullptr)
+        scheduler->Unregister(this);
+}
 
-    // Create thread that MovementLoop() executes
-    _movementThread = new std::thread(&Enemy::MovementLoop, this);
+Enemy::Snapshot Enemy::GetSnapshot() {
+    _store->Lock();
+    int i = _store->Find(_components);
+    Snapshot snapshot = { Vector2(0, 0), 0, 0 };
+    if (i != SlotIndex::NOT_FOUND)
+        snapshot = { _store->PositionAt(i), _store->HealthAt(i), _store->DamageAt(i) };
+    _store->Unlock();
+    return snapshot;
 }
 
-// Stops the enemy's movement thread
-void Enemy::StopMovement()
-{
-    _enemyMutex.lock();
+Json::Value Enemy::CodeSnapshot(const Snapshot& snapshot) {
+    Json::Value json;
+    CodeSubClassType<Enemy>(json);
+    json["posX"] = snapshot.position.X;
+    json["posY"] = snapshot.position.Y;
+    json["hp"] = snapshot.hp;
+    json["damage"] = snapshot.damage;
+    return json;
+}
 
-    if (!_isActive)
-    {
-        _enemyMutex.unlock();
-        return;
-    }
+Json::Value Enemy::Code() {
+    return CodeSnapshot(GetSnapshot());
+}
 
-    _shouldStop = true;
-    _enemyMutex.unlock();
+Enemy::Snapshot Enemy::DecodeSnapshot(const Json::Value& json) {
+    Snapshot snapshot;
+    snapshot.position = Vector2(json["posX"].asInt(), json["posY"].asInt());
+    snapshot.hp = json["hp"].asInt();
+    snapshot.damage = json["damage"].asInt();
+    return snapshot;
+}
 
-    if (_movementThread != nullptr)
+void Enemy::ApplySnapshot(const Snapshot& snapshot) {
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i != SlotIndex::NOT_FOUND)
     {
-        if (_movementThread->joinable())
-            _movementThread->join();
-
-        delete _movementThread;
-        _movementThread = nullptr;
+        _store->PositionAt(i) = snapshot.position;
+        _store->HealthAt(i) = snapshot.hp;
+        _store->DamageAt(i) = snapshot.damage;
+        _store->CooldownAt(i) = std::chrono::steady_clock::now() + std::chrono::milliseconds(ENEMY_ACTION_COOLDOWN_MS);
     }
-
-    _enemyMutex.lock();
-    _isActive = false;
-    _enemyMutex.unlock();
+    _store->Unlock();
 }
 
-// Sets the callbacks so the enemy can query the world
-void Enemy::SetMovementCallbacks(
-    std::function<bool(Enemy*, Vector2)> canMoveCallback,
-    std::function<Vector2()> getPlayerPosCallback,
-    std::function<void(Enemy*)> onAttackPlayerCallback)
-{
-    _enemyMutex.lock();
-    _canMoveToCallback = canMoveCallback;
-    _getPlayerPositionCallback = getPlayerPosCallback;
-    _onAttackPlayerCallback = onAttackPlayerCallback;
-    _enemyMutex.unlock();
+void Enemy::Decode(const Json::Value& json) {
+    ApplySnapshot(DecodeSnapshot(json));
 }
 
-Json::Value Enemy::Code() {
-    Json::Value json;
-    CodeSubClassType<Enemy>(json);
-    json["posX"] = _position.X;
-    json["posY"] = _position.Y;
-    json["hp"] = _hp;
-    json["damage"] = _damage;
-    return json;
+void Enemy::EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer) {
+    writer.BeginObject();
+    CodeSubClassType<Enemy>(writer);
+    writer.IntField("posX", snapshot.position.X);
+    writer.IntField("posY", snapshot.position.Y);
+    writer.IntField("hp", snapshot.hp);
+    writer.IntField("damage", snapshot.damage);
+    writer.EndObject();
 }
 
-void Enemy::Decode(Json::Value json) {
-    _position.X = json["posX"].asInt();
-    _position.Y = json["posY"].asInt();
-    _hp = json["hp"].asInt();
-    _damage = json["damage"].asInt();
-    _lastActionTime = std::chrono::steady_clock::now();
+void Enemy::Encode(CodableWriter& writer) {
+    EncodeSnapshot(GetSnapshot(), writer);
 }
 
-// Enemy individual thread loop
-// Each enemy manages its own movement and attack
-void Enemy::MovementLoop()
-{
-    while (true)
-    {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        _enemyMutex.lock();
-        bool shouldStop = _shouldStop;
-        _enemyMutex.unlock();
-
-        if (shouldStop)
-            break;
-
-        // Verify if enemy is alive
-        if (!IsAlive())
-            continue;
-
-        // Verify cooldown
-        if (!CanPerformAction())
-            continue;
-
-        // Verify that the callbacks are configured
-        _enemyMutex.lock();
-        auto canMove = _canMoveToCallback;
-        auto getPlayerPos = _getPlayerPositionCallback;
-        auto onAttackPlayer = _onAttackPlayerCallback;
-        _enemyMutex.unlock();
-
-        if (!canMove || !getPlayerPos || !onAttackPlayer)
-            continue;
-
-        // Get player position
-        Vector2 playerPos = getPlayerPos();
-
-        // Verify that the player exists (no est en -1000, -1000)
-        if (playerPos.X == -1000 && playerPos.Y == -1000)
-            continue;
-
-        Vector2 currentPos = GetPosition();
-
-        // Check if the enemy is adjacent to the player to attack
-        int distX = abs(currentPos.X - playerPos.X);
-        int distY = abs(currentPos.Y - playerPos.Y);
-        bool isAdjacent = (distX + distY) == 1;
-
-        if (isAdjacent)
-        {
-            // attack the player
-            onAttackPlayer(this);
-            UpdateActionTime();
-            continue;
-        }
-
-        // Attempt to move
-        Vector2 direction = GetRandomDirection();
-        Vector2 newPos = currentPos + direction;
-
-        // Ask if the enemy can move to the next position
-        if (canMove(this, newPos))
-        {
-            SetPosition(newPos);
-            UpdateActionTime();
-        }
+bool Enemy::DecodeSnapshot(CodableReader& reader, Snapshot& snapshot) {
+    snapshot = Snapshot();
+
+    if (!reader.BeginObject())
+        return false;
+
+    std::string key;
+    while (reader.NextKey(key)) {
+        bool read;
+        if (key == "posX") read = reader.ReadInt(snapshot.position.X);
+        else if (key == "posY") read = reader.ReadInt(snapshot.position.Y);
+        else if (key == "hp") read = reader.ReadInt(snapshot.hp);
+        else if (key == "damage") read = reader.ReadInt(snapshot.damage);
+        else read = reader.Skip();
+
+        if (!read)
+            return false;
     }
-}
\ No newline at end of file
+
+    return !reader.Failed();
+}
+
+bool Enemy::Decode(CodableReader& reader) {
+    Snapshot snapshot;
+    if (!DecodeSnapshot(reader, snapshot))
+        return false;
+
+    ApplySnapshot(snapshot);
+    return true;
+}
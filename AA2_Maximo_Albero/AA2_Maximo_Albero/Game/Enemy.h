@@ -4,83 +4,73 @@
 #include "../NodeMap/Vector2.h"
 #include "../Utils/IAttacker.h"
 #include "../Utils/IDamageable.h"
-#include <chrono>
-#include <mutex>
-#include <thread>
+#include "EntityStore.h"
 #include <atomic>
-#include <functional>
-#include <random>
 
 #include "../Json/ICodable.h"
 
+// Forward declarations
+class SimulationScheduler;
+
+// View of an enemy: its state lives in the EntityStore of the room (position, hp, damage, cooldown)
+// Movement and attacks are decided by the SimulationScheduler, which walks the store
 class Enemy : public INodeContent, public IAttacker, public IDamageable, public ICodable
 {
 private:
-    Vector2 _position;
-    int _hp;
-    int _damage;
-    std::chrono::steady_clock::time_point _lastActionTime;
-    int _actionCooldownMs = 1000; // Milisegundos entre acciones
-    std::mutex _enemyMutex;
-
-    // Thread de movimiento individual
-    std::thread* _movementThread;
-    std::atomic<bool> _isActive;
-    std::atomic<bool> _shouldStop;
-
-    // Callbacks para consultar al mundo (EntityManager/Game)
-    std::function<bool(Enemy*, Vector2)> _canMoveToCallback;
-    std::function<Vector2()> _getPlayerPositionCallback;
-    std::function<void(Enemy*)> _onAttackPlayerCallback;
+    EntityStore* _store;
+    EntityHandle _components;
+
+    // Scheduler that simulates the enemy, nullptr while inactive
+    std::atomic<SimulationScheduler*> _scheduler;
 
 public:
-    Enemy() : Enemy(Vector2(0, 0)) {}
+    static constexpr uint8_t CODABLE_TYPE_ID = ICodable::CODABLE_ENEMY;
+    static constexpr const char* CODABLE_TYPE_NAME = "Enemy";
 
-    Enemy(Vector2 startPosition, int hp = 30, int damage = 10)
-        : _position(startPosition), _hp(hp), _damage(damage),
-        _movementThread(nullptr), _isActive(false), _shouldStop(false)
+    // Copia de los datos que se guardan, se toma con el lock del store
+    struct Snapshot
     {
-        _lastActionTime = std::chrono::steady_clock::now();
-    }
+        Vector2 position;
+        int hp;
+        int damage;
+    };
 
-    ~Enemy()
-    {
-        StopMovement();
-    }
+    Enemy() : Enemy(&EntityStore::GetDetached()) {}
+
+    Enemy(EntityStore* store, Vector2 startPosition = Vector2(0, 0), int hp = 30, int damage = 10);
+
+    ~Enemy();
 
     void Draw(Vector2 pos) override;
 
-    Vector2 GetPosition();
-    void SetPosition(Vector2 newPos);
+    EntityStore* GetStore() const { return _store; }
+    EntityHandle GetComponents() const { return _components; }
 
-    bool CanPerformAction();
-    void UpdateActionTime();
+    // The accessors check the handle: once the components are removed they read as a dead
+    // enemy at (0, 0) and the writes return false
+    Vector2 GetPosition();
+    bool SetPosition(Vector2 newPos);
 
     void Attack(IDamageable* entity) const;
-    void ReceiveDamage(int damageToReceive);
+    bool ReceiveDamage(int damageToReceive);
 
     bool IsAlive();
     int GetHP();
 
-    Vector2 GetRandomDirection();
-
-    // Individual enemy movement thread
-    void StartMovement();
+    // Register/unregister in the simulation scheduler
+    void StartMovement(SimulationScheduler* scheduler);
     void StopMovement();
-    bool IsActive() const { return _isActive; }
-
-    // Callbacks to query the world (EntityManager/Game)
-    void SetMovementCallbacks(
-        std::function<bool(Enemy*, Vector2)> canMoveCallback,
-        std::function<Vector2()> getPlayerPosCallback,
-        std::function<void(Enemy*)> onAttackPlayerCallback);
+    bool IsActive() const { return _scheduler != nullptr; }
 
-    void Lock() { _enemyMutex.lock(); }
-    void Unlock() { _enemyMutex.unlock(); }
+    Snapshot GetSnapshot();
+    static Json::Value CodeSnapshot(const Snapshot& snapshot);
+    static Snapshot DecodeSnapshot(const Json::Value& json);
+    static void EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer);
+    static bool DecodeSnapshot(CodableReader& reader, Snapshot& snapshot);
+    void ApplySnapshot(const Snapshot& snapshot);
 
     Json::Value Code();
-    void Decode(Json::Value json);
-
-private:
-    void MovementLoop();
+    void Decode(const Json::Value& json);
+    void Encode(CodableWriter& writer);
+    bool Decode(CodableReader& reader);
 };
\ No newline at end of file
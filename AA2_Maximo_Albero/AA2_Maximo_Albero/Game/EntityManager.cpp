@@ -1,4 +1,6 @@
 #include "EntityManager.h"
+#include "ActionJournal.h"
+#include "../Utils/GameStats.h"
 
 void EntityManager::SetCurrentRoom(Room* room)
 {
@@ -42,23 +44,19 @@ void EntityManager::SpawnEnemy(Vector2 position, Room* room)
     if (room == nullptr)
         return;
 
-    Enemy* enemy = new Enemy(position);
+    Enemy* enemy = room->CreateEntity<Enemy>(position);
 
     Lock();
-    _enemies.push_back(enemy);
+    room->AddEnemy(enemy);
     Unlock();
 
-    room->AddEnemy(enemy);
     PlaceEntityOnMap(enemy, position, room);
+    GameStats::Add(GameStats::SPAWNS);
 
-    // Configure callbacks before starting the thread
-    enemy->SetMovementCallbacks(
-        [this](Enemy* e, Vector2 newPos) { return this->CanEnemyMoveTo(e, newPos); },
-        _getPlayerPositionCallback,
-        _onEnemyAttackPlayer
-    );
+    if (_journal != nullptr)
+        _journal->RecordEntity(room->GetWorldPosition(), enemy->GetSnapshot());
 
-    enemy->StartMovement();
+    enemy->StartMovement(_scheduler);
 }
 
 void EntityManager::SpawnChest(Vector2 position, Room* room)
@@ -66,14 +64,17 @@ void EntityManager::SpawnChest(Vector2 position, Room* room)
     if (room == nullptr)
         return;
 
-    Chest* chest = new Chest(position);
+    Chest* chest = room->CreateEntity<Chest>(position);
 
     Lock();
-    _chests.push_back(chest);
+    room->AddChest(chest);
     Unlock();
 
-    room->AddChest(chest);
     PlaceEntityOnMap(chest, position, room);
+    GameStats::Add(GameStats::SPAWNS);
+
+    if (_journal != nullptr)
+        _journal->RecordEntity(room->GetWorldPosition(), chest->GetSnapshot());
 }
 
 void EntityManager::SpawnItem(Vector2 position, ItemType type, Room* room)
@@ -81,14 +82,17 @@ void EntityManager::SpawnItem(Vector2 position, ItemType type, Room* room)
     if (room == nullptr)
         return;
 
-    Item* item = new Item(position, type);
+    Item* item = room->CreateEntity<Item>(position, type);
 
     Lock();
-    _items.push_back(item);
+    room->AddItem(item);
     Unlock();
 
-    room->AddItem(item);
     PlaceEntityOnMap(item, position, room);
+    GameStats::Add(GameStats::SPAWNS);
+
+    if (_journal != nullptr)
+        _journal->RecordEntity(room->GetWorldPosition(), item->GetSnapshot());
 }
 
 // ===== ENTITY CLEANUP =====
@@ -98,39 +102,41 @@ void EntityManager::CleanupDeadEnemies(Room* room)
     if (room == nullptr)
         return;
 
-    std::vector<Enemy*>& enemies = room->GetEnemies();
+    SlotMap<Enemy>& enemies = room->GetEnemies();
 
-    for (auto it = enemies.begin(); it != enemies.end();)
+    while (true)
     {
-        Enemy* enemy = *it;
-        if (!enemy->IsAlive())
+        // Removed through its handle first: the enemy callbacks stop resolving it
+        // and the pointer the slot map hands back is only ours
+        Lock();
+        Enemy* enemy = nullptr;
+        for (size_t i = 0; i < enemies.Size(); i++)
         {
-            enemy->StopMovement();
-            Vector2 enemyPos = enemy->GetPosition();
-
-            // Clear from map
-            ClearPositionOnMap(enemyPos, room);
-            RedrawPosition(enemyPos, room);
-
-            // Remove from global list
-            Lock();
-            auto globalIt = std::find(_enemies.begin(), _enemies.end(), enemy);
-            if (globalIt != _enemies.end())
+            if (!enemies[i]->IsAlive())
             {
-                _enemies.erase(globalIt);
+                enemy = room->RemoveEnemy(enemies.GetHandleAt(i));
+                break;
             }
-            Unlock();
-
-            // Drop loot and delete
-            ItemType loot = SelectLoot();
-            delete enemy;
-            it = enemies.erase(it);
-            DropLoot(enemyPos, loot, room);
-        }
-        else
-        {
-            ++it;
         }
+        Vector2 enemyPos = enemy != nullptr ? enemy->GetPosition() : Vector2(0, 0);
+        Unlock();
+
+        if (enemy == nullptr)
+            break;
+
+        // Not with the lock held, the enemy may be waiting for it in CanEnemyMoveTo()
+        enemy->StopMovement();
+
+        // Clear from map
+        ClearPositionOnMap(enemyPos, room);
+        RedrawPosition(enemyPos, room);
+
+        // Drop loot and delete
+        ItemType loot = SelectLoot();
+        if (_journal != nullptr)
+            _journal->RecordRemove(room->GetWorldPosition(), BinarySaveFormat::TAG_ENEMY, enemyPos);
+        room->DestroyEntity(enemy);
+        DropLoot(enemyPos, loot, room);
     }
 }
 
@@ -139,56 +145,50 @@ void EntityManager::CleanupBrokenChests(Room* room)
     if (room == nullptr)
         return;
 
-    std::vector<Chest*>& chests = room->GetChests();
+    SlotMap<Chest>& chests = room->GetChests();
+
+    Lock();
 
-    for (auto it = chests.begin(); it != chests.end();)
+    // Swap and pop: after a removal index i holds another chest, so it is checked again
+    for (size_t i = 0; i < chests.Size();)
     {
-        Chest* chest = *it;
-        if (chest->IsBroken())
+        if (!chests[i]->IsBroken())
         {
-            Vector2 chestPos = chest->GetPosition();
+            i++;
+            continue;
+        }
+
+        // Only the chest the handle removed is destroyed
+        Chest* chest = room->RemoveChest(chests.GetHandleAt(i));
+        Vector2 chestPos = chest->GetPosition();
+        Unlock();
 
-            // Clear from map
-            ClearPositionOnMap(chestPos, room);
-            RedrawPosition(chestPos, room);
+        // Clear from map
+        ClearPositionOnMap(chestPos, room);
+        RedrawPosition(chestPos, room);
 
-            // Remove from global list
-            Lock();
-            auto globalIt = std::find(_chests.begin(), _chests.end(), chest);
-            if (globalIt != _chests.end())
-            {
-                _chests.erase(globalIt);
-            }
-            Unlock();
+        // Drop loot and delete
+        ItemType loot = SelectLoot();
+        if (_journal != nullptr)
+            _journal->RecordRemove(room->GetWorldPosition(), BinarySaveFormat::TAG_CHEST, chestPos);
+        room->DestroyEntity(chest);
+        DropLoot(chestPos, loot, room);
 
-            // Drop loot and delete
-            ItemType loot = SelectLoot();
-            delete chest;
-            it = chests.erase(it);
-            DropLoot(chestPos, loot, room);
-        }
-        else
-        {
-            ++it;
-        }
+        Lock();
     }
+
+    Unlock();
 }
 
 // ===== ENTITY GETTERS =====
 
-Enemy* EntityManager::GetEnemyAtPosition(Vector2 position, Room* room)
+Room* EntityManager::ResolveRoom(EntityStore* store)
 {
-    return GetEntityAtPosition<Enemy>(position, room);
-}
+    // A handle only means something in the slot map of the room that owns the store
+    if (_currentRoom == nullptr || _currentRoom->GetStore() != store)
+        return nullptr;
 
-Chest* EntityManager::GetChestAtPosition(Vector2 position, Room* room)
-{
-    return GetEntityAtPosition<Chest>(position, room);
-}
-
-Item* EntityManager::GetItemAtPosition(Vector2 position, Room* room)
-{
-    return GetEntityAtPosition<Item>(position, room);
+    return _currentRoom;
 }
 
 bool EntityManager::IsPositionOccupiedByEnemy(Vector2 position)
@@ -206,92 +206,20 @@ bool EntityManager::IsPositionOccupiedByItem(Vector2 position)
     return IsPositionOccupiedBy<Item>(position);
 }
 
-std::vector<Enemy*> EntityManager::GetEnemies()
-{
-    Lock();
-    std::vector<Enemy*> enemiesCopy = _enemies;
-    Unlock();
-    return enemiesCopy;
-}
-
-std::vector<Chest*> EntityManager::GetChests()
-{
-    Lock();
-    std::vector<Chest*> chestsCopy = _chests;
-    Unlock();
-    return chestsCopy;
-}
-
-std::vector<Item*> EntityManager::GetItems()
-{
-    Lock();
-    std::vector<Item*> itemsCopy = _items;
-    Unlock();
-    return itemsCopy;
-}
-
-void EntityManager::ClearAllEntities()
-{
-    Lock();
-
-    for (Enemy* enemy : _enemies)
-    {
-        enemy->StopMovement();
-        delete enemy;
-    }
-    _enemies.clear();
-
-    for (Chest* chest : _chests)
-    {
-        delete chest;
-    }
-    _chests.clear();
-
-    for (Item* item : _items)
-    {
-        delete item;
-    }
-    _items.clear();
-
-    Unlock();
-}
-
-int EntityManager::GetEnemyCount()
-{
-    Lock();
-    int count = _enemies.size();
-    Unlock();
-    return count;
-}
-
-int EntityManager::GetChestCount()
-{
-    Lock();
-    int count = _chests.size();
-    Unlock();
-    return count;
-}
-
 // ===== COMBAT SYSTEM =====
 
 bool EntityManager::TryAttackEnemyAt(Vector2 position, Player* attacker, Room* room)
 {
     Lock();
 
-    Enemy* enemy = nullptr;
-    for (Enemy* e : _enemies)
-    {
-        Vector2 enemyPos = e->GetPosition();
-        if (enemyPos.X == position.X && enemyPos.Y == position.Y)
-        {
-            enemy = e;
-            break;
-        }
-    }
+    Enemy* enemy = ResolveEntityAt<Enemy>(position, room);
 
     if (enemy != nullptr)
     {
         attacker->Attack(enemy);
+        room->MarkDirty();
+        if (_journal != nullptr)
+            _journal->RecordEntity(room->GetWorldPosition(), enemy->GetSnapshot());
         Unlock();
         CleanupDeadEnemies(room);
         return true;
@@ -305,20 +233,14 @@ bool EntityManager::TryAttackChestAt(Vector2 position, Player* attacker, Room* r
 {
     Lock();
 
-    Chest* chest = nullptr;
-    for (Chest* c : _chests)
-    {
-        Vector2 chestPos = c->GetPosition();
-        if (chestPos.X == position.X && chestPos.Y == position.Y)
-        {
-            chest = c;
-            break;
-        }
-    }
+    Chest* chest = ResolveEntityAt<Chest>(position, room);
 
     if (chest != nullptr)
     {
         attacker->Attack(chest);
+        room->MarkDirty();
+        if (_journal != nullptr)
+            _journal->RecordEntity(room->GetWorldPosition(), chest->GetSnapshot());
         Unlock();
         CleanupBrokenChests(room);
         return true;
@@ -328,6 +250,20 @@ bool EntityManager::TryAttackChestAt(Vector2 position, Player* attacker, Room* r
     return false;
 }
 
+bool EntityManager::EnemyAttack(EntityStore* store, EntityHandle enemy, IDamageable* target)
+{
+    Lock();
+
+    // Resolved and used with the lock held, the enemy cannot be removed meanwhile
+    Room* room = ResolveRoom(store);
+    Enemy* attacker = room != nullptr ? room->GetEnemies().Get(enemy) : nullptr;
+    if (attacker != nullptr)
+        attacker->Attack(target);
+
+    Unlock();
+    return attacker != nullptr;
+}
+
 // ===== LOOT SYSTEM =====
 
 ItemType EntityManager::SelectLoot()
@@ -355,38 +291,44 @@ void EntityManager::DropLoot(Vector2 position, ItemType lootItem, Room* room)
     SpawnItem(position, lootItem, room);
 }
 
-void EntityManager::RemoveItem(Item* itemToRemove, Room* room)
+bool EntityManager::TryPickupItemAt(Vector2 position, Room* room, ItemType& pickedType)
 {
-    if (room == nullptr || itemToRemove == nullptr)
-        return;
+    if (room == nullptr)
+        return false;
 
-    std::vector<Item*>& items = room->GetItems();
+    Lock();
+    EntityHandle handle = room->GetOccupancy()->Get<Item>(position);
+    Item* item = room->GetItems().Get(handle);
+    if (item != nullptr)
+        pickedType = item->GetType();
+    Unlock();
 
-    for (auto it = items.begin(); it != items.end(); ++it)
-    {
-        if (*it == itemToRemove)
-        {
-            Vector2 itemPos = itemToRemove->GetPosition();
+    // Someone else may remove it in between, then the handle is stale and nothing is picked up
+    return item != nullptr && RemoveItem(handle, room);
+}
+
+bool EntityManager::RemoveItem(EntityHandle item, Room* room)
+{
+    if (room == nullptr)
+        return false;
 
-            // Clear from map
-            ClearPositionOnMap(itemPos, room);
-            RedrawPosition(itemPos, room);
+    // The slot map hands the item over only once, from here on it is ours
+    Lock();
+    Item* removed = room->RemoveItem(item);
+    Vector2 itemPos = removed != nullptr ? removed->GetPosition() : Vector2(0, 0);
+    Unlock();
 
-            // Remove from global list
-            Lock();
-            auto globalIt = std::find(_items.begin(), _items.end(), itemToRemove);
-            if (globalIt != _items.end())
-            {
-                _items.erase(globalIt);
-            }
-            Unlock();
+    if (removed == nullptr)
+        return false;
 
-            // Remove from room list
-            delete itemToRemove;
-            items.erase(it);
-            break;
-        }
-    }
+    // Clear from map
+    ClearPositionOnMap(itemPos, room);
+    RedrawPosition(itemPos, room);
+
+    if (_journal != nullptr)
+        _journal->RecordRemove(room->GetWorldPosition(), BinarySaveFormat::TAG_ITEM, itemPos);
+    room->DestroyEntity(removed);
+    return true;
 }
 
 // ===== INITIALIZATION =====
@@ -421,187 +363,98 @@ void EntityManager::InitializeRoomEntities(Room* room, int roomX, int roomY)
     room->SetInitialized(true);
 }
 
-void EntityManager::RegisterLoadedEntities(Room* room)
-{
-    if (room == nullptr)
-        return;
-
-    Lock();
-
-    // Register enemies
-    for (Enemy* enemy : room->GetEnemies())
-    {
-        if (enemy != nullptr)
-        {
-            auto it = std::find(_enemies.begin(), _enemies.end(), enemy);
-            if (it == _enemies.end())
-            {
-                _enemies.push_back(enemy);
-            }
-        }
-    }
-
-    // Register chests
-    for (Chest* chest : room->GetChests())
-    {
-        if (chest != nullptr)
-        {
-            auto it = std::find(_chests.begin(), _chests.end(), chest);
-            if (it == _chests.end())
-            {
-                _chests.push_back(chest);
-            }
-        }
-    }
-
-    // Register items
-    for (Item* item : room->GetItems())
-    {
-        if (item != nullptr)
-        {
-            auto it = std::find(_items.begin(), _items.end(), item);
-            if (it == _items.end())
-            {
-                _items.push_back(item);
-            }
-        }
-    }
-
-    Unlock();
-}
-
 // ===== CALLBACK SETUP =====
 
+// The scheduler runs the enemy system, every enemy shares these callbacks
 void EntityManager::SetupEnemyCallbacks(std::function<Vector2()> getPlayerPositionCallback,
-    std::function<void(Enemy*)> onEnemyAttackPlayer)
+    std::function<void(EntityStore*, EntityHandle)> onEnemyAttackPlayer)
 {
     Lock();
     _getPlayerPositionCallback = getPlayerPositionCallback;
-    _onEnemyAttackPlayer = onEnemyAttackPlayer;
     Unlock();
-}
 
-// Configures callbacks for all active enemies in a room
-void EntityManager::ConfigureRoomEnemies(Room* room)
-{
-    if (room == nullptr)
-        return;
-
-    for (Enemy* enemy : room->GetEnemies())
-    {
-        if (enemy != nullptr)
-        {
-            enemy->SetMovementCallbacks(
-                [this](Enemy* e, Vector2 newPos) { return this->CanEnemyMoveTo(e, newPos); },
-                _getPlayerPositionCallback,
-                _onEnemyAttackPlayer
-            );
-        }
-    }
+    _scheduler->SetEnemyCallbacks(
+        [this](EntityStore* store, EntityHandle e, Vector2 newPos) { return this->CanEnemyMoveTo(store, e, newPos); },
+        getPlayerPositionCallback,
+        onEnemyAttackPlayer
+    );
 }
 
 // ===== MOVEMENT VALIDATION =====
 
 // Validates whether an enemy can move to a position
-// Called from the enemy's individual thread
-bool EntityManager::CanEnemyMoveTo(Enemy* movingEnemy, Vector2 newPosition)
+// Called from the simulation scheduler thread
+bool EntityManager::CanEnemyMoveTo(EntityStore* store, EntityHandle enemy, Vector2 newPosition)
 {
-    if (movingEnemy == nullptr)
-        return false;
-
     Lock();
-    Room* room = _currentRoom;
     auto getPlayerPos = _getPlayerPositionCallback;
     Unlock();
 
-    if (room == nullptr || !getPlayerPos)
+    // Before Lock(): it takes the game mutex, which goes first in the lock order
+    if (!getPlayerPos)
         return false;
 
-    Vector2 currentPosition = movingEnemy->GetPosition();
     Vector2 playerPosition = getPlayerPos();
 
-    // Check walls and portals
-    bool canMove = true;
-    room->GetMap()->SafePickNode(newPosition, [&](Node* node) {
-        if (node != nullptr)
-        {
-            Wall* wall = node->GetContent<Wall>();
-            if (wall != nullptr)
-            {
-                canMove = false;
-            }
-
-            Portal* portal = node->GetContent<Portal>();
-            if (portal != nullptr)
-            {
-                canMove = false;
-            }
-        }
-        });
-
-    if (!canMove)
-        return false;
-
     // Do not move onto the player's position
     if (newPosition.X == playerPosition.X && newPosition.Y == playerPosition.Y)
     {
         return false;
     }
 
+    // Everything else with the lock held: the enemy is resolved from its handle
+    // and cannot be removed until the move is on the map
     Lock();
 
-    // Check collision with other enemies
-    for (Enemy* enemy : _enemies)
+    Room* room = ResolveRoom(store);
+    Enemy* movingEnemy = room != nullptr ? room->GetEnemies().Get(enemy) : nullptr;
+    if (movingEnemy == nullptr)
     {
-        if (enemy == movingEnemy)
-            continue;
-
-        Vector2 enemyPos = enemy->GetPosition();
-        if (enemyPos.X == newPosition.X && enemyPos.Y == newPosition.Y)
-        {
-            canMove = false;
-            break;
-        }
+        Unlock();
+        return false;
     }
 
-    // Check collision with chests
-    if (canMove)
-    {
-        for (Chest* chest : _chests)
+    Vector2 currentPosition = movingEnemy->GetPosition();
+
+    // Check walls and portals
+    bool canMove = true;
+    room->GetMap()->SafePickNode(newPosition, [&](Node* node) {
+        if (node != nullptr)
         {
-            Vector2 chestPos = chest->GetPosition();
-            if (chestPos.X == newPosition.X && chestPos.Y == newPosition.Y)
+            Wall* wall = node->GetContent<Wall>();
+            if (wall != nullptr)
             {
                 canMove = false;
-                break;
             }
-        }
-    }
 
-    // Check collision with items
-    if (canMove)
-    {
-        for (Item* item : _items)
-        {
-            Vector2 itemPos = item->GetPosition();
-            if (itemPos.X == newPosition.X && itemPos.Y == newPosition.Y)
+            Portal* portal = node->GetContent<Portal>();
+            if (portal != nullptr)
             {
                 canMove = false;
-                break;
             }
         }
-    }
+        });
 
-    Unlock();
+    // Check collision with enemies, chests and items and claim the cell
+    // in the same step (O(1) occupancy grid lookup)
+    if (canMove)
+        canMove = room->GetOccupancy()->TryMove(enemy, currentPosition, newPosition);
 
     // If movement is allowed, update the map
+    // The store position moves with the grid, under the same lock, so a removal
+    // right after this clears the right cell
     if (canMove)
     {
+        movingEnemy->SetPosition(newPosition);
+        room->MarkDirty();
+        if (_journal != nullptr)
+            _journal->RecordMove(room->GetWorldPosition(), BinarySaveFormat::TAG_ENEMY, currentPosition, newPosition);
         ClearPositionOnMap(currentPosition, room);
         PlaceEntityOnMap(movingEnemy, newPosition, room);
         RedrawPosition(currentPosition, room);
     }
 
+    Unlock();
     return canMove;
 }
 
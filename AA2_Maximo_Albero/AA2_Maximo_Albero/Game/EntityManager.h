@@ -11,29 +11,28 @@
 #include "Portal.h"
 #include "Room.h"
 #include "Wall.h"
+#include "SimulationScheduler.h"
 
+class ActionJournal;
+
+// Spawns, removes and looks up the entities of the rooms
+// The rooms own the entities (one slot map per type), _managerMutex guards those lists
+// against the spawner, the simulation and the game thread
 class EntityManager
 {
 private:
-    std::vector<Enemy*> _enemies;
-    std::vector<Chest*> _chests;
-    std::vector<Item*> _items;
-
     std::mutex _managerMutex;
 
     Room* _currentRoom;
+    SimulationScheduler* _scheduler;
+    ActionJournal* _journal; // Spawns, damage, moves and removals are recorded here
     std::function<Vector2()> _getPlayerPositionCallback;
-    std::function<void(Enemy*)> _onEnemyAttackPlayer;
 
 public:
-    EntityManager() : _currentRoom(nullptr) {}
-
-    ~EntityManager()
-    {
-        ClearAllEntities();
-    }
+    EntityManager(SimulationScheduler* scheduler) : _currentRoom(nullptr), _scheduler(scheduler), _journal(nullptr) {}
 
     void SetCurrentRoom(Room* room);
+    void SetJournal(ActionJournal* journal) { _journal = journal; }
 
     // ===== ENTITY MANAGEMENT =====
     void SpawnEnemy(Vector2 position, Room* room);
@@ -43,46 +42,35 @@ public:
     void CleanupDeadEnemies(Room* room);
     void CleanupBrokenChests(Room* room);
 
-    // Specific getters
-    Enemy* GetEnemyAtPosition(Vector2 position, Room* room);
-    Chest* GetChestAtPosition(Vector2 position, Room* room);
-    Item* GetItemAtPosition(Vector2 position, Room* room);
-
     bool IsPositionOccupiedByEnemy(Vector2 position);
     bool IsPositionOccupiedByChest(Vector2 position);
     bool IsPositionOccupiedByItem(Vector2 position);
 
-    // List getters
-    std::vector<Enemy*> GetEnemies();
-    std::vector<Chest*> GetChests();
-    std::vector<Item*> GetItems();
-
-    void ClearAllEntities();
-
-    int GetEnemyCount();
-    int GetChestCount();
-
     // Combat system
     bool TryAttackEnemyAt(Vector2 position, Player* attacker, Room* room);
     bool TryAttackChestAt(Vector2 position, Player* attacker, Room* room);
 
+    // An enemy of the current room attacks target, false if the handle no longer resolves
+    bool EnemyAttack(EntityStore* store, EntityHandle enemy, IDamageable* target);
+
     // Loot system
     ItemType SelectLoot();
     void DropLoot(Vector2 position, ItemType lootItem, Room* room);
-    void RemoveItem(Item* itemToRemove, Room* room);
+    // Removes the item at position, pickedType is its type. False if there is none
+    bool TryPickupItemAt(Vector2 position, Room* room, ItemType& pickedType);
+    // False if the handle was already removed
+    bool RemoveItem(EntityHandle item, Room* room);
 
     // Initialization
     void InitializeRoomEntities(Room* room, int roomX, int roomY);
-    void RegisterLoadedEntities(Room* room);
 
     // Enemy callback configuration
     void SetupEnemyCallbacks(std::function<Vector2()> getPlayerPositionCallback,
-        std::function<void(Enemy*)> onEnemyAttackPlayer);
-
-    void ConfigureRoomEnemies(Room* room);
+        std::function<void(EntityStore*, EntityHandle)> onEnemyAttackPlayer);
 
-    // Movement validation (called from enemy threads)
-    bool CanEnemyMoveTo(Enemy* movingEnemy, Vector2 newPosition);
+    // Movement validation (called from the simulation scheduler thread)
+    // enemy is the handle in the slot map of the room that owns store
+    bool CanEnemyMoveTo(EntityStore* store, EntityHandle enemy, Vector2 newPosition);
 
     void Lock() { _managerMutex.lock(); }
     void Unlock() { _managerMutex.unlock(); }
@@ -104,6 +92,14 @@ private:
     template<typename T>
     T* GetEntityAtPosition(Vector2 position, Room* room);
 
+    // Same lookup, with _managerMutex already held
+    template<typename T>
+    T* ResolveEntityAt(Vector2 position, Room* room);
+
+    // Room whose entities live in store, with _managerMutex held
+    // Only the current room is simulated, any other store gives nullptr
+    Room* ResolveRoom(EntityStore* store);
+
     template<typename T>
     bool IsPositionOccupiedBy(Vector2 position);
 
@@ -114,87 +110,34 @@ private:
 // ===== TEMPLATE IMPLEMENTATIONS =====
 
 template<typename T>
-inline T* EntityManager::GetEntityAtPosition(Vector2 position, Room* room)
+inline T* EntityManager::ResolveEntityAt(Vector2 position, Room* room)
 {
     if (room == nullptr)
         return nullptr;
 
-    if constexpr (std::is_same<T, Enemy>::value)
-    {
-        for (Enemy* entity : room->GetEnemies())
-        {
-            Vector2 entityPos = entity->GetPosition();
-            if (entityPos.X == position.X && entityPos.Y == position.Y)
-                return entity;
-        }
-    }
-    else if constexpr (std::is_same<T, Chest>::value)
-    {
-        for (Chest* entity : room->GetChests())
-        {
-            Vector2 entityPos = entity->GetPosition();
-            if (entityPos.X == position.X && entityPos.Y == position.Y)
-                return entity;
-        }
-    }
-    else if constexpr (std::is_same<T, Item>::value)
-    {
-        for (Item* entity : room->GetItems())
-        {
-            Vector2 entityPos = entity->GetPosition();
-            if (entityPos.X == position.X && entityPos.Y == position.Y)
-                return entity;
-        }
-    }
-
-    return nullptr;
+    // O(1): the occupancy grid gives the handle, the slot map the entity
+    // A handle whose entity was removed resolves to nullptr
+    return room->GetEntities<T>().Get(room->GetOccupancy()->Get<T>(position));
 }
 
 template<typename T>
-inline bool EntityManager::IsPositionOccupiedBy(Vector2 position)
+inline T* EntityManager::GetEntityAtPosition(Vector2 position, Room* room)
 {
     Lock();
-    bool occupied = false;
+    T* entity = ResolveEntityAt<T>(position, room);
+    Unlock();
 
-    if constexpr (std::is_same<T, Enemy>::value)
-    {
-        for (const Enemy* entity : _enemies)
-        {
-            Vector2 entityPos = const_cast<Enemy*>(entity)->GetPosition();
-            if (entityPos.X == position.X && entityPos.Y == position.Y)
-            {
-                occupied = true;
-                break;
-            }
-        }
-    }
-    else if constexpr (std::is_same<T, Chest>::value)
-    {
-        for (const Chest* entity : _chests)
-        {
-            Vector2 entityPos = const_cast<Chest*>(entity)->GetPosition();
-            if (entityPos.X == position.X && entityPos.Y == position.Y)
-            {
-                occupied = true;
-                break;
-            }
-        }
-    }
-    else if constexpr (std::is_same<T, Item>::value)
-    {
-        for (const Item* entity : _items)
-        {
-            Vector2 entityPos = const_cast<Item*>(entity)->GetPosition();
-            if (entityPos.X == position.X && entityPos.Y == position.Y)
-            {
-                occupied = true;
-                break;
-            }
-        }
-    }
+    return entity;
+}
 
+template<typename T>
+inline bool EntityManager::IsPositionOccupiedBy(Vector2 position)
+{
+    Lock();
+    Room* room = _currentRoom;
     Unlock();
-    return occupied;
+
+    return GetEntityAtPosition<T>(position, room) != nullptr;
 }
 
 template<typename T>
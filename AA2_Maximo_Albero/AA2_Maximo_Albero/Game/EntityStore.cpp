@@ -0,0 +1,85 @@
+#include "EntityStore.h"
+
+EntityStore& EntityStore::GetDetached()
+{
+    static EntityStore store;
+    return store;
+}
+
+EntityHandle EntityStore::Add(EntityKind kind, INodeContent* owner, Vector2 position, int health, int damage)
+{
+    Lock();
+
+    EntityHandle handle = _index.Insert();
+    _kinds.push_back(kind);
+    _owners.push_back(owner);
+    _roomHandles.push_back(EntityHandle());
+    _positions.push_back(position);
+    _health.push_back(health);
+    _damage.push_back(damage);
+    _cooldownDeadlines.push_back(TimePoint());
+    _simulated.push_back(0);
+
+    Unlock();
+    return handle;
+}
+
+void EntityStore::Remove(EntityHandle handle)
+{
+    Lock();
+
+    int removed = _index.Remove(handle);
+    if (removed == SlotIndex::NOT_FOUND)
+    {
+        Unlock();
+        return;
+    }
+
+    size_t i = (size_t)removed;
+    SetSimulatedAt(i, false);
+
+    // Same swap and pop the index did, on every array
+    _kinds[i] = _kinds.back();
+    _owners[i] = _owners.back();
+    _roomHandles[i] = _roomHandles.back();
+    _positions[i] = _positions.back();
+    _health[i] = _health.back();
+    _damage[i] = _damage.back();
+    _cooldownDeadlines[i] = _cooldownDeadlines.back();
+    _simulated[i] = _simulated.back();
+
+    _kinds.pop_back();
+    _owners.pop_back();
+    _roomHandles.pop_back();
+    _positions.pop_back();
+    _health.pop_back();
+    _damage.pop_back();
+    _cooldownDeadlines.pop_back();
+    _simulated.pop_back();
+
+    Unlock();
+}
+
+void EntityStore::SetRoomHandle(EntityHandle handle, EntityHandle roomHandle)
+{
+    Lock();
+
+    int index = _index.Find(handle);
+    if (index != SlotIndex::NOT_FOUND)
+        _roomHandles[(size_t)index] = roomHandle;
+
+    Unlock();
+}
+
+void EntityStore::SetSimulatedAt(size_t i, bool simulated)
+{
+    if (IsSimulatedAt(i) == simulated)
+        return;
+
+    _simulated[i] = simulated ? 1 : 0;
+
+    if (simulated)
+        _simulatedCount++;
+    else
+        _simulatedCount--;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include "../NodeMap/Vector2.h"
+#include "../Utils/SlotMap.h"
+
+class INodeContent;
+class FlowField;
+
+enum class EntityKind : uint8_t
+{
+    ENEMY,
+    CHEST,
+    ITEM
+};
+
+// State of the entities of a room, one array per component (structure of arrays)
+// Enemy, Chest and Item are views that keep a handle into it. Systems (the enemy update in
+// SimulationScheduler) lock the store once and walk the arrays linearly instead of
+// locking every entity
+//
+// Removal is swap and pop, like SlotMap: dense indexes change, handles do not
+// Lock order: after EntityManager and SimulationScheduler, before the occupancy grid and CC.
+// Nothing is called back while it is held
+class EntityStore
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    // Entities created outside a room (ICodable::FromJson) keep their state here
+    static EntityStore& GetDetached();
+
+    EntityHandle Add(EntityKind kind, INodeContent* owner, Vector2 position, int health, int damage);
+    void Remove(EntityHandle handle);
+
+    // Handle of the entity in its room's slot map (Room::AddEnemy), the scheduler passes it to the callbacks
+    void SetRoomHandle(EntityHandle handle, EntityHandle roomHandle);
+
+    // Navigation of the room the store belongs to, the enemy system steers with it (nullptr: random walk)
+    void SetFlowField(FlowField* flowField) { _flowField = flowField; }
+    FlowField* GetFlowField() const { return _flowField; }
+
+    void Lock() { _storeMutex.lock(); }
+    void Unlock() { _storeMutex.unlock(); }
+
+    // ===== WITH Lock() HELD =====
+
+    // Dense index of a live handle, SlotIndex::NOT_FOUND if it was removed
+    int Find(EntityHandle handle) const { return _index.Find(handle); }
+    size_t Size() const { return _kinds.size(); }
+    EntityHandle HandleAt(size_t i) const { return _index.GetHandleAt(i); }
+
+    EntityKind KindAt(size_t i) const { return _kinds[i]; }
+    INodeContent* OwnerAt(size_t i) const { return _owners[i]; }
+    EntityHandle RoomHandleAt(size_t i) const { return _roomHandles[i]; }
+    Vector2& PositionAt(size_t i) { return _positions[i]; }
+    int& HealthAt(size_t i) { return _health[i]; }
+    int& DamageAt(size_t i) { return _damage[i]; }
+    TimePoint& CooldownAt(size_t i) { return _cooldownDeadlines[i]; }
+    bool IsSimulatedAt(size_t i) const { return _simulated[i] != 0; }
+
+    // Only simulated entities are updated by the scheduler
+    void SetSimulatedAt(size_t i, bool simulated);
+    size_t GetSimulatedCount() const { return _simulatedCount; }
+
+private:
+    SlotIndex _index;
+
+    std::vector<EntityKind> _kinds;
+    std::vector<INodeContent*> _owners; // The view
+    std::vector<EntityHandle> _roomHandles; // Invalid until the room adds the entity
+    std::vector<Vector2> _positions;
+    std::vector<int> _health;
+    std::vector<int> _damage;
+    std::vector<TimePoint> _cooldownDeadlines; // Next time the entity may act
+    std::vector<uint8_t> _simulated;
+    size_t _simulatedCount = 0;
+
+    FlowField* _flowField = nullptr;
+
+    std::mutex _storeMutex;
+};
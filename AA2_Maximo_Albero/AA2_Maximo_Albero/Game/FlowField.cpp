@@ -0,0 +1,127 @@
+#include "FlowField.h"
+#include "Wall.h"
+#include "Portal.h"
+#include "../Utils/GameStats.h"
+#include <algorithm>
+
+namespace
+{
+    // Same order as the enemies' random directions: up, down, left, right
+    const int STEP_X[4] = { 0, 0, -1, 1 };
+    const int STEP_Y[4] = { -1, 1, 0, 0 };
+}
+
+const int FlowField::UNREACHABLE;
+const uint8_t FlowField::NO_STEP;
+
+FlowField::FlowField(NodeMap* map)
+    : _map(map), _size(map->GetSize()), _target(0, 0), _hasTarget(false), _obstaclesDirty(true)
+{
+    size_t cellCount = (size_t)_size.X * _size.Y;
+    _blocked.assign(cellCount, 0);
+    _distances.assign(cellCount, UNREACHABLE);
+    _steps.assign(cellCount, NO_STEP);
+    _queue.reserve(cellCount);
+}
+
+bool FlowField::Update(Vector2 target)
+{
+    if (GetIndex(target) < 0)
+    {
+        _hasTarget = false;
+        return false;
+    }
+
+    bool obstaclesChanged = _obstaclesDirty.exchange(false);
+    if (obstaclesChanged)
+        RebuildObstacles();
+
+    if (_hasTarget && !obstaclesChanged && target.X == _target.X && target.Y == _target.Y)
+        return true;
+
+    _target = target;
+    _hasTarget = true;
+    Recompute();
+    return true;
+}
+
+Vector2 FlowField::GetStep(Vector2 position) const
+{
+    int index = GetIndex(position);
+    if (!_hasTarget || index < 0 || _steps[index] == NO_STEP)
+        return Vector2(0, 0);
+
+    uint8_t step = _steps[index];
+    return Vector2(STEP_X[step], STEP_Y[step]);
+}
+
+int FlowField::GetDistance(Vector2 position) const
+{
+    int index = GetIndex(position);
+    if (!_hasTarget || index < 0)
+        return UNREACHABLE;
+
+    return _distances[index];
+}
+
+int FlowField::GetIndex(Vector2 position) const
+{
+    if (position.X < 0 || position.Y < 0 || position.X >= _size.X || position.Y >= _size.Y)
+        return -1;
+
+    return position.Y * _size.X + position.X;
+}
+
+// Walls and portals only change when the room is built (constructor, GeneratePortals),
+// the whole map is read once per change instead of on every recomputation
+void FlowField::RebuildObstacles()
+{
+    for (int y = 0; y < _size.Y; y++)
+    {
+        for (int x = 0; x < _size.X; x++)
+        {
+            uint8_t& blocked = _blocked[y * _size.X + x];
+
+            _map->SafePickNode(Vector2(x, y), [&blocked](Node* node) {
+                blocked = node != nullptr && (node->GetContent<Wall>() != nullptr || node->GetContent<Portal>() != nullptr);
+                });
+        }
+    }
+}
+
+// BFS from the target: the first time a cell is reached, its step points to the cell it was reached from
+void FlowField::Recompute()
+{
+    std::fill(_distances.begin(), _distances.end(), UNREACHABLE);
+    std::fill(_steps.begin(), _steps.end(), NO_STEP);
+    _queue.clear();
+
+    int targetIndex = GetIndex(_target);
+    _distances[targetIndex] = 0;
+    _queue.push_back(targetIndex);
+
+    for (size_t head = 0; head < _queue.size(); head++)
+    {
+        int index = _queue[head];
+        int x = index % _size.X;
+        int y = index / _size.X;
+
+        for (uint8_t direction = 0; direction < 4; direction++)
+        {
+            int nextX = x + STEP_X[direction];
+            int nextY = y + STEP_Y[direction];
+            if (nextX < 0 || nextY < 0 || nextX >= _size.X || nextY >= _size.Y)
+                continue;
+
+            int next = nextY * _size.X + nextX;
+            if (_blocked[next] || _distances[next] != UNREACHABLE)
+                continue;
+
+            _distances[next] = _distances[index] + 1;
+            _steps[next] = direction ^ 1; // The opposite direction goes back towards the target
+            _queue.push_back(next);
+        }
+    }
+
+    GameStats::Add(GameStats::FLOW_FIELD_UPDATES);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "../NodeMap/NodeMap.h"
+#include "../NodeMap/Vector2.h"
+
+// Distance map from every cell of a room to one target (the player), BFS over the walkable cells
+// Each cell keeps the step that takes it one cell closer, so every enemy reads its move in O(1)
+// Only walls and portals block: entities move every tick, a step into one just fails and is retried
+//
+// Recomputed by Update() only when the target moved or MarkObstaclesDirty() was called
+// Not thread-safe except MarkObstaclesDirty(), the SimulationScheduler uses it with its lock held
+class FlowField
+{
+public:
+    static const int UNREACHABLE = -1;
+
+    FlowField(NodeMap* map);
+
+    // Walls or portals changed, the next Update() reads them again from the NodeMap
+    void MarkObstaclesDirty() { _obstaclesDirty = true; }
+
+    // false if the target is outside the room, GetStep() then returns (0, 0) everywhere
+    bool Update(Vector2 target);
+
+    // Direction of the next step towards the target, (0, 0) on the target or if it cannot be reached
+    Vector2 GetStep(Vector2 position) const;
+    int GetDistance(Vector2 position) const;
+
+private:
+    static const uint8_t NO_STEP = 4;
+
+    NodeMap* _map;
+    Vector2 _size;
+
+    Vector2 _target;
+    bool _hasTarget;
+    std::atomic<bool> _obstaclesDirty;
+
+    // Row-major like the NodeMap (index = y * width + x)
+    std::vector<uint8_t> _blocked;
+    std::vector<int> _distances;
+    std::vector<uint8_t> _steps; // Index into the direction table, NO_STEP if none
+    std::vector<int> _queue;     // BFS frontier, reused between updates
+
+    int GetIndex(Vector2 position) const;
+    void RebuildObstacles();
+    void Recompute();
+};
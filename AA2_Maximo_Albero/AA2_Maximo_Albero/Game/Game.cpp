@@ -1,14 +1,18 @@
 #include "Game.h"
 #include "Wall.h"
+#include "ActionJournal.h"
 #include "../Utils/ConsoleControl.h"
+#include "../Utils/GameStats.h"
 #include <iostream>
 
-Game::Game()
+Game::Game(const std::string& saveFilePath)
 {
     _dungeonMap = new DungeonMap(3, 3);
     _inputSystem = new InputSystem();
-    _entityManager = new EntityManager();
-    _spawner = new Spawner(_entityManager, 10);
+    _scheduler = new SimulationScheduler(100);
+    _entityManager = new EntityManager(_scheduler);
+    _timers = new TimerWheel(10);
+    _spawner = new Spawner(_entityManager, _timers, 10);
     _ui = new UI();
     _player = nullptr;
     _playerPosition = Vector2(1, 1);
@@ -17,7 +21,10 @@ Game::Game()
     _gameOver = false;
     _messages = new MessageSystem();
 
-    _saveManager = new SaveManager("savegame.json", 5);
+    // Autosaves are only checkpoints, the journal keeps what happens between them
+    _saveManager = new SaveManager(saveFilePath, 30);
+    _journal = _saveManager->GetJournal();
+    _entityManager->SetJournal(_journal);
 }
 
 Game::~Game()
@@ -32,8 +39,12 @@ Game::~Game()
     delete _ui;
     delete _spawner;
     delete _entityManager;
-    delete _inputSystem;
+    delete _timers;
+
+    // The rooms own the entities, enemies still leave the scheduler when deleted
     delete _dungeonMap;
+    delete _scheduler;
+    delete _inputSystem;
 }
 
 void Game::InitializeCurrentRoom()
@@ -66,43 +77,46 @@ void Game::ActivateRoomEntities(Room* room)
     if (room == nullptr)
         return;
 
-    // Only place on map, DO NOT start threads
+    // Only place on map, DO NOT register in the scheduler
     room->ActivateEntities();
 }
 
-void Game::StartRoomEnemyThreads(Room* room)
+void Game::RegisterRoomEnemies(Room* room)
 {
     if (room == nullptr)
         return;
 
-    // Configure callbacks for all enemies in the room
-    _entityManager->ConfigureRoomEnemies(room);
-
-    // Start individual threads for each enemy
+    // The scheduler updates every registered enemy on its tick
     for (Enemy* enemy : room->GetEnemies())
     {
         if (enemy != nullptr)
-            enemy->StartMovement();
+            enemy->StartMovement(_scheduler);
     }
 }
 
-void Game::DeactivateRoomEntities(Room* room)
+void Game::UnregisterRoomEnemies(Room* room)
 {
     if (room == nullptr)
         return;
 
-    // STEP 1: Stop all enemy threads
+    // Unregister waits for the enemy's current update to finish
     for (Enemy* enemy : room->GetEnemies())
     {
         if (enemy != nullptr)
             enemy->StopMovement();
     }
+}
+
+void Game::DeactivateRoomEntities(Room* room)
+{
+    if (room == nullptr)
+        return;
 
-    // STEP 2: Wait a moment to ensure all have finished
-    // This prevents race conditions where a thread is still drawing
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // STEP 1: Remove all enemies from the scheduler
+    // Returns once no enemy of this room is being updated
+    UnregisterRoomEnemies(room);
 
-    // STEP 3: Remove all entities from the map
+    // STEP 2: Remove all entities from the map
     room->DeactivateEntities();
 }
 
@@ -118,16 +132,28 @@ void Game::PlacePlayerOnMap(Vector2 position)
         });
 }
 
+void Game::SetKeySource(InputSystem::KeySource keySource)
+{
+    _inputSystem->SetKeySource(keySource);
+}
+
+void Game::SetSaveFormat(SaveFormat format)
+{
+    _saveManager->SetSaveFormat(format);
+}
+
+InputSystem::LatencyStats Game::GetInputLatencyStats()
+{
+    return _inputSystem->GetLatencyStats();
+}
+
 void Game::SetupInputListeners()
 {
     _inputSystem->AddListener(K_W, [this]() { this->OnMoveUp(); });
     _inputSystem->AddListener(K_S, [this]() { this->OnMoveDown(); });
     _inputSystem->AddListener(K_A, [this]() { this->OnMoveLeft(); });
     _inputSystem->AddListener(K_D, [this]() { this->OnMoveRight(); });
-    _inputSystem->AddListener(K_SPACE, [this]() {
-        if (this->_player != nullptr)
-            this->_player->UsePotion();
-        });
+    _inputSystem->AddListener(K_SPACE, [this]() { this->UsePotion(); });
 }
 
 std::function<Vector2()> Game::GetPlayerPositionCallback()
@@ -147,18 +173,18 @@ std::function<Vector2()> Game::GetPlayerPositionCallback()
         };
 }
 
-std::function<void(Enemy*)> Game::GetEnemyAttackCallback()
+std::function<void(EntityStore*, EntityHandle)> Game::GetEnemyAttackCallback()
 {
-    return [this](Enemy* enemy) {
+    return [this](EntityStore* store, EntityHandle enemy) {
         if (this->_gameOver)
             return;
 
         if (this->_player == nullptr || !this->_player->IsAlive())
             return;
 
-        if (enemy != nullptr)
+        if (this->_entityManager->EnemyAttack(store, enemy, this->_player))
         {
-            enemy->Attack(this->_player);
+            this->_journal->RecordPlayer(this->_player->GetSnapshot());
 
             if (this->_player != nullptr && !this->_player->IsAlive())
                 this->CheckPlayerDeath();
@@ -173,7 +199,7 @@ bool Game::LoadSavedGame()
 
     _player = new Player(_playerPosition, _messages);
 
-    if (_saveManager->LoadGame(_dungeonMap, _player, _entityManager))
+    if (_saveManager->LoadGame(_dungeonMap, _player))
     {
         _playerPosition = _player->GetPosition();
         Room* currentRoom = _dungeonMap->GetActiveRoom();
@@ -208,6 +234,8 @@ void Game::StartNewGame()
 
 void Game::Start()
 {
+    auto startTime = std::chrono::steady_clock::now();
+
     _gameMutex.lock();
 
     if (_running)
@@ -228,8 +256,13 @@ void Game::Start()
     if (!loadedGame)
         StartNewGame();
 
+    // A loaded game keeps appending to its journal, a new one starts it again
+    _saveManager->StartJournal(!loadedGame);
+
+    _timers->Start();
+
     _ui->SetMapSize(Vector2(20, 10));
-    _messages->Start();
+    _messages->Start(_timers);
 
     // Configure input
     SetupInputListeners();
@@ -239,9 +272,11 @@ void Game::Start()
     // Draw interface
     CC::Clear();
     DrawCurrentRoom();
-    _ui->Start(_player);
+    _ui->Start(_player, _timers);
     _inputSystem->StartListen();
 
+    _scheduler->Start();
+
     // Configure global EntityManager callbacks
     Room* currentRoom = _dungeonMap->GetActiveRoom();
     _entityManager->SetCurrentRoom(currentRoom);
@@ -257,11 +292,17 @@ void Game::Start()
     else
     {
         ActivateRoomEntities(currentRoom);
-        StartRoomEnemyThreads(currentRoom); // Start threads AFTER drawing
+        RegisterRoomEnemies(currentRoom); // Register AFTER drawing
     }
 
+    CC::Present();
+
+    GameStats::AddTiming(GameStats::TIME_TO_FIRST_FRAME,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+
     _spawner->Start(currentRoom);
-    _saveManager->StartAutoSave(_dungeonMap, _player, _entityManager);
+    _saveManager->StartAutoSave(_timers, _dungeonMap, _player, _entityManager,
+        [this](const SaveManager::RoomRevisions* savedRevisions) { return this->CreateSaveSnapshot(savedRevisions); });
 }
 
 void Game::Stop()
@@ -279,16 +320,41 @@ void Game::Stop()
 
     // Stop all systems
     _saveManager->StopAutoSave();
+    _saveManager->StopPrefetch();
     _inputSystem->StopListen();
 
     _spawner->Stop();
+    _scheduler->Stop();
 
     if (_messages != nullptr)
         _messages->Stop();
 
     _ui->Stop();
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // Every job is cancelled by now
+    _timers->Stop();
+
+    // Last, every system that records state changes is stopped
+    _saveManager->StopJournal();
+}
+
+// Pauses spawner, enemies and player actions just long enough to copy the state
+// Serialization and disk writes happen later on the timer thread
+// With savedRevisions only the rooms that changed since the last save are copied
+SaveManager::Snapshot Game::CreateSaveSnapshot(const SaveManager::RoomRevisions* savedRevisions)
+{
+    _spawner->Lock();
+    _scheduler->Lock();
+    _gameMutex.lock();
+
+    SaveManager::Snapshot snapshot = SaveManager::TakeSnapshot(_dungeonMap, _player, savedRevisions);
+    snapshot.journalSequence = _journal->GetLastSequence();
+
+    _gameMutex.unlock();
+    _scheduler->Unlock();
+    _spawner->Unlock();
+
+    return snapshot;
 }
 
 void Game::DrawCurrentRoom()
@@ -296,6 +362,8 @@ void Game::DrawCurrentRoom()
     Room* currentRoom = _dungeonMap->GetActiveRoom();
     if (currentRoom != nullptr)
         currentRoom->Draw();
+
+    CC::Present();
 }
 
 bool Game::CanMoveTo(Vector2 position)
@@ -358,6 +426,7 @@ bool Game::TryUsePortal(Vector2 newPosition)
         PortalDir portalDirection = portal->GetDirection();
         _player->UpdateActionTime();
         _gameMutex.unlock();
+        _scheduler->Unlock();
         ChangeRoom(portalDirection);
         return true;
     }
@@ -399,6 +468,7 @@ bool Game::TryAttackInRange(Vector2 direction, int attackRange)
             _entityManager->TryAttackChestAt(targetPosition, _player, currentRoom))
         {
             _player->UpdateActionTime();
+            GameStats::Add(GameStats::ATTACKS);
             return true;
         }
     }
@@ -410,21 +480,12 @@ bool Game::TryAttackAtPosition(Vector2 position)
 {
     Room* currentRoom = _dungeonMap->GetActiveRoom();
 
-    Enemy* enemy = _entityManager->GetEnemyAtPosition(position, currentRoom);
-    if (enemy != nullptr)
-    {
-        _player->Attack(enemy);
-        _player->UpdateActionTime();
-        _entityManager->CleanupDeadEnemies(currentRoom);
-        return true;
-    }
-
-    Chest* chest = _entityManager->GetChestAtPosition(position, currentRoom);
-    if (chest != nullptr)
+    // Resolved, attacked and recorded under the EntityManager lock
+    if (_entityManager->TryAttackEnemyAt(position, _player, currentRoom) ||
+        _entityManager->TryAttackChestAt(position, _player, currentRoom))
     {
-        _player->Attack(chest);
         _player->UpdateActionTime();
-        _entityManager->CleanupBrokenChests(currentRoom);
+        GameStats::Add(GameStats::ATTACKS);
         return true;
     }
 
@@ -434,27 +495,41 @@ bool Game::TryAttackAtPosition(Vector2 position)
 void Game::TryPickupItem(Vector2 position)
 {
     Room* currentRoom = _dungeonMap->GetActiveRoom();
-    Item* item = _entityManager->GetItemAtPosition(position, currentRoom);
 
-    if (item != nullptr)
+    ItemType type;
+    if (!_entityManager->TryPickupItemAt(position, currentRoom, type))
+        return;
+
+    switch (type)
     {
-        ItemType type = item->GetType();
-        switch (type)
-        {
-        case ItemType::COIN:
-            _player->AddCoin();
-            break;
-        case ItemType::POTION:
-            _player->AddPotion();
-            break;
-        case ItemType::WEAPON:
-            _player->ChangeWeapon();
-            break;
-        }
-        _entityManager->RemoveItem(item, currentRoom);
+    case ItemType::COIN:
+        _player->AddCoin();
+        break;
+    case ItemType::POTION:
+        _player->AddPotion();
+        break;
+    case ItemType::WEAPON:
+        _player->ChangeWeapon();
+        break;
     }
 }
 
+void Game::UsePotion()
+{
+    // Same locks as a move, the journal gets the player state in order
+    _scheduler->Lock();
+    _gameMutex.lock();
+
+    if (_player != nullptr)
+    {
+        _player->UsePotion();
+        _journal->RecordPlayer(_player->GetSnapshot());
+    }
+
+    _gameMutex.unlock();
+    _scheduler->Unlock();
+}
+
 void Game::MovePlayerTo(Vector2 newPosition)
 {
     Room* currentRoom = _dungeonMap->GetActiveRoom();
@@ -486,21 +561,27 @@ void Game::MovePlayerTo(Vector2 newPosition)
     {
         _player->UpdateActionTime();
     }
+
+    GameStats::Add(GameStats::MOVES);
 }
 
 void Game::MovePlayer(Vector2 direction)
 {
+    // Enemies are paused while the player acts (same lock order as the tick)
+    _scheduler->Lock();
     _gameMutex.lock();
 
     if (_gameOver || !_running || _player == nullptr || !_player->IsAlive())
     {
         _gameMutex.unlock();
+        _scheduler->Unlock();
         return;
     }
 
     if (!_player->CanPerformAction())
     {
         _gameMutex.unlock();
+        _scheduler->Unlock();
         return;
     }
 
@@ -509,18 +590,20 @@ void Game::MovePlayer(Vector2 direction)
     if (!CanMoveTo(newPosition))
     {
         _gameMutex.unlock();
+        _scheduler->Unlock();
         return;
     }
 
     // Try to use portal
     if (TryUsePortal(newPosition))
-        return; // Mutex already unlocked in TryUsePortal
+        return; // Mutexes already unlocked in TryUsePortal
 
     // Try ranged attack
     int attackRange = _player->GetAttackRange();
     if (TryAttackInRange(direction, attackRange))
     {
         _gameMutex.unlock();
+        _scheduler->Unlock();
         return;
     }
 
@@ -528,6 +611,7 @@ void Game::MovePlayer(Vector2 direction)
     if (TryAttackAtPosition(newPosition))
     {
         _gameMutex.unlock();
+        _scheduler->Unlock();
         return;
     }
 
@@ -536,12 +620,16 @@ void Game::MovePlayer(Vector2 direction)
 
     // Move player
     MovePlayerTo(newPosition);
+    _journal->RecordPlayer(_player->GetSnapshot());
 
     _gameMutex.unlock();
+    _scheduler->Unlock();
 }
 
 void Game::ChangeRoom(PortalDir direction)
 {
+    auto changeStart = std::chrono::steady_clock::now();
+
     // PHASE 1: PREPARATION (without locks)
 
     // Calculate new position
@@ -562,22 +650,13 @@ void Game::ChangeRoom(PortalDir direction)
     }
 
     // PHASE 2: STOP ALL SYSTEMS
-    // CRITICAL: Stop spawner first
+    // CRITICAL: Stop spawner first, returns once the spawn thread has joined
     _spawner->Stop();
 
-    // PHASE 3: STOP ENEMY THREADS FROM CURRENT ROOM
+    // PHASE 3: UNREGISTER ENEMIES FROM CURRENT ROOM
     // This MUST be done BEFORE touching the map
-    if (oldRoom != nullptr)
-    {
-        for (Enemy* enemy : oldRoom->GetEnemies())
-        {
-            if (enemy != nullptr)
-                enemy->StopMovement();
-        }
-    }
-
-    // Wait for all threads to finish
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // Returns once the scheduler is not updating any of them
+    UnregisterRoomEnemies(oldRoom);
 
     // PHASE 4: MODIFY THE MAP (with lock)
     _gameMutex.lock();
@@ -611,29 +690,43 @@ void Game::ChangeRoom(PortalDir direction)
     if (_player != nullptr)
     {
         _player->SetPosition(_playerPosition);
+        _journal->RecordRoomChange(newX, newY);
+        _journal->RecordPlayer(_player->GetSnapshot());
     }
 
-    // Activate entities on map (without threads yet)
+    // First visit since a lazy load: decode its entities now, then prepare the next ones
+    _saveManager->LoadPendingRoom(newRoom);
+    _saveManager->PrefetchNeighbours(_dungeonMap, newX, newY);
+
+    // Activate entities on map (not registered in the scheduler yet)
     ActivateRoomEntities(newRoom);
     UpdatePlayerOnMap();
 
+    // Before spawning: the new enemies register in the scheduler as they are created,
+    // their callbacks must already resolve in this room
+    _entityManager->SetCurrentRoom(newRoom);
+
+    // Spawn the entities of a new room while the autosave can not snapshot it
+    InitializeCurrentRoom();
+
     _gameMutex.unlock();
 
     CC::Clear();
     DrawCurrentRoom();
 
-    InitializeCurrentRoom();
-
-    _entityManager->SetCurrentRoom(newRoom);
-
-    StartRoomEnemyThreads(newRoom);
+    RegisterRoomEnemies(newRoom);
     _spawner->Start(newRoom);
+
+    GameStats::Add(GameStats::ROOM_CHANGES);
+    GameStats::AddTiming(GameStats::ROOM_CHANGE_LATENCY,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - changeStart).count());
 }
 
-void Game::OnMoveUp() { MovePlayer(Vector2(0, -1)); }
-void Game::OnMoveDown() { MovePlayer(Vector2(0, 1)); }
-void Game::OnMoveLeft() { MovePlayer(Vector2(-1, 0)); }
-void Game::OnMoveRight() { MovePlayer(Vector2(1, 0)); }
+// Each action is presented as one frame (move, attack, loot drop, pickup)
+void Game::OnMoveUp() { MovePlayer(Vector2(0, -1)); CC::Present(); }
+void Game::OnMoveDown() { MovePlayer(Vector2(0, 1)); CC::Present(); }
+void Game::OnMoveLeft() { MovePlayer(Vector2(-1, 0)); CC::Present(); }
+void Game::OnMoveRight() { MovePlayer(Vector2(1, 0)); CC::Present(); }
 
 bool Game::IsPositionOccupied(Vector2 position)
 {
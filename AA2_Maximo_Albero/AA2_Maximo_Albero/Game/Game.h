@@ -3,6 +3,7 @@
 #include "Player.h"
 #include "EntityManager.h"
 #include "Spawner.h"
+#include "SimulationScheduler.h"
 #include "Portal.h"
 #include "../InputSystem/InputSystem.h"
 #include "UI.h"
@@ -10,29 +11,40 @@
 #include <functional>
 #include "SaveManager.h"
 #include "../Utils/MessageSystem.h"
+#include "../Utils/TimerWheel.h"
 
 class Game
 {
 public:
-    Game();
+    Game(const std::string& saveFilePath = "savegame.json");
     ~Game();
 
     void Start();
     void Stop();
 
+    // Must be called before Start(), used by the headless mode
+    void SetKeySource(InputSystem::KeySource keySource);
+    InputSystem::LatencyStats GetInputLatencyStats();
+
+    // Format of the next saves, loading detects it from the file
+    void SetSaveFormat(SaveFormat format);
+
     bool IsGameOver() const { return _gameOver; }
 
 private:
     DungeonMap* _dungeonMap;
     InputSystem* _inputSystem;
     EntityManager* _entityManager;
+    SimulationScheduler* _scheduler;
     Spawner* _spawner;
     UI* _ui;
     Player* _player;
     Vector2 _playerPosition;
 
     SaveManager* _saveManager;
+    ActionJournal* _journal; // Owned by _saveManager
     MessageSystem* _messages;
+    TimerWheel* _timers; // Spawns, autosave, sidebar and messages share its thread
 
     int _currentRoomIndex;
     bool _running;
@@ -53,7 +65,8 @@ private:
 
     // ===== CALLBACKS =====
     std::function<Vector2()> GetPlayerPositionCallback();
-    std::function<void(Enemy*)> GetEnemyAttackCallback();
+    std::function<void(EntityStore*, EntityHandle)> GetEnemyAttackCallback();
+    SaveManager::Snapshot CreateSaveSnapshot(const SaveManager::RoomRevisions* savedRevisions);
 
     // ===== RENDERIZADO =====
     void DrawCurrentRoom();
@@ -71,11 +84,13 @@ private:
     bool TryAttackInRange(Vector2 direction, int attackRange);
     bool TryAttackAtPosition(Vector2 position);
     void TryPickupItem(Vector2 position);
+    void UsePotion();
 
     // ===== GESTIN DE SALAS =====
     void ChangeRoom(PortalDir direction);
     PortalDir GetOppositeDirection(PortalDir dir);
-    void StartRoomEnemyThreads(Room* room);
+    void RegisterRoomEnemies(Room* room);
+    void UnregisterRoomEnemies(Room* room);
 
     // ===== CALLBACKS DE INPUT =====
     void OnMoveUp();
@@ -2,51 +2,114 @@
 
 void Item::Draw(Vector2 pos)
 {
-    CC::Lock();
-    CC::SetPosition(pos.X, pos.Y);
-
     // Draw based on the item type
     switch (_type)
     {
     case ItemType::COIN:
-        std::cout << "k";
+        CC::DrawCell(pos.X, pos.Y, 'k');
         break;
     case ItemType::POTION:
-        std::cout << "o";
+        CC::DrawCell(pos.X, pos.Y, 'o');
         break;
     case ItemType::WEAPON:
-        std::cout << "w";
+        CC::DrawCell(pos.X, pos.Y, 'w');
         break;
     }
-
-    CC::Unlock();
 }
 
+// (0, 0) once the components are removed
 Vector2 Item::GetPosition() {
-    _itemMutex.lock();
-    Vector2 pos = _position;
-    _itemMutex.unlock();
+    _store->Lock();
+    int i = _store->Find(_components);
+    Vector2 pos = i != SlotIndex::NOT_FOUND ? _store->PositionAt(i) : Vector2(0, 0);
+    _store->Unlock();
     return pos;
 }
 
 ItemType Item::GetType() {
-    _itemMutex.lock();
-    ItemType type = _type;
-    _itemMutex.unlock();
-    return type;
+    return _type;
 }
 
-Json::Value Item::Code() {
+Item::Snapshot Item::GetSnapshot() {
+    return { GetPosition(), _type };
+}
+
+Json::Value Item::CodeSnapshot(const Snapshot& snapshot) {
     Json::Value json;
     CodeSubClassType<Item>(json);
-    json["posX"] = _position.X;
-    json["posY"] = _position.Y;
-    json["type"] = static_cast<int>(_type);
+    json["posX"] = snapshot.position.X;
+    json["posY"] = snapshot.position.Y;
+    json["type"] = static_cast<int>(snapshot.type);
     return json;
 }
 
-void Item::Decode(Json::Value json) {
-    _position.X = json["posX"].asInt();
-    _position.Y = json["posY"].asInt();
-    _type = static_cast<ItemType>(json["type"].asInt());
+Json::Value Item::Code() {
+    return CodeSnapshot(GetSnapshot());
+}
+
+Item::Snapshot Item::DecodeSnapshot(const Json::Value& json) {
+    Snapshot snapshot;
+    snapshot.position = Vector2(json["posX"].asInt(), json["posY"].asInt());
+    snapshot.type = static_cast<ItemType>(json["type"].asInt());
+    return snapshot;
+}
+
+void Item::ApplySnapshot(const Snapshot& snapshot) {
+    _store->Lock();
+    int i = _store->Find(_components);
+    if (i != SlotIndex::NOT_FOUND)
+        _store->PositionAt(i) = snapshot.position;
+    _store->Unlock();
+    _type = snapshot.type;
+}
+
+void Item::Decode(const Json::Value& json) {
+    ApplySnapshot(DecodeSnapshot(json));
+}
+
+void Item::EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer) {
+    writer.BeginObject();
+    CodeSubClassType<Item>(writer);
+    writer.IntField("posX", snapshot.position.X);
+    writer.IntField("posY", snapshot.position.Y);
+    writer.IntField("type", static_cast<int>(snapshot.type));
+    writer.EndObject();
+}
+
+void Item::Encode(CodableWriter& writer) {
+    EncodeSnapshot(GetSnapshot(), writer);
+}
+
+bool Item::DecodeSnapshot(CodableReader& reader, Snapshot& snapshot) {
+    snapshot = Snapshot();
+
+    if (!reader.BeginObject())
+        return false;
+
+    std::string key;
+    while (reader.NextKey(key)) {
+        bool read;
+        if (key == "posX") read = reader.ReadInt(snapshot.position.X);
+        else if (key == "posY") read = reader.ReadInt(snapshot.position.Y);
+        else if (key == "type") {
+            int type = 0;
+            read = reader.ReadInt(type);
+            snapshot.type = static_cast<ItemType>(type);
+        }
+        else read = reader.Skip();
+
+        if (!read)
+            return false;
+    }
+
+    return !reader.Failed();
+}
+
+bool Item::Decode(CodableReader& reader) {
+    Snapshot snapshot;
+    if (!DecodeSnapshot(reader, snapshot))
+        return false;
+
+    ApplySnapshot(snapshot);
+    return true;
 }
\ No newline at end of file
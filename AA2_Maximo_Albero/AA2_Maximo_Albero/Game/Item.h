@@ -2,7 +2,7 @@
 #include "../NodeMap/INodeContent.h"
 #include "../NodeMap/Vector2.h"
 #include "../Utils/ConsoleControl.h"
-#include <mutex>
+#include "EntityStore.h"
 
 #include "../Json/ICodable.h"
 
@@ -12,20 +12,34 @@ enum class ItemType {
     WEAPON
 };
 
+// View of an item, its position lives in the EntityStore of the room
+// The type stays here: it is only written before the item is added to the room
 class Item : public INodeContent, public ICodable {
 private:
-    Vector2 _position;
-    ItemType _type;     
-    std::mutex _itemMutex;
+    EntityStore* _store;
+    EntityHandle _components;
+    ItemType _type;
 
 public:
-    Item() : _position(0, 0), _type(ItemType::COIN) {}
-
-    Item(Vector2 position, ItemType type)
-        : _position(position), _type(type) {
+    static constexpr uint8_t CODABLE_TYPE_ID = ICodable::CODABLE_ITEM;
+    static constexpr const char* CODABLE_TYPE_NAME = "Item";
+
+    // Copia de los datos que se guardan, se toma con el lock del store
+    struct Snapshot
+    {
+        Vector2 position;
+        ItemType type;
+    };
+
+    Item() : Item(&EntityStore::GetDetached()) {}
+
+    Item(EntityStore* store, Vector2 position = Vector2(0, 0), ItemType type = ItemType::COIN)
+        : _store(store), _type(type)
+    {
+        _components = _store->Add(EntityKind::ITEM, this, position, 0, 0);
     }
 
-    ~Item() {}
+    ~Item() { _store->Remove(_components); }
 
     void Draw(Vector2 pos) override;
 
@@ -33,7 +47,16 @@ public:
 
     ItemType GetType();
 
+    Snapshot GetSnapshot();
+    static Json::Value CodeSnapshot(const Snapshot& snapshot);
+    static Snapshot DecodeSnapshot(const Json::Value& json);
+    static void EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer);
+    static bool DecodeSnapshot(CodableReader& reader, Snapshot& snapshot);
+    void ApplySnapshot(const Snapshot& snapshot);
+
     Json::Value Code() override;
 
-    void Decode(Json::Value json) override;
+    void Decode(const Json::Value& json) override;
+    void Encode(CodableWriter& writer) override;
+    bool Decode(CodableReader& reader) override;
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "OccupancyGrid.h"
+
+OccupancyGrid::OccupancyGrid(Vector2 size)
+    : _size(size), _cells(size.X * size.Y)
+{
+}
+
+void OccupancyGrid::ClearAll()
+{
+    _gridMutex.lock();
+    for (Cell& cell : _cells)
+    {
+        cell = Cell();
+    }
+    _gridMutex.unlock();
+}
+
+bool OccupancyGrid::IsFree(Vector2 position)
+{
+    int index = GetIndex(position);
+    if (index < 0)
+        return false;
+
+    _gridMutex.lock();
+    bool isFree = _cells[index].IsEmpty();
+    _gridMutex.unlock();
+
+    return isFree;
+}
+
+bool OccupancyGrid::TryMove(EntityHandle enemy, Vector2 from, Vector2 to)
+{
+    int toIndex = GetIndex(to);
+    if (toIndex < 0)
+        return false;
+
+    int fromIndex = GetIndex(from);
+
+    _gridMutex.lock();
+
+    if (!_cells[toIndex].IsEmpty())
+    {
+        _gridMutex.unlock();
+        return false;
+    }
+
+    if (fromIndex >= 0 && _cells[fromIndex].enemy == enemy)
+        _cells[fromIndex].enemy = EntityHandle();
+
+    _cells[toIndex].enemy = enemy;
+
+    _gridMutex.unlock();
+    return true;
+}
+
+int OccupancyGrid::GetIndex(Vector2 position)
+{
+    if (position.X < 0 || position.Y < 0 || position.X >= _size.X || position.Y >= _size.Y)
+        return -1;
+
+    return position.Y * _size.X + position.X;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <type_traits>
+#include "../NodeMap/Vector2.h"
+#include "../Utils/SlotMap.h"
+
+// Forward declarations
+class Enemy;
+class Chest;
+class Item;
+
+// Per-room index from cell to the entity standing on it
+// Same row-major layout as the NodeMap (index = y * width + x)
+// Lets EntityManager answer "what is at this position" in O(1) instead of scanning lists
+// Cells hold handles into the room's slot maps, a cell left behind by a removed entity resolves to nothing
+class OccupancyGrid
+{
+public:
+    struct Cell
+    {
+        EntityHandle enemy;
+        EntityHandle chest;
+        EntityHandle item;
+
+        bool IsEmpty() const { return !enemy.IsValid() && !chest.IsValid() && !item.IsValid(); }
+    };
+
+public:
+    OccupancyGrid(Vector2 size);
+
+    template<typename T>
+    EntityHandle Get(Vector2 position);
+
+    template<typename T>
+    void Set(Vector2 position, EntityHandle entity);
+
+    // Only clears the cell if it still points to this entity
+    template<typename T>
+    void Clear(Vector2 position, EntityHandle entity);
+
+    void ClearAll();
+
+    bool IsFree(Vector2 position);
+
+    // Checks the destination and moves the enemy in one locked step
+    // so two enemies can never claim the same cell
+    bool TryMove(EntityHandle enemy, Vector2 from, Vector2 to);
+
+private:
+    Vector2 _size;
+    std::vector<Cell> _cells;
+    std::mutex _gridMutex;
+
+    int GetIndex(Vector2 position);
+
+    template<typename T>
+    static EntityHandle& Slot(Cell& cell);
+};
+
+// ===== TEMPLATE IMPLEMENTATIONS =====
+
+template<typename T>
+inline EntityHandle& OccupancyGrid::Slot(Cell& cell)
+{
+    if constexpr (std::is_same<T, Enemy>::value)
+        return cell.enemy;
+    else if constexpr (std::is_same<T, Chest>::value)
+        return cell.chest;
+    else
+    {
+        static_assert(std::is_same<T, Item>::value, "OccupancyGrid only stores Enemy, Chest and Item");
+        return cell.item;
+    }
+}
+
+template<typename T>
+inline EntityHandle OccupancyGrid::Get(Vector2 position)
+{
+    int index = GetIndex(position);
+    if (index < 0)
+        return EntityHandle();
+
+    _gridMutex.lock();
+    EntityHandle entity = Slot<T>(_cells[index]);
+    _gridMutex.unlock();
+
+    return entity;
+}
+
+template<typename T>
+inline void OccupancyGrid::Set(Vector2 position, EntityHandle entity)
+{
+    int index = GetIndex(position);
+    if (index < 0)
+        return;
+
+    _gridMutex.lock();
+    Slot<T>(_cells[index]) = entity;
+    _gridMutex.unlock();
+}
+
+template<typename T>
+inline void OccupancyGrid::Clear(Vector2 position, EntityHandle entity)
+{
+    int index = GetIndex(position);
+    if (index < 0)
+        return;
+
+    _gridMutex.lock();
+    EntityHandle& slot = Slot<T>(_cells[index]);
+    if (slot == entity)
+        slot = EntityHandle();
+    _gridMutex.unlock();
+}
@@ -0,0 +1,222 @@
+#include "PathSearch.h"
+#include <algorithm>
+#include <cstdlib>
+
+const int PathSearch::INF;
+const PathSearch::Node PathSearch::UNVISITED = { PathSearch::INF, PathSearch::INF };
+
+PathSearch::PathSearch(Vector2 gridSize)
+    : _size(gridSize), _startCell(0), _goalCell(0), _initialized(false), _expanded(0), _stamp(0),
+    _blocked(nullptr)
+{
+    size_t cellCount = (size_t)_size.X * _size.Y;
+    _cellSlots.assign(cellCount, CellSlot{ 0, 0 });
+}
+
+void PathSearch::Reset(Vector2 start, Vector2 goal)
+{
+    _start = start;
+    _goal = goal;
+    _startCell = start.Y * _size.X + start.X;
+    _goalCell = goal.Y * _size.X + goal.X;
+    _initialized = false;
+
+    _nodes.clear();
+    _open.clear();
+    _changedCells.clear();
+
+    // Every node becomes invalid, on wrap the stamps are cleared once
+    _stamp++;
+    if (_stamp == 0)
+    {
+        std::fill(_cellSlots.begin(), _cellSlots.end(), CellSlot{ 0, 0 });
+        _stamp = 1;
+    }
+}
+
+void PathSearch::CellChanged(int cell)
+{
+    _changedCells.push_back(cell);
+}
+
+bool PathSearch::Compute(const std::atomic<uint8_t>* blocked, std::vector<Vector2>& path)
+{
+    _blocked = blocked;
+    _expanded = 0;
+
+    if (!_initialized)
+    {
+        // A new search: only the start is known
+        GetNode(_startCell).rhs = 0;
+        PushOpen(_startCell, _start.X, _start.Y);
+        _changedCells.clear();
+        _initialized = true;
+    }
+    else
+    {
+        // Only the cost of entering a changed cell changed
+        for (int cell : _changedCells)
+        {
+            UpdateVertex(cell, cell % _size.X, cell / _size.X);
+        }
+        _changedCells.clear();
+    }
+
+    ComputeShortestPath();
+    return ExtractPath(path);
+}
+
+PathSearch::Node& PathSearch::GetNode(int cell)
+{
+    CellSlot& slot = _cellSlots[cell];
+    if (slot.stamp != _stamp)
+    {
+        slot.stamp = _stamp;
+        slot.node = (uint32_t)_nodes.size();
+        _nodes.push_back(UNVISITED);
+    }
+
+    return _nodes[slot.node];
+}
+
+const PathSearch::Node& PathSearch::PeekNode(int cell) const
+{
+    const CellSlot& slot = _cellSlots[cell];
+    return slot.stamp == _stamp ? _nodes[slot.node] : UNVISITED;
+}
+
+bool PathSearch::IsBlocked(int cell) const
+{
+    return _blocked[cell].load(std::memory_order_relaxed) != 0;
+}
+
+// Manhattan distance, exact on an empty grid so A* never expands more than it needs
+int PathSearch::Heuristic(int x, int y) const
+{
+    return abs(x - _goal.X) + abs(y - _goal.Y);
+}
+
+PathSearch::OpenEntry PathSearch::CalculateKey(int cell, int x, int y) const
+{
+    const Node& node = PeekNode(cell);
+    int best = std::min(node.g, node.rhs);
+    return OpenEntry{ best + Heuristic(x, y), best, cell, (int16_t)x, (int16_t)y };
+}
+
+// Recalculates rhs from the neighbours and queues the cell if that leaves it pending (g != rhs)
+// Entries it already had in the heap are left there, they no longer match and get skipped
+void PathSearch::UpdateVertex(int cell, int x, int y)
+{
+    // rhs of the start is always 0
+    if (cell == _startCell)
+        return;
+
+    int rhs = INF;
+    if (!IsBlocked(cell))
+    {
+        ForEachNeighbour(cell, x, y, [this, &rhs](int neighbour, int, int) {
+            int g = G(neighbour);
+            if (g < INF && g + 1 < rhs)
+                rhs = g + 1;
+            });
+    }
+
+    // Same rhs: the cell is as it was, so is its heap entry if it has one
+    if (rhs == Rhs(cell))
+        return;
+
+    GetNode(cell).rhs = rhs;
+
+    if (G(cell) != rhs)
+        PushOpen(cell, x, y);
+}
+
+void PathSearch::PushOpen(int cell, int x, int y)
+{
+    _open.push_back(CalculateKey(cell, x, y));
+    std::push_heap(_open.begin(), _open.end(), HeapOrder());
+}
+
+void PathSearch::ComputeShortestPath()
+{
+    while (!_open.empty())
+    {
+        OpenEntry top = _open.front();
+        OpenEntry current = CalculateKey(top.cell, top.x, top.y);
+
+        // Outdated entry: the cell is no longer pending or was queued again with another key
+        if (G(top.cell) == Rhs(top.cell) || current.k1 != top.k1 || current.k2 != top.k2)
+        {
+            std::pop_heap(_open.begin(), _open.end(), HeapOrder());
+            _open.pop_back();
+            continue;
+        }
+
+        // Done once nothing left in the heap can improve the goal
+        if (!KeyLess(top, CalculateKey(_goalCell, _goal.X, _goal.Y)) && Rhs(_goalCell) == G(_goalCell))
+            break;
+
+        std::pop_heap(_open.begin(), _open.end(), HeapOrder());
+        _open.pop_back();
+        _expanded++;
+
+        Node& node = GetNode(top.cell);
+        if (node.g > node.rhs)
+        {
+            // Overconsistent: the new distance is final
+            node.g = node.rhs;
+        }
+        else
+        {
+            // Underconsistent (a cell on its path got blocked): forget it and let it be found again
+            node.g = INF;
+            if (node.rhs < INF)
+                PushOpen(top.cell, top.x, top.y);
+        }
+
+        ForEachNeighbour(top.cell, top.x, top.y, [this](int neighbour, int x, int y) { UpdateVertex(neighbour, x, y); });
+    }
+}
+
+// Walks back from the goal, each step to the free neighbour with the lowest g
+bool PathSearch::ExtractPath(std::vector<Vector2>& path)
+{
+    path.clear();
+
+    if (G(_goalCell) >= INF)
+        return false;
+
+    int cell = _goalCell;
+    Vector2 position = _goal;
+    while (cell != _startCell)
+    {
+        path.push_back(position);
+
+        int best = -1;
+        int bestG = G(cell);
+        ForEachNeighbour(cell, position.X, position.Y, [this, &best, &bestG, &position](int neighbour, int x, int y) {
+            if (neighbour != _startCell && IsBlocked(neighbour))
+                return;
+
+            int g = G(neighbour);
+            if (g < bestG)
+            {
+                best = neighbour;
+                bestG = g;
+                position = Vector2(x, y);
+            }
+            });
+
+        // Cannot happen with a consistent search, but never loop forever
+        if (best < 0)
+        {
+            path.clear();
+            return false;
+        }
+
+        cell = best;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "../NodeMap/Vector2.h"
+
+// Shortest path between two cells of a grid, 4 neighbours and cost 1 per step (Lifelong Planning A*)
+// Grids up to 32767 cells per side
+// The first Compute() is a regular A*. After that the search keeps its g/rhs values: when cells
+// are blocked or freed (CellChanged) the next Compute() only repairs the part of the search they affect
+//
+// Entering a blocked cell costs infinite, leaving one does not (the start may be blocked by the
+// entity that asks for the path)
+// Not thread-safe, PathService gives each cached path its own search and lock
+class PathSearch
+{
+public:
+    PathSearch(Vector2 gridSize);
+
+    // New pair of cells, the node storage is reused
+    void Reset(Vector2 start, Vector2 goal);
+
+    // The blocked state of the cell changed, repaired by the next Compute()
+    void CellChanged(int cell);
+
+    // path: the cells after the start up to the goal. false if the goal cannot be reached
+    bool Compute(const std::atomic<uint8_t>* blocked, std::vector<Vector2>& path);
+
+    Vector2 GetStart() const { return _start; }
+    Vector2 GetGoal() const { return _goal; }
+    // Nodes expanded by the last Compute(), a repair expands far fewer than a new search
+    size_t GetExpandedCount() const { return _expanded; }
+
+private:
+    static const int INF = 0x3fffffff;
+
+    struct Node
+    {
+        int g;   // Distance found so far
+        int rhs; // One step lookahead of g, the node is pending while they differ
+    };
+
+    // The coordinates travel with the cell so the hot loop never divides by the width
+    struct OpenEntry
+    {
+        int k1;
+        int k2;
+        int cell;
+        int16_t x;
+        int16_t y;
+    };
+
+    Vector2 _size;
+    Vector2 _start;
+    Vector2 _goal;
+    int _startCell;
+    int _goalCell;
+    bool _initialized;
+    size_t _expanded;
+
+    // Where the node of a cell is, valid while stamp == _stamp (Reset() just bumps _stamp)
+    struct CellSlot
+    {
+        uint32_t stamp;
+        uint32_t node;
+    };
+
+    // Nodes are only created for the cells the search touches
+    std::vector<Node> _nodes;
+    std::vector<CellSlot> _cellSlots;
+    uint32_t _stamp;
+
+    static const Node UNVISITED;
+
+    // Open list: binary heap ordered by key, outdated entries are skipped when popped
+    std::vector<OpenEntry> _open;
+    std::vector<int> _changedCells;
+
+    const std::atomic<uint8_t>* _blocked;
+
+    Node& GetNode(int cell);
+    const Node& PeekNode(int cell) const; // UNVISITED if the cell has no node
+    int G(int cell) const { return PeekNode(cell).g; }
+    int Rhs(int cell) const { return PeekNode(cell).rhs; }
+    bool IsBlocked(int cell) const;
+    int Heuristic(int x, int y) const;
+    OpenEntry CalculateKey(int cell, int x, int y) const;
+    static bool KeyLess(const OpenEntry& a, const OpenEntry& b)
+    {
+        return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2);
+    }
+
+    // std heap functions build a max-heap, inverted to pop the lowest key
+    // A functor and not a function pointer so the heap operations inline it
+    struct HeapOrder
+    {
+        bool operator()(const OpenEntry& a, const OpenEntry& b) const { return KeyLess(b, a); }
+    };
+
+    void UpdateVertex(int cell, int x, int y);
+    void PushOpen(int cell, int x, int y);
+    void ComputeShortestPath();
+    bool ExtractPath(std::vector<Vector2>& path);
+
+    // action(neighbourCell, neighbourX, neighbourY)
+    template<typename F>
+    void ForEachNeighbour(int cell, int x, int y, F action) const;
+};
+
+template<typename F>
+inline void PathSearch::ForEachNeighbour(int cell, int x, int y, F action) const
+{
+    if (y > 0) action(cell - _size.X, x, y - 1);
+    if (y < _size.Y - 1) action(cell + _size.X, x, y + 1);
+    if (x > 0) action(cell - 1, x - 1, y);
+    if (x < _size.X - 1) action(cell + 1, x + 1, y);
+}
@@ -0,0 +1,298 @@
+#include "PathService.h"
+#include "Wall.h"
+#include "Portal.h"
+#include <algorithm>
+
+PathService::PathService(NodeMap* map, size_t cacheCapacity)
+    : _map(map), _size(map->GetSize()), _cacheCapacity(cacheCapacity > 0 ? cacheCapacity : 1),
+    _useCounter(0), _running(false)
+{
+    size_t cellCount = (size_t)_size.X * _size.Y;
+    _blocked.reset(new std::atomic<uint8_t>[cellCount]);
+
+    for (size_t i = 0; i < cellCount; i++)
+    {
+        _blocked[i] = 0;
+    }
+}
+
+PathService::~PathService()
+{
+    Stop();
+}
+
+void PathService::Start(int workerCount)
+{
+    _jobMutex.lock();
+
+    if (_running)
+    {
+        _jobMutex.unlock();
+        return;
+    }
+
+    _running = true;
+    for (int i = 0; i < workerCount; i++)
+    {
+        _workers.push_back(new std::thread(&PathService::WorkerLoop, this));
+    }
+
+    _jobMutex.unlock();
+}
+
+void PathService::Stop()
+{
+    _jobMutex.lock();
+
+    if (!_running)
+    {
+        _jobMutex.unlock();
+        return;
+    }
+
+    _running = false;
+    _jobMutex.unlock(); // Unlock BEFORE join, the workers need it to leave
+    _jobCondition.notify_all();
+
+    for (std::thread* worker : _workers)
+    {
+        if (worker->joinable())
+            worker->join();
+
+        delete worker;
+    }
+
+    _workers.clear();
+}
+
+void PathService::LoadObstacles()
+{
+    for (int y = 0; y < _size.Y; y++)
+    {
+        for (int x = 0; x < _size.X; x++)
+        {
+            bool blocked = false;
+
+            _map->SafePickNode(Vector2(x, y), [&blocked](Node* node) {
+                blocked = node != nullptr && (node->GetContent<Wall>() != nullptr || node->GetContent<Portal>() != nullptr);
+                });
+
+            SetBlocked(Vector2(x, y), blocked);
+        }
+    }
+}
+
+void PathService::SetBlocked(Vector2 cell, bool blocked)
+{
+    int index = GetIndex(cell);
+    if (index < 0)
+        return;
+
+    uint8_t value = blocked ? 1 : 0;
+    if (_blocked[index].exchange(value) == value)
+        return;
+
+    // Every cached path repairs itself on its next query
+    _cacheMutex.lock();
+    for (auto& entry : _cache)
+    {
+        entry.second->pendingCells.push_back(index);
+    }
+    _cacheMutex.unlock();
+}
+
+bool PathService::IsBlocked(Vector2 cell) const
+{
+    int index = GetIndex(cell);
+    return index < 0 || _blocked[index] != 0;
+}
+
+bool PathService::FindPath(Vector2 start, Vector2 goal, std::vector<Vector2>& path)
+{
+    path.clear();
+
+    int startCell = GetIndex(start);
+    int goalCell = GetIndex(goal);
+    if (startCell < 0 || goalCell < 0)
+        return false;
+
+    std::vector<int> changedCells;
+
+    _cacheMutex.lock();
+    std::shared_ptr<CachedPath> cached = GetCachedPath(startCell, goalCell, start, goal);
+    changedCells.swap(cached->pendingCells);
+    _cacheMutex.unlock();
+
+    cached->pathMutex.lock();
+
+    for (int cell : changedCells)
+    {
+        cached->search->CellChanged(cell);
+    }
+
+    // Unchanged since the last query: the cached path is still the shortest
+    if (!cached->computed || !changedCells.empty())
+    {
+        cached->found = cached->search->Compute(_blocked.get(), cached->path);
+        cached->computed = true;
+    }
+
+    path = cached->path;
+    bool found = cached->found;
+
+    cached->pathMutex.unlock();
+    return found;
+}
+
+// Evicts the least recently used path when the cache is full
+// Its search goes to _freeSearches unless another thread is still using it
+std::shared_ptr<PathService::CachedPath> PathService::GetCachedPath(int startCell, int goalCell, Vector2 start, Vector2 goal)
+{
+    unsigned long long key = ((unsigned long long)startCell << 32) | (unsigned int)goalCell;
+
+    auto it = _cache.find(key);
+    if (it != _cache.end())
+    {
+        it->second->lastUse = ++_useCounter;
+        return it->second;
+    }
+
+    if (_cache.size() >= _cacheCapacity)
+    {
+        auto oldest = _cache.begin();
+        for (auto entry = _cache.begin(); entry != _cache.end(); ++entry)
+        {
+            if (entry->second->lastUse < oldest->second->lastUse)
+                oldest = entry;
+        }
+
+        // Nobody else can take a reference without _cacheMutex
+        // The path lock orders this after the last query that used the search
+        CachedPath* evicted = oldest->second.get();
+        if (oldest->second.use_count() == 1 && evicted->pathMutex.try_lock())
+        {
+            _freeSearches.push_back(std::move(evicted->search));
+            evicted->pathMutex.unlock();
+        }
+
+        _cache.erase(oldest);
+    }
+
+    std::shared_ptr<CachedPath> cached = std::make_shared<CachedPath>();
+
+    if (!_freeSearches.empty())
+    {
+        cached->search = std::move(_freeSearches.back());
+        _freeSearches.pop_back();
+    }
+    else
+    {
+        cached->search.reset(new PathSearch(_size));
+    }
+
+    cached->search->Reset(start, goal);
+    cached->lastUse = ++_useCounter;
+    _cache[key] = cached;
+
+    return cached;
+}
+
+void PathService::FindPaths(const std::vector<PathQuery>& queries, std::vector<PathResult>& results)
+{
+    results.assign(queries.size(), PathResult());
+    if (queries.empty())
+        return;
+
+    Batch batch;
+    batch.queries = &queries;
+    batch.results = &results;
+    batch.next = 0;
+
+    _jobMutex.lock();
+    bool hasWorkers = _running && !_workers.empty();
+    if (hasWorkers)
+        _batches.push_back(&batch);
+    _jobMutex.unlock();
+
+    if (hasWorkers)
+        _jobCondition.notify_all();
+
+    // The caller works on its own batch too
+    RunBatch(&batch);
+
+    // No worker can pick it up from here on
+    _jobMutex.lock();
+    auto it = std::find(_batches.begin(), _batches.end(), &batch);
+    if (it != _batches.end())
+        _batches.erase(it);
+    _jobMutex.unlock();
+
+    std::unique_lock<std::mutex> lock(batch.batchMutex);
+    batch.batchFinished.wait(lock, [&batch]() {
+        return batch.done == batch.queries->size() && batch.activeWorkers == 0;
+        });
+}
+
+void PathService::WorkerLoop()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> jobLock(_jobMutex);
+        _jobCondition.wait(jobLock, [this]() { return !_running || !_batches.empty(); });
+
+        if (!_running)
+            return;
+
+        // Joined while still queued, the caller waits for activeWorkers before returning
+        Batch* batch = _batches.front();
+        batch->batchMutex.lock();
+        batch->activeWorkers++;
+        batch->batchMutex.unlock();
+        jobLock.unlock();
+
+        RunBatch(batch);
+
+        // Every index is taken, stop offering it to the other workers
+        jobLock.lock();
+        auto it = std::find(_batches.begin(), _batches.end(), batch);
+        if (it != _batches.end())
+            _batches.erase(it);
+        jobLock.unlock();
+
+        // Notify with the lock held: once it is released the caller may destroy the batch
+        batch->batchMutex.lock();
+        batch->activeWorkers--;
+        batch->batchFinished.notify_all();
+        batch->batchMutex.unlock();
+    }
+}
+
+void PathService::RunBatch(Batch* batch)
+{
+    size_t count = batch->queries->size();
+
+    while (true)
+    {
+        size_t i = batch->next.fetch_add(1);
+        if (i >= count)
+            break;
+
+        const PathQuery& query = (*batch->queries)[i];
+        PathResult& result = (*batch->results)[i];
+        result.found = FindPath(query.start, query.goal, result.path);
+
+        batch->batchMutex.lock();
+        batch->done++;
+        if (batch->done == count)
+            batch->batchFinished.notify_all();
+        batch->batchMutex.unlock();
+    }
+}
+
+int PathService::GetIndex(Vector2 position) const
+{
+    if (position.X < 0 || position.Y < 0 || position.X >= _size.X || position.Y >= _size.Y)
+        return -1;
+
+    return position.Y * _size.X + position.X;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "../NodeMap/NodeMap.h"
+#include "../NodeMap/Vector2.h"
+#include "../Utils/GameConstants.h"
+#include "PathSearch.h"
+
+// Paths between any two cells of a room (A* / LPA*, see PathSearch), for enemies walking to a target
+//
+// The last PATH_CACHE_CAPACITY paths are cached with their search. SetBlocked() queues the cell
+// in every cached search and the next query of that path repairs it instead of searching again
+// Evicted searches keep their node storage and are reused by the next new pair
+//
+// FindPath() is thread-safe: different paths are searched in parallel, the same path is serialized
+// FindPaths() splits a batch between the worker threads (Start()) and the caller
+// A path reflects the obstacles when its query started, later changes are repaired by the next one
+//
+// Standalone library: nothing in the game uses it yet (enemies chase along the FlowField of their room)
+// and no entity marks its cell. The owner loads the obstacles and calls SetBlocked() itself
+// Tested by Tests/PathServiceTest.cpp, measured by Benchmarks/PathServiceBenchmark.cpp
+class PathService
+{
+public:
+    struct PathQuery
+    {
+        Vector2 start;
+        Vector2 goal;
+    };
+
+    struct PathResult
+    {
+        bool found = false;
+        std::vector<Vector2> path; // The cells after the start up to the goal
+    };
+
+    PathService(NodeMap* map, size_t cacheCapacity = PATH_CACHE_CAPACITY);
+    ~PathService();
+
+    void Start(int workerCount);
+    void Stop();
+
+    // Walls and portals of the NodeMap
+    void LoadObstacles();
+
+    // Walls, portals or entities that should be walked around
+    void SetBlocked(Vector2 cell, bool blocked);
+    bool IsBlocked(Vector2 cell) const;
+
+    // false if the goal cannot be reached (or is blocked)
+    bool FindPath(Vector2 start, Vector2 goal, std::vector<Vector2>& path);
+
+    // Returns when every query has its result, results[i] answers queries[i]
+    void FindPaths(const std::vector<PathQuery>& queries, std::vector<PathResult>& results);
+
+private:
+    struct CachedPath
+    {
+        std::mutex pathMutex; // Held while the path is searched or repaired
+        std::unique_ptr<PathSearch> search;
+        std::vector<int> pendingCells; // Changed since the last query, guarded by _cacheMutex
+        unsigned long long lastUse = 0;
+
+        bool computed = false;
+        bool found = false;
+        std::vector<Vector2> path;
+    };
+
+    // Queries of one FindPaths() call, taken one index at a time by the caller and the workers
+    struct Batch
+    {
+        const std::vector<PathQuery>* queries;
+        std::vector<PathResult>* results;
+        std::atomic<size_t> next;
+
+        std::mutex batchMutex;
+        std::condition_variable batchFinished;
+        size_t done = 0;
+        int activeWorkers = 0;
+    };
+
+    NodeMap* _map;
+    Vector2 _size;
+    std::unique_ptr<std::atomic<uint8_t>[]> _blocked;
+
+    size_t _cacheCapacity;
+    std::map<unsigned long long, std::shared_ptr<CachedPath>> _cache; // Key: start cell << 32 | goal cell
+    std::vector<std::unique_ptr<PathSearch>> _freeSearches;
+    unsigned long long _useCounter;
+    std::mutex _cacheMutex;
+
+    std::vector<std::thread*> _workers;
+    std::atomic<bool> _running;
+    std::deque<Batch*> _batches;
+    std::mutex _jobMutex;
+    std::condition_variable _jobCondition;
+
+    int GetIndex(Vector2 position) const;
+
+    // With _cacheMutex held
+    std::shared_ptr<CachedPath> GetCachedPath(int startCell, int goalCell, Vector2 start, Vector2 goal);
+
+    void WorkerLoop();
+    void RunBatch(Batch* batch);
+};
@@ -6,12 +6,7 @@ Player::~Player() {
 
 void Player::Draw(Vector2 pos)
 {
-    CC::Lock();
-    CC::SetColor(CC::WHITE);
-    CC::SetPosition(pos.X, pos.Y);
-    std::cout << "J";
-    CC::SetColor(CC::WHITE);
-    CC::Unlock();
+    CC::DrawCell(pos.X, pos.Y, 'J', CC::WHITE);
 }
 
 Vector2 Player::GetPosition() {
@@ -63,7 +58,7 @@ void Player::Attack(IDamageable* entity) const {
         entity->ReceiveDamage(20);
 }
 
-void Player::ReceiveDamage(int damageToReceive) {
+bool Player::ReceiveDamage(int damageToReceive) {
     Lock();
     _hp -= damageToReceive;
 
@@ -73,6 +68,7 @@ void Player::ReceiveDamage(int damageToReceive) {
     }
 
     Unlock();
+    return true;
 }
 
 void Player::AddCoin()
@@ -193,25 +189,105 @@ bool Player::IsAlive()
     return alive;
 }
 
-Json::Value Player::Code() {
+Player::Snapshot Player::GetSnapshot() {
+    Lock();
+    Snapshot snapshot = { _position, _hp, _maxHp, _coins, _potionCount, _weapon };
+    Unlock();
+    return snapshot;
+}
+
+Json::Value Player::CodeSnapshot(const Snapshot& snapshot) {
     Json::Value json;
     CodeSubClassType<Player>(json);
-    json["posX"] = _position.X;
-    json["posY"] = _position.Y;
-    json["hp"] = _hp;
-    json["maxHp"] = _maxHp;
-    json["coins"] = _coins;
-    json["potions"] = _potionCount;
-    json["weapon"] = _weapon;
+    json["posX"] = snapshot.position.X;
+    json["posY"] = snapshot.position.Y;
+    json["hp"] = snapshot.hp;
+    json["maxHp"] = snapshot.maxHp;
+    json["coins"] = snapshot.coins;
+    json["potions"] = snapshot.potionCount;
+    json["weapon"] = snapshot.weapon;
     return json;
 }
 
-void Player::Decode(Json::Value json) {
-    _position.X = json["posX"].asInt();
-    _position.Y = json["posY"].asInt();
-    _hp = json["hp"].asInt();
-    _maxHp = json["maxHp"].asInt();
-    _coins = json["coins"].asInt();
-    _potionCount = json["potions"].asInt();
-    _weapon = json["weapon"].asInt();
+Json::Value Player::Code() {
+    return CodeSnapshot(GetSnapshot());
+}
+
+Player::Snapshot Player::DecodeSnapshot(const Json::Value& json) {
+    Snapshot snapshot;
+    snapshot.position = Vector2(json["posX"].asInt(), json["posY"].asInt());
+    snapshot.hp = json["hp"].asInt();
+    snapshot.maxHp = json["maxHp"].asInt();
+    snapshot.coins = json["coins"].asInt();
+    snapshot.potionCount = json["potions"].asInt();
+    snapshot.weapon = json["weapon"].asInt();
+    return snapshot;
+}
+
+void Player::ApplySnapshot(const Snapshot& snapshot) {
+    Lock();
+    _position = snapshot.position;
+    _hp = snapshot.hp;
+    _maxHp = snapshot.maxHp;
+    _coins = snapshot.coins;
+    _potionCount = snapshot.potionCount;
+    _weapon = snapshot.weapon;
+    Unlock();
+}
+
+void Player::Decode(const Json::Value& json) {
+    ApplySnapshot(DecodeSnapshot(json));
+}
+
+// Mismas claves que CodeSnapshot(), sin pasar por Json::Value
+void Player::EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer) {
+    writer.BeginObject();
+    CodeSubClassType<Player>(writer);
+    writer.IntField("posX", snapshot.position.X);
+    writer.IntField("posY", snapshot.position.Y);
+    writer.IntField("hp", snapshot.hp);
+    writer.IntField("maxHp", snapshot.maxHp);
+    writer.IntField("coins", snapshot.coins);
+    writer.IntField("potions", snapshot.potionCount);
+    writer.IntField("weapon", snapshot.weapon);
+    writer.EndObject();
+}
+
+void Player::Encode(CodableWriter& writer) {
+    EncodeSnapshot(GetSnapshot(), writer);
+}
+
+// Las claves desconocidas (y el tipo) se saltan, las que faltan quedan a 0
+bool Player::DecodeSnapshot(CodableReader& reader, Snapshot& snapshot) {
+    snapshot = Snapshot();
+
+    if (!reader.BeginObject())
+        return false;
+
+    std::string key;
+    while (reader.NextKey(key)) {
+        bool read;
+        if (key == "posX") read = reader.ReadInt(snapshot.position.X);
+        else if (key == "posY") read = reader.ReadInt(snapshot.position.Y);
+        else if (key == "hp") read = reader.ReadInt(snapshot.hp);
+        else if (key == "maxHp") read = reader.ReadInt(snapshot.maxHp);
+        else if (key == "coins") read = reader.ReadInt(snapshot.coins);
+        else if (key == "potions") read = reader.ReadInt(snapshot.potionCount);
+        else if (key == "weapon") read = reader.ReadInt(snapshot.weapon);
+        else read = reader.Skip();
+
+        if (!read)
+            return false;
+    }
+
+    return !reader.Failed();
+}
+
+bool Player::Decode(CodableReader& reader) {
+    Snapshot snapshot;
+    if (!DecodeSnapshot(reader, snapshot))
+        return false;
+
+    ApplySnapshot(snapshot);
+    return true;
 }
\ No newline at end of file
@@ -23,6 +23,20 @@ private:
     MessageSystem* _messages;
 
 public:
+    static constexpr uint8_t CODABLE_TYPE_ID = ICodable::CODABLE_PLAYER;
+    static constexpr const char* CODABLE_TYPE_NAME = "Player";
+
+    // Copia de los datos que se guardan, se toma con el mutex del jugador
+    struct Snapshot
+    {
+        Vector2 position;
+        int hp;
+        int maxHp;
+        int coins;
+        int potionCount;
+        int weapon;
+    };
+
     Player(Vector2 startPosition, MessageSystem* messages)
         : _position(startPosition), _hp(50), _maxHp(50), _coins(0),
         _potionCount(1), _weapon(0), _messages(messages)
@@ -46,7 +60,7 @@ public:
     void UpdateActionTime();
     void SetActionCooldown(int milliseconds);
     void Attack(IDamageable* entity) const override;
-    void ReceiveDamage(int damageToReceive) override;
+    bool ReceiveDamage(int damageToReceive) override;
     void AddCoin();
     void AddPotion();
     void ChangeWeapon();
@@ -61,6 +75,15 @@ public:
     void Lock() { _playerMutex.lock(); }
     void Unlock() { _playerMutex.unlock(); }
 
+    Snapshot GetSnapshot();
+    static Json::Value CodeSnapshot(const Snapshot& snapshot);
+    static Snapshot DecodeSnapshot(const Json::Value& json);
+    static void EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer);
+    static bool DecodeSnapshot(CodableReader& reader, Snapshot& snapshot);
+    void ApplySnapshot(const Snapshot& snapshot);
+
     Json::Value Code() override;
-    void Decode(Json::Value json) override;
+    void Decode(const Json::Value& json) override;
+    void Encode(CodableWriter& writer) override;
+    bool Decode(CodableReader& reader) override;
 };
\ No newline at end of file
@@ -14,12 +14,7 @@ public:
     Portal(PortalDir dir) : _direction(dir) {}
 
     void Draw(Vector2 pos) override {
-        CC::Lock();
-        CC::SetColor(CC::LIGHTGREY);
-        CC::SetPosition(pos.X, pos.Y);
-        std::cout << "P";
-        CC::SetColor(CC::WHITE);
-        CC::Unlock();
+        CC::DrawCell(pos.X, pos.Y, 'P', CC::LIGHTGREY);
     }
 
     PortalDir GetDirection() const { return _direction; }
@@ -1,30 +1,74 @@
 #include "Room.h"
+#include <utility>
 
-void Room::RemoveEnemy(Enemy* enemy)
+// Add/Remove keep the occupancy grid in sync with the entity lists and mark the room dirty
+
+EntityHandle Room::AddEnemy(Enemy* enemy)
+{
+    EntityHandle handle = _enemies.Insert(enemy);
+    _store.SetRoomHandle(enemy->GetComponents(), handle);
+    _occupancy->Set<Enemy>(enemy->GetPosition(), handle);
+    MarkDirty();
+    return handle;
+}
+
+EntityHandle Room::AddChest(Chest* chest)
+{
+    EntityHandle handle = _chests.Insert(chest);
+    _occupancy->Set<Chest>(chest->GetPosition(), handle);
+    MarkDirty();
+    return handle;
+}
+
+EntityHandle Room::AddItem(Item* item)
+{
+    EntityHandle handle = _items.Insert(item);
+    _occupancy->Set<Item>(item->GetPosition(), handle);
+    MarkDirty();
+    return handle;
+}
+
+Enemy* Room::RemoveEnemy(EntityHandle handle)
 {
-    auto it = std::find(_enemies.begin(), _enemies.end(), enemy);
-    if (it != _enemies.end())
+    Enemy* enemy = _enemies.Remove(handle);
+    if (enemy != nullptr)
     {
-        _enemies.erase(it);
+        _occupancy->Clear<Enemy>(enemy->GetPosition(), handle);
+        MarkDirty();
     }
+    return enemy;
 }
 
-void Room::RemoveChest(Chest* chest)
+Chest* Room::RemoveChest(EntityHandle handle)
 {
-    auto it = std::find(_chests.begin(), _chests.end(), chest);
-    if (it != _chests.end())
+    Chest* chest = _chests.Remove(handle);
+    if (chest != nullptr)
     {
-        _chests.erase(it);
+        _occupancy->Clear<Chest>(chest->GetPosition(), handle);
+        MarkDirty();
     }
+    return chest;
 }
 
-void Room::RemoveItem(Item* item)
+Item* Room::RemoveItem(EntityHandle handle)
 {
-    auto it = std::find(_items.begin(), _items.end(), item);
-    if (it != _items.end())
+    Item* item = _items.Remove(handle);
+    if (item != nullptr)
     {
-        _items.erase(it);
+        _occupancy->Clear<Item>(item->GetPosition(), handle);
+        MarkDirty();
     }
+    return item;
+}
+
+void Room::DeleteEntities()
+{
+    for (Enemy* enemy : _enemies) _enemyPool.Destroy(enemy);
+    for (Chest* chest : _chests) _chestPool.Destroy(chest);
+    for (Item* item : _items) _itemPool.Destroy(item);
+    _enemies.Clear();
+    _chests.Clear();
+    _items.Clear();
 }
 
 // Places all room entities into the visual map
@@ -203,6 +247,8 @@ void Room::GeneratePortals(int worldX, int worldY, int worldWidth, int worldHeig
             }
             });
     }
+
+    _flowField->MarkObstaclesDirty();
 }
 
 // Calculates where the player should spawn when entering from a portal
@@ -232,64 +278,189 @@ Vector2 Room::GetSpawnPositionFromPortal(PortalDir fromDirection)
     return Vector2(1, 1); // Fallback
 }
 
-Json::Value Room::Code() {
+Room::Snapshot Room::GetSnapshot() {
+    Snapshot snapshot;
+    snapshot.initialized = _initialized;
+
+    snapshot.enemies.reserve(_enemies.Size());
+    for (Enemy* enemy : _enemies) {
+        snapshot.enemies.push_back(enemy->GetSnapshot());
+    }
+
+    snapshot.chests.reserve(_chests.Size());
+    for (Chest* chest : _chests) {
+        snapshot.chests.push_back(chest->GetSnapshot());
+    }
+
+    snapshot.items.reserve(_items.Size());
+    for (Item* item : _items) {
+        snapshot.items.push_back(item->GetSnapshot());
+    }
+
+    return snapshot;
+}
+
+Json::Value Room::CodeSnapshot(const Snapshot& snapshot) {
     Json::Value json;
     CodeSubClassType<Room>(json);
-    json["initialized"] = _initialized;
+    json["initialized"] = snapshot.initialized;
 
     // Guardar enemigos
     Json::Value enemiesJson(Json::arrayValue);
-    for (Enemy* enemy : _enemies) {
-        enemiesJson.append(enemy->Code());
+    for (const Enemy::Snapshot& enemy : snapshot.enemies) {
+        enemiesJson.append(Enemy::CodeSnapshot(enemy));
     }
-    json["enemies"] = enemiesJson;
+    json["enemies"] = std::move(enemiesJson);
 
     // Guardar cofres
     Json::Value chestsJson(Json::arrayValue);
-    for (Chest* chest : _chests) {
-        chestsJson.append(chest->Code());
+    for (const Chest::Snapshot& chest : snapshot.chests) {
+        chestsJson.append(Chest::CodeSnapshot(chest));
     }
-    json["chests"] = chestsJson;
+    json["chests"] = std::move(chestsJson);
 
     // Guardar items
     Json::Value itemsJson(Json::arrayValue);
-    for (Item* item : _items) {
-        itemsJson.append(item->Code());
+    for (const Item::Snapshot& item : snapshot.items) {
+        itemsJson.append(Item::CodeSnapshot(item));
     }
-    json["items"] = itemsJson;
+    json["items"] = std::move(itemsJson);
 
     return json;
 }
 
-void Room::Decode(Json::Value json) {
-    _initialized = json["initialized"].asBool();
+Json::Value Room::Code() {
+    return CodeSnapshot(GetSnapshot());
+}
+
+Room::Snapshot Room::DecodeSnapshot(const Json::Value& json) {
+    Snapshot snapshot;
+    snapshot.initialized = json["initialized"].asBool();
+
+    for (const auto& enemyJson : json["enemies"]) {
+        snapshot.enemies.push_back(Enemy::DecodeSnapshot(enemyJson));
+    }
+
+    for (const auto& chestJson : json["chests"]) {
+        snapshot.chests.push_back(Chest::DecodeSnapshot(chestJson));
+    }
+
+    for (const auto& itemJson : json["items"]) {
+        snapshot.items.push_back(Item::DecodeSnapshot(itemJson));
+    }
+
+    return snapshot;
+}
+
+// Sustituye las entidades de la sala por las del snapshot (JSON o binario)
+void Room::ApplySnapshot(const Snapshot& snapshot) {
+    _initialized = snapshot.initialized;
 
     // Limpiar entidades existentes
-    for (Enemy* enemy : _enemies) delete enemy;
-    for (Chest* chest : _chests) delete chest;
-    for (Item* item : _items) delete item;
-    _enemies.clear();
-    _chests.clear();
-    _items.clear();
+    DeleteEntities();
+    _occupancy->ClearAll();
 
     // Cargar enemigos
-    Json::Value enemiesJson = json["enemies"];
-    for (const auto& enemyJson : enemiesJson) {
-        Enemy* enemy = ICodable::FromJson<Enemy>(enemyJson);
-        _enemies.push_back(enemy);
+    for (const Enemy::Snapshot& enemySnapshot : snapshot.enemies) {
+        Enemy* enemy = CreateEntity<Enemy>();
+        enemy->ApplySnapshot(enemySnapshot);
+        AddEnemy(enemy);
     }
 
     // Cargar cofres
-    Json::Value chestsJson = json["chests"];
-    for (const auto& chestJson : chestsJson) {
-        Chest* chest = ICodable::FromJson<Chest>(chestJson);
-        _chests.push_back(chest);
+    for (const Chest::Snapshot& chestSnapshot : snapshot.chests) {
+        Chest* chest = CreateEntity<Chest>();
+        chest->ApplySnapshot(chestSnapshot);
+        AddChest(chest);
     }
 
     // Cargar items
-    Json::Value itemsJson = json["items"];
-    for (const auto& itemJson : itemsJson) {
-        Item* item = ICodable::FromJson<Item>(itemJson);
-        _items.push_back(item);
+    for (const Item::Snapshot& itemSnapshot : snapshot.items) {
+        Item* item = CreateEntity<Item>();
+        item->ApplySnapshot(itemSnapshot);
+        AddItem(item);
+    }
+}
+
+void Room::Decode(const Json::Value& json) {
+    ApplySnapshot(DecodeSnapshot(json));
+}
+
+void Room::EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer) {
+    writer.BeginObject();
+    CodeSubClassType<Room>(writer);
+    writer.BoolField("initialized", snapshot.initialized);
+
+    writer.Key("enemies");
+    writer.BeginArray();
+    for (const Enemy::Snapshot& enemy : snapshot.enemies) {
+        Enemy::EncodeSnapshot(enemy, writer);
     }
+    writer.EndArray();
+
+    writer.Key("chests");
+    writer.BeginArray();
+    for (const Chest::Snapshot& chest : snapshot.chests) {
+        Chest::EncodeSnapshot(chest, writer);
+    }
+    writer.EndArray();
+
+    writer.Key("items");
+    writer.BeginArray();
+    for (const Item::Snapshot& item : snapshot.items) {
+        Item::EncodeSnapshot(item, writer);
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+}
+
+void Room::Encode(CodableWriter& writer) {
+    EncodeSnapshot(GetSnapshot(), writer);
+}
+
+// Lee un array de entidades con el DecodeSnapshot(reader) de su clase
+template<typename T>
+static bool DecodeSnapshotList(CodableReader& reader, std::vector<T>& list, bool (*decode)(CodableReader&, T&)) {
+    if (!reader.BeginArray())
+        return false;
+
+    while (reader.NextElement()) {
+        list.emplace_back();
+        if (!decode(reader, list.back()))
+            return false;
+    }
+
+    return !reader.Failed();
+}
+
+bool Room::DecodeSnapshot(CodableReader& reader, Snapshot& snapshot) {
+    snapshot = Snapshot();
+
+    if (!reader.BeginObject())
+        return false;
+
+    std::string key;
+    while (reader.NextKey(key)) {
+        bool read;
+        if (key == "initialized") read = reader.ReadBool(snapshot.initialized);
+        else if (key == "enemies") read = DecodeSnapshotList(reader, snapshot.enemies, &Enemy::DecodeSnapshot);
+        else if (key == "chests") read = DecodeSnapshotList(reader, snapshot.chests, &Chest::DecodeSnapshot);
+        else if (key == "items") read = DecodeSnapshotList(reader, snapshot.items, &Item::DecodeSnapshot);
+        else read = reader.Skip();
+
+        if (!read)
+            return false;
+    }
+
+    return !reader.Failed();
+}
+
+bool Room::Decode(CodableReader& reader) {
+    Snapshot snapshot;
+    if (!DecodeSnapshot(reader, snapshot))
+        return false;
+
+    ApplySnapshot(snapshot);
+    return true;
 }
\ No newline at end of file
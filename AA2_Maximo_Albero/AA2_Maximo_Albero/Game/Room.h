@@ -6,26 +6,82 @@
 #include "Enemy.h"
 #include "Chest.h"
 #include "Item.h"
+#include "OccupancyGrid.h"
+#include "EntityStore.h"
+#include "FlowField.h"
+#include "SaveSegment.h"
+#include "../Utils/SlotMap.h"
+#include "../Utils/ObjectPool.h"
+#include "../Utils/GameConstants.h"
 
 #include "../Json/ICodable.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 class Room : public ICodable
 {
 private:
     NodeMap* _map;
+    OccupancyGrid* _occupancy;
+    FlowField* _flowField; // Distancias al jugador, las usan los enemigos para perseguirle
     Vector2 _size;
+    Vector2 _worldPosition; // Posicin en el DungeonMap, la usa el diario de acciones
     bool _initialized;
 
-    std::vector<Enemy*> _enemies;
-    std::vector<Chest*> _chests;
-    std::vector<Item*> _items;
+    // Sube cada vez que cambia algo que se guarda (spawn, movimiento, dao, eliminacin)
+    // El autoguardado solo vuelve a codificar las salas cuya revisin ha cambiado
+    std::atomic<unsigned int> _revision;
+
+    // Sala cargada de forma perezosa: segmento binario an sin decodificar (BinarySaveFormat)
+    // Se decodifica al entrar por primera vez (SaveManager::LoadPendingRoom)
+    SaveSegment _pendingSegment;
+
+    // Estado de las entidades (posicin, vida, dao, cooldown) en arrays, Enemy/Chest/Item son vistas
+    // Declarado antes que los pools: las vistas se quitan de l al destruirse
+    EntityStore _store;
+
+    // Memoria de las entidades, reservada al crear la sala (ROOM_ENTITY_CAPACITY de cada tipo)
+    // Spawns y muertes reciclan huecos en vez de hacer new/delete
+    ObjectPool<Enemy> _enemyPool;
+    ObjectPool<Chest> _chestPool;
+    ObjectPool<Item> _itemPool;
+
+    // Unica lista de las entidades de la sala, la sala es su duea
+    // Fuera de la sala se guardan handles (OccupancyGrid), no punteros
+    SlotMap<Enemy> _enemies;
+    SlotMap<Chest> _chests;
+    SlotMap<Item> _items;
+
+    void DeleteEntities();
+
+    template<typename T>
+    ObjectPool<T>& GetPool();
 
 public:
+    static constexpr uint8_t CODABLE_TYPE_ID = ICodable::CODABLE_ROOM;
+    static constexpr const char* CODABLE_TYPE_NAME = "Room";
+
+    // Copia de las entidades de la sala, el autoguardado la serializa en otro thread
+    struct Snapshot
+    {
+        bool initialized;
+        std::vector<Enemy::Snapshot> enemies;
+        std::vector<Chest::Snapshot> chests;
+        std::vector<Item::Snapshot> items;
+    };
+
     Room() : Room(Vector2(20, 10), Vector2(0, 0)) {}
 
-    Room(Vector2 size, Vector2 offset) : _size(size), _initialized(false)
+    Room(Vector2 size, Vector2 offset) : _size(size), _worldPosition(0, 0), _initialized(false), _revision(0),
+        _enemyPool(ROOM_ENTITY_CAPACITY), _chestPool(ROOM_ENTITY_CAPACITY), _itemPool(ROOM_ENTITY_CAPACITY)
     {
         _map = new NodeMap(size, offset);
+        _occupancy = new OccupancyGrid(size);
+        _flowField = new FlowField(_map);
+        _store.SetFlowField(_flowField);
 
         // Crear paredes en los bordes
         for (int x = 0; x < size.X; x++)
@@ -51,28 +107,55 @@ public:
 
     ~Room()
     {
+        DeleteEntities();
+        delete _occupancy;
+        delete _flowField;
         delete _map;
     }
 
     NodeMap* GetMap() { return _map; }
+    OccupancyGrid* GetOccupancy() { return _occupancy; }
+    EntityStore* GetStore() { return &_store; }
+    FlowField* GetFlowField() { return _flowField; }
     Vector2 GetSize() const { return _size; }
 
+    void SetWorldPosition(Vector2 worldPosition) { _worldPosition = worldPosition; }
+    Vector2 GetWorldPosition() const { return _worldPosition; }
+
     bool IsInitialized() const { return _initialized; }
-    void SetInitialized(bool value) { _initialized = value; }
+    void SetInitialized(bool value) { _initialized = value; MarkDirty(); }
+
+    void MarkDirty() { _revision++; }
+    unsigned int GetRevision() const { return _revision; }
+
+    void SetPendingSegment(const SaveSegment& segment) { _pendingSegment = segment; }
+    SaveSegment GetPendingSegment() const { return _pendingSegment; }
+    bool HasPendingSegment() const { return _pendingSegment != nullptr; }
 
-    void AddEnemy(Enemy* enemy) { _enemies.push_back(enemy); }
-    void AddChest(Chest* chest) { _chests.push_back(chest); }
-    void AddItem(Item* item) { _items.push_back(item); }
+    // Crea la entidad en el pool de la sala, todava sin aadirla (AddEnemy/AddChest/AddItem)
+    template<typename T, typename... Args>
+    T* CreateEntity(Args&&... args) { return GetPool<T>().Create(&_store, std::forward<Args>(args)...); }
+    // En lugar de delete, para entidades ya quitadas de la sala
+    template<typename T>
+    void DestroyEntity(T* entity) { GetPool<T>().Destroy(entity); }
 
-    void RemoveEnemy(Enemy* enemy);
+    EntityHandle AddEnemy(Enemy* enemy);
+    EntityHandle AddChest(Chest* chest);
+    EntityHandle AddItem(Item* item);
 
-    void RemoveChest(Chest* chest);
+    // O(1), devuelven la entidad quitada para que el llamador la destruya (DestroyEntity) (nullptr si el handle ya no es vlido)
+    Enemy* RemoveEnemy(EntityHandle handle);
 
-    void RemoveItem(Item* item);
+    Chest* RemoveChest(EntityHandle handle);
 
-    std::vector<Enemy*>& GetEnemies() { return _enemies; }
-    std::vector<Chest*>& GetChests() { return _chests; }
-    std::vector<Item*>& GetItems() { return _items; }
+    Item* RemoveItem(EntityHandle handle);
+
+    SlotMap<Enemy>& GetEnemies() { return _enemies; }
+    SlotMap<Chest>& GetChests() { return _chests; }
+    SlotMap<Item>& GetItems() { return _items; }
+
+    template<typename T>
+    SlotMap<T>& GetEntities();
 
     void ActivateEntities();
 
@@ -84,7 +167,44 @@ public:
 
     Vector2 GetSpawnPositionFromPortal(PortalDir fromDirection);
 
+    Snapshot GetSnapshot();
+    static Json::Value CodeSnapshot(const Snapshot& snapshot);
+    static Snapshot DecodeSnapshot(const Json::Value& json);
+    static void EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer);
+    static bool DecodeSnapshot(CodableReader& reader, Snapshot& snapshot);
+    void ApplySnapshot(const Snapshot& snapshot);
+
     Json::Value Code() override;
 
-    void Decode(Json::Value json) override;
-};
\ No newline at end of file
+    void Decode(const Json::Value& json) override;
+    void Encode(CodableWriter& writer) override;
+    bool Decode(CodableReader& reader) override;
+};
+
+template<typename T>
+inline SlotMap<T>& Room::GetEntities()
+{
+    if constexpr (std::is_same<T, Enemy>::value)
+        return _enemies;
+    else if constexpr (std::is_same<T, Chest>::value)
+        return _chests;
+    else
+    {
+        static_assert(std::is_same<T, Item>::value, "Room only stores Enemy, Chest and Item");
+        return _items;
+    }
+}
+
+template<typename T>
+inline ObjectPool<T>& Room::GetPool()
+{
+    if constexpr (std::is_same<T, Enemy>::value)
+        return _enemyPool;
+    else if constexpr (std::is_same<T, Chest>::value)
+        return _chestPool;
+    else
+    {
+        static_assert(std::is_same<T, Item>::value, "Room only stores Enemy, Chest and Item");
+        return _itemPool;
+    }
+}
\ No newline at end of file
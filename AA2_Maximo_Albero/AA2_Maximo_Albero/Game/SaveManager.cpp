@@ -1,136 +1,519 @@
 #include "SaveManager.h"
+#include "BinarySaveFormat.h"
+#include "ActionJournal.h"
+#include "../Utils/GameStats.h"
+#include <cstdio>
+#include "../Json/JsonCodableStream.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Sustituye el archivo de guardado por el temporal en un solo paso
+// Si el juego se cierra a mitad de escritura el guardado anterior sigue intacto
+static bool ReplaceSaveFile(const std::string& tempPath, const std::string& savePath)
+{
+#ifdef _WIN32
+    return MoveFileExA(tempPath.c_str(), savePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(tempPath.c_str(), savePath.c_str()) == 0;
+#endif
+}
+
+SaveManager::SaveManager(const std::string& saveFilePath, int autoSaveIntervalSeconds)
+    : _saveFilePath(saveFilePath),
+    _autoSaveIntervalSeconds(autoSaveIntervalSeconds),
+    _saveFormat(SaveFormat::JSON),
+    _timers(nullptr),
+    _autoSaveTimer(0),
+    _isAutoSaving(false),
+    _entityManagerRef(nullptr),
+    _saveThread(nullptr),
+    _hasPendingSave(false),
+    _isSaveThreadStopping(false),
+    _prefetchThread(nullptr),
+    _isPrefetching(false)
+{
+    _journal = new ActionJournal(saveFilePath + ".journal");
+}
+
+SaveManager::~SaveManager()
+{
+    StopAutoSave();
+    StopPrefetch();
+    StopJournal();
+    delete _journal;
+}
 
 // Guarda el estado completo del juego en formato JSON
 // GUARDA:
 //   - Estado del jugador (HP, monedas, pociones, arma, posicin)
 //   - Posicin actual en el mapamundi
 //   - Estado de TODAS las salas inicializadas con sus entidades
-// THREAD-SAFETY: Protegido con _saveMutex manualmente
+// Sin locks del juego: usar solo con el juego parado, el autoguardado usa un SnapshotProvider
 bool SaveManager::SaveGame(DungeonMap* dungeonMap, Player* player)
 {
-    Lock();
+    if (dungeonMap == nullptr || player == nullptr)
+    {
+        std::cerr << "Error: DungeonMap o Player es nullptr" << std::endl;
+        return false;
+    }
 
-    try
+    Snapshot snapshot = TakeSnapshot(dungeonMap, player);
+    snapshot.journalSequence = _journal->GetLastSequence();
+
+    return WriteSnapshot(snapshot);
+}
+
+// Solo copia datos planos (posiciones, vida, inventario), no crea JSON ni toca disco
+// Es lo nico que se hace con el juego pausado
+SaveManager::Snapshot SaveManager::TakeSnapshot(DungeonMap* dungeonMap, Player* player,
+    const RoomRevisions* savedRevisions)
+{
+    Snapshot snapshot;
+
+    snapshot.player = player->GetSnapshot();
+
+    snapshot.currentX = dungeonMap->GetCurrentX();
+    snapshot.currentY = dungeonMap->GetCurrentY();
+    snapshot.worldWidth = dungeonMap->GetWorldWidth();
+    snapshot.worldHeight = dungeonMap->GetWorldHeight();
+
+    // Solo guardar salas que el jugador ha visitado
+    for (int y = 0; y < snapshot.worldHeight; y++)
     {
-        if (dungeonMap == nullptr || player == nullptr)
+        for (int x = 0; x < snapshot.worldWidth; x++)
         {
-            std::cerr << "Error: DungeonMap o Player es nullptr" << std::endl;
-            Unlock();
-            return false;
+            Room* room = dungeonMap->GetRoom(x, y);
+            if (room == nullptr || (!room->IsInitialized() && !room->HasPendingSegment()))
+                continue;
+
+            unsigned int revision = room->GetRevision();
+
+            if (savedRevisions != nullptr)
+            {
+                auto saved = savedRevisions->find(y * snapshot.worldWidth + x);
+                if (saved != savedRevisions->end() && saved->second == revision)
+                    continue;
+            }
+
+            // Sala an sin visitar desde la carga: se guarda su segmento sin decodificar
+            if (room->HasPendingSegment())
+                snapshot.rooms.push_back({ x, y, revision, Room::Snapshot(), room->GetPendingSegment() });
+            else
+                snapshot.rooms.push_back({ x, y, revision, room->GetSnapshot(), SaveSegment() });
         }
+    }
 
-        Json::Value root;
+    return snapshot;
+}
+
+// Mismo documento que generaba Json::StyledWriter, clave a clave
+void SaveManager::EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer)
+{
+    writer.BeginObject();
+
+    // Serializa posicin, HP, inventario, arma equipada del player
+    writer.Key("player");
+    Player::EncodeSnapshot(snapshot.player, writer);
+
+    // Guardar posicin actual en el mundo
+    writer.IntField("currentX", snapshot.currentX);
+    writer.IntField("currentY", snapshot.currentY);
+    writer.IntField("worldWidth", snapshot.worldWidth);
+    writer.IntField("worldHeight", snapshot.worldHeight);
+    writer.IntField("journalSequence", (long long)snapshot.journalSequence);
+
+    // "rooms": { "y": { "x": sala } }, hay que agrupar las salas por fila
+    std::vector<const Snapshot::RoomEntry*> sortedRooms;
+    sortedRooms.reserve(snapshot.rooms.size());
+    for (const Snapshot::RoomEntry& entry : snapshot.rooms)
+    {
+        sortedRooms.push_back(&entry);
+    }
+    std::sort(sortedRooms.begin(), sortedRooms.end(),
+        [](const Snapshot::RoomEntry* a, const Snapshot::RoomEntry* b) {
+            return a->y != b->y ? a->y < b->y : a->x < b->x;
+        });
 
-        // Serializa posicin, HP, inventario, arma equipada del player
-        root["player"] = player->Code();
+    writer.Key("rooms");
+    writer.BeginObject();
 
-        CC::Lock();
-        CC::SetPosition(15, 11);
-        CC::Unlock();
+    bool rowOpen = false;
+    int rowY = 0;
+    Snapshot::RoomEntry decoded;
 
-        // Guardar posicin actual en el mundo
-        root["currentX"] = dungeonMap->GetCurrentX();
-        root["currentY"] = dungeonMap->GetCurrentY();
-        root["worldWidth"] = dungeonMap->GetWorldWidth();
-        root["worldHeight"] = dungeonMap->GetWorldHeight();
+    for (const Snapshot::RoomEntry* entry : sortedRooms)
+    {
+        const Room::Snapshot* room = &entry->room;
 
-        // Solo guardar salas que el jugador ha visitado
-        Json::Value roomsData;
-        for (int y = 0; y < dungeonMap->GetWorldHeight(); y++)
+        // Sala pendiente: se decodifica sola, y se libera al pasar a la siguiente
+        if (entry->segment)
         {
-            for (int x = 0; x < dungeonMap->GetWorldWidth(); x++)
-            {
-                Room* room = dungeonMap->GetRoom(x, y);
-                if (room != nullptr && room->IsInitialized())
-                {
-                    roomsData[std::to_string(y)][std::to_string(x)] = room->Code();
-                }
-            }
+            decoded.segment = entry->segment;
+            if (!BinarySaveFormat::DecodeRoomSegment(decoded))
+                continue;
+            room = &decoded.room;
         }
-        root["rooms"] = roomsData;
 
-        // Escribir al archivo JSON
-        std::ofstream file(_saveFilePath);
-        if (!file.is_open())
+        if (!rowOpen || entry->y != rowY)
         {
-            std::cerr << "Error: No se pudo abrir el archivo para guardar: " << _saveFilePath << std::endl;
-            Unlock();
-            return false;
+            if (rowOpen)
+                writer.EndObject();
+
+            rowY = entry->y;
+            rowOpen = true;
+            writer.Key(std::to_string(rowY).c_str());
+            writer.BeginObject();
         }
 
-        Json::StyledWriter writer;
-        file << writer.write(root);
-        file.close();
+        writer.Key(std::to_string(entry->x).c_str());
+        Room::EncodeSnapshot(*room, writer);
+    }
 
-        Unlock();
-        return true;
+    if (rowOpen)
+        writer.EndObject();
+
+    writer.EndObject();
+    writer.EndObject();
+}
+
+// ndice de sala ("0", "12"...), false si la clave no es un nmero
+static bool ParseRoomKey(const std::string& key, int& value)
+{
+    if (key.empty())
+        return false;
+
+    char* end = nullptr;
+    long parsed = std::strtol(key.c_str(), &end, 10);
+    if (*end != '\0')
+        return false;
+
+    value = (int)parsed;
+    return true;
+}
+
+static bool DecodeRooms(CodableReader& reader, std::vector<SaveManager::Snapshot::RoomEntry>& rooms)
+{
+    if (!reader.BeginObject())
+        return false;
+
+    std::string yKey;
+    std::string xKey;
+
+    while (reader.NextKey(yKey))
+    {
+        int y;
+        if (!ParseRoomKey(yKey, y))
+        {
+            if (!reader.Skip())
+                return false;
+            continue;
+        }
+
+        if (!reader.BeginObject())
+            return false;
+
+        while (reader.NextKey(xKey))
+        {
+            int x;
+            if (!ParseRoomKey(xKey, x))
+            {
+                if (!reader.Skip())
+                    return false;
+                continue;
+            }
+
+            rooms.push_back({ x, y, 0, Room::Snapshot(), SaveSegment() });
+            if (!Room::DecodeSnapshot(reader, rooms.back().room))
+                return false;
+        }
     }
-    catch (const Json::Exception& e)
+
+    return !reader.Failed();
+}
+
+bool SaveManager::DecodeSnapshot(CodableReader& reader, Snapshot& snapshot)
+{
+    snapshot = Snapshot();
+
+    if (!reader.BeginObject())
+        return false;
+
+    std::string key;
+    while (reader.NextKey(key))
     {
-        std::cerr << "Error JSON al guardar: " << e.what() << std::endl;
-        Unlock();
+        bool read;
+
+        if (key == "player")
+        {
+            read = Player::DecodeSnapshot(reader, snapshot.player);
+        }
+        else if (key == "currentX") read = reader.ReadInt(snapshot.currentX);
+        else if (key == "currentY") read = reader.ReadInt(snapshot.currentY);
+        else if (key == "worldWidth") read = reader.ReadInt(snapshot.worldWidth);
+        else if (key == "worldHeight") read = reader.ReadInt(snapshot.worldHeight);
+        else if (key == "journalSequence")
+        {
+            // Guardados anteriores al diario no lo tienen: se queda a 0, todos sus registros son ms nuevos
+            long long sequence = 0;
+            read = reader.ReadInt64(sequence);
+            snapshot.journalSequence = (uint64_t)sequence;
+        }
+        else if (key == "rooms")
+        {
+            read = DecodeRooms(reader, snapshot.rooms);
+        }
+        else
+        {
+            read = reader.Skip();
+        }
+
+        if (!read)
+            return false;
+    }
+
+    if (reader.Failed())
         return false;
+
+    // Las dimensiones pueden venir despus de las salas, se filtran al final
+    int width = snapshot.worldWidth;
+    int height = snapshot.worldHeight;
+    snapshot.rooms.erase(std::remove_if(snapshot.rooms.begin(), snapshot.rooms.end(),
+        [width, height](const Snapshot::RoomEntry& entry) {
+            return entry.x < 0 || entry.x >= width || entry.y < 0 || entry.y >= height;
+        }), snapshot.rooms.end());
+
+    std::sort(snapshot.rooms.begin(), snapshot.rooms.end(),
+        [](const Snapshot::RoomEntry& a, const Snapshot::RoomEntry& b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        });
+
+    return true;
+}
+
+// THREAD-SAFETY: Protegido con _saveMutex manualmente
+bool SaveManager::WriteSnapshot(const Snapshot& snapshot)
+{
+    Lock();
+    bool saved = WriteSnapshotFile(_saveFilePath, snapshot, _saveFormat);
+    Unlock();
+
+    return saved;
+}
+
+bool SaveManager::WriteSnapshotFile(const std::string& path, const Snapshot& snapshot, SaveFormat format)
+{
+    try
+    {
+        // Se escribe directamente en el archivo temporal, el guardado nunca est entero en memoria
+        return WriteFileAtomically(path, [&snapshot, format](std::ostream& output) {
+            if (format == SaveFormat::BINARY)
+            {
+                BinarySaveFormat::Write(snapshot, output);
+            }
+            else
+            {
+                JsonCodableWriter writer(output);
+                EncodeSnapshot(snapshot, writer);
+            }
+
+            return true;
+        });
     }
     catch (const std::exception& e)
     {
         std::cerr << "Error al guardar la partida: " << e.what() << std::endl;
-        Unlock();
         return false;
     }
     catch (...)
     {
         std::cerr << "Error desconocido al guardar la partida" << std::endl;
-        Unlock();
         return false;
     }
 }
 
+bool SaveManager::WriteFileAtomically(const std::string& path, const std::string& data)
+{
+    return WriteFileAtomically(path, [&data](std::ostream& output) {
+        output.write(data.c_str(), data.size());
+        return true;
+    });
+}
+
+bool SaveManager::WriteFileAtomically(const std::string& path, const std::function<bool(std::ostream&)>& writeContents)
+{
+    // Escribir a un temporal y sustituir el guardado al final
+    std::string tempPath = path + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: No se pudo abrir el archivo para guardar: " << tempPath << std::endl;
+        return false;
+    }
+
+    bool written = writeContents(file);
+    file.close();
+
+    if (!written)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    if (file.fail() || !ReplaceSaveFile(tempPath, path))
+    {
+        std::cerr << "Error: No se pudo reemplazar el archivo de guardado: " << path << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+// Solo codifica las salas del snapshot (las que han cambiado) y el jugador
+// El resto del archivo sale de los segmentos ya codificados en autoguardados anteriores
+bool SaveManager::WriteIncremental(const Snapshot& snapshot)
+{
+    Lock();
+
+    for (const Snapshot::RoomEntry& entry : snapshot.rooms)
+    {
+        std::string& segment = _roomSegments[entry.y * snapshot.worldWidth + entry.x];
+        segment.clear();
+        BinarySaveFormat::WriteRoomSegment(entry, segment);
+    }
+
+    // Cabecera y segmentos van directamente al archivo, sin concatenarlos antes
+    bool saved = WriteFileAtomically(_saveFilePath, [this, &snapshot](std::ostream& output) {
+        std::string header;
+        BinarySaveFormat::WriteHeader(snapshot, (uint32_t)_roomSegments.size(), header);
+        output.write(header.c_str(), header.size());
+
+        for (const auto& segment : _roomSegments)
+        {
+            output.write(segment.second.c_str(), segment.second.size());
+        }
+
+        return true;
+    });
+
+    // Si falla, las salas siguen con otra revisin y se vuelven a codificar la prxima vez
+    if (saved)
+    {
+        _revisionsMutex.lock();
+        for (const Snapshot::RoomEntry& entry : snapshot.rooms)
+        {
+            _savedRevisions[entry.y * snapshot.worldWidth + entry.x] = entry.revision;
+        }
+        _revisionsMutex.unlock();
+    }
+
+    Unlock();
+    return saved;
+}
+
+// Lee un guardado en cualquiera de los dos formatos
+// El binario empieza por "AA2B", cualquier otra cosa se intenta leer como JSON
+bool SaveManager::ReadSnapshotFile(const std::string& path, Snapshot& snapshot, bool lazyRooms)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: No se pudo abrir el archivo de guardado: " << path << std::endl;
+        return false;
+    }
+
+    // Se lee de una vez al tamao exacto, sin pasar por un stringstream
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    // Un solo bloque para todo el archivo, las salas pendientes apuntan dentro de l
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>(fileSize > 0 ? (size_t)fileSize : 0, '\0');
+    file.read(&(*buffer)[0], buffer->size());
+    file.close();
+
+    const std::string& data = *buffer;
+
+    if (BinarySaveFormat::IsBinary(data))
+    {
+        if (!BinarySaveFormat::Read(buffer, snapshot, lazyRooms))
+        {
+            std::cerr << "Error: Guardado binario corrupto o de una versin ms nueva: " << path << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Parsear JSON
+    JsonCodableReader reader(data.c_str(), data.size());
+
+    if (!DecodeSnapshot(reader, snapshot))
+    {
+        std::cerr << "Error al parsear JSON: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool SaveManager::ConvertJsonToBinary(const std::string& jsonPath, const std::string& binaryPath)
+{
+    Snapshot snapshot;
+
+    if (!ReadSnapshotFile(jsonPath, snapshot))
+        return false;
+
+    return WriteSnapshotFile(binaryPath, snapshot, SaveFormat::BINARY);
+}
+
 // Carga una partida guardada y reconstruye el estado completo
 // PROCESO:
-//   1. Leer archivo JSON
+//   1. Leer archivo (JSON o binario) a un Snapshot
+//   1b. Reaplicar el diario de acciones posterior al guardado
 //   2. Reconstruir jugador con todos sus stats
 //   3. Reconstruir todas las salas con sus entidades
-//   4. Registrar entidades en EntityManager
-//   5. Establecer sala activa correcta
+//      En binario solo la sala activa, el resto se decodifica al entrar (LoadPendingRoom)
+//      Las entidades son de la sala, no hay que registrarlas en ningn otro sitio
+//   4. Establecer sala activa correcta
 // THREAD-SAFETY: Protegido con _saveMutex manualmente
 // IMPORTANTE: Se llama ANTES de iniciar threads, no hay race conditions
-bool SaveManager::LoadGame(DungeonMap* dungeonMap, Player* player, EntityManager* entityManager)
+bool SaveManager::LoadGame(DungeonMap* dungeonMap, Player* player)
 {
     Lock();
 
     try
     {
-        if (dungeonMap == nullptr || player == nullptr || entityManager == nullptr)
+        if (dungeonMap == nullptr || player == nullptr)
         {
-            std::cerr << "Error: DungeonMap, Player o EntityManager es nullptr" << std::endl;
+            std::cerr << "Error: DungeonMap o Player es nullptr" << std::endl;
             Unlock();
             return false;
         }
 
-        // Abrir archivo
-        std::ifstream file(_saveFilePath);
-        if (!file.is_open())
+        Snapshot snapshot;
+        if (!ReadSnapshotFile(_saveFilePath, snapshot, true))
         {
-            std::cerr << "Error: No se pudo abrir el archivo de guardado: " << _saveFilePath << std::endl;
             Unlock();
             return false;
         }
 
-        // Parsear JSON
-        Json::Value root;
-        Json::Reader reader;
-
-        if (!reader.parse(file, root))
+        // Verificar que las dimensiones coincidan
+        if (snapshot.worldWidth != dungeonMap->GetWorldWidth() ||
+            snapshot.worldHeight != dungeonMap->GetWorldHeight())
         {
-            std::cerr << "Error al parsear JSON: " << reader.getFormattedErrorMessages() << std::endl;
-            file.close();
+            std::cout << "Error: Las dimensiones del mundo guardado no coinciden" << std::endl;
             Unlock();
             return false;
         }
-        file.close();
+
+        // Lo jugado desde el ltimo checkpoint (si el juego se cerr sin guardar)
+        int replayed = _journal->Replay(snapshot);
+        if (replayed > 0)
+            std::cout << "Diario: " << replayed << " acciones recuperadas" << std::endl;
 
         // Cargar jugador
-        player->Decode(root["player"]);
+        player->ApplySnapshot(snapshot.player);
 
         int xOffset = 15;
         int y = 10;
@@ -139,60 +522,44 @@ bool SaveManager::LoadGame(DungeonMap* dungeonMap, Player* player, EntityManager
         CC::SetPosition(xOffset, y++);
         CC::Unlock();
 
-        // Cargar posicin del mundo
-        int currentX = root["currentX"].asInt();
-        int currentY = root["currentY"].asInt();
-        int worldWidth = root["worldWidth"].asInt();
-        int worldHeight = root["worldHeight"].asInt();
-
-        // Verificar que las dimensiones coincidan
-        if (worldWidth != dungeonMap->GetWorldWidth() ||
-            worldHeight != dungeonMap->GetWorldHeight())
+        // Cargar las salas guardadas
+        for (const Snapshot::RoomEntry& entry : snapshot.rooms)
         {
-            std::cout << "Error: Las dimensiones del mundo guardado no coinciden" << std::endl;
-            Unlock();
-            return false;
+            Room* room = dungeonMap->GetRoom(entry.x, entry.y);
+            if (room == nullptr)
+                continue;
+
+            if (entry.segment != nullptr)
+            {
+                room->SetPendingSegment(entry.segment);
+                continue;
+            }
+
+            room->ApplySnapshot(entry.room);
         }
 
-        // Cargar todas las salas
-        Json::Value roomsData = root["rooms"];
-        for (int y = 0; y < worldHeight; y++)
+        // Regenerar portales basndose en la posicin del mundo
+        for (int y = 0; y < snapshot.worldHeight; y++)
         {
-            for (int x = 0; x < worldWidth; x++)
+            for (int x = 0; x < snapshot.worldWidth; x++)
             {
-                std::string yKey = std::to_string(y);
-                std::string xKey = std::to_string(x);
-
                 Room* room = dungeonMap->GetRoom(x, y);
-                if (room == nullptr)
-                    continue;
-
-                if (roomsData.isMember(yKey) && roomsData[yKey].isMember(xKey))
-                {
-                    room->Decode(roomsData[yKey][xKey]);
-
-                    // Registrar todas las entidades en el EntityManager
-                    entityManager->RegisterLoadedEntities(room);
-                }
-
-                // Regenerar portales basndose en la posicin del mundo
-                room->GeneratePortals(x, y, worldWidth, worldHeight);
+                if (room != nullptr)
+                    room->GeneratePortals(x, y, snapshot.worldWidth, snapshot.worldHeight);
             }
         }
 
         // Establecer la sala activa
-        dungeonMap->SetActiveRoom(currentX, currentY);
+        dungeonMap->SetActiveRoom(snapshot.currentX, snapshot.currentY);
+
+        // La primera sala se necesita ya para dibujar, las vecinas se preparan en segundo plano
+        LoadPendingRoom(dungeonMap->GetActiveRoom());
+        PrefetchNeighbours(dungeonMap, snapshot.currentX, snapshot.currentY);
 
         std::cout << "Partida cargada exitosamente desde: " << _saveFilePath << std::endl;
         Unlock();
         return true;
     }
-    catch (const Json::Exception& e)
-    {
-        std::cerr << "Error JSON al cargar: " << e.what() << std::endl;
-        Unlock();
-        return false;
-    }
     catch (const std::exception& e)
     {
         std::cerr << "Error al cargar la partida: " << e.what() << std::endl;
@@ -207,11 +574,11 @@ bool SaveManager::LoadGame(DungeonMap* dungeonMap, Player* player, EntityManager
     }
 }
 
-//Loop que ejecuta autoguardado cada X segundos en thread separado
-// EJECUCIN: Thread independiente iniciado por StartAutoSave()
-// Guarda cada 5 segundos por defecto
-// THREAD-SAFETY: SaveGame() ya tiene su propio mutex interno
-void SaveManager::StartAutoSave(DungeonMap* dungeonMap, Player* player, EntityManager* entityManager)
+//Programa AutoSaveTick() en el TimerWheel y arranca el thread que escribe los guardados
+// Guarda nada ms empezar (primer checkpoint) y luego cada _autoSaveIntervalSeconds
+// THREAD-SAFETY: snapshotProvider toma los locks del juego, WriteSnapshot() tiene su propio mutex
+void SaveManager::StartAutoSave(TimerWheel* timers, DungeonMap* dungeonMap, Player* player, EntityManager* entityManager,
+    SnapshotProvider snapshotProvider)
 {
     if (_isAutoSaving)
         return;
@@ -219,9 +586,19 @@ void SaveManager::StartAutoSave(DungeonMap* dungeonMap, Player* player, EntityMa
     _dungeonMapRef = dungeonMap;
     _playerRef = player;
     _entityManagerRef = entityManager;
+    _snapshotProvider = snapshotProvider;
+
+    // El primer autoguardado siempre escribe todas las salas
+    _savedRevisions.clear();
+    _roomSegments.clear();
     _isAutoSaving = true;
 
-    _autoSaveThread = new std::thread(&SaveManager::AutoSaveLoop, this);
+    _isSaveThreadStopping = false;
+    _saveThread = new std::thread(&SaveManager::SaveLoop, this);
+
+    // El primer checkpoint no espera, hasta entonces no hay nada sobre lo que reaplicar el diario
+    _timers = timers;
+    _autoSaveTimer = _timers->Schedule([this]() { AutoSaveTick(); }, _autoSaveIntervalSeconds * 1000, 0);
 
     CC::Lock();
     CC::SetPosition(MAP_WIDTH, 10);
@@ -244,51 +621,250 @@ void SaveManager::StopAutoSave()
 
     _isAutoSaving = false;
 
-    if (_autoSaveThread != nullptr)
+    // Si hay una copia en curso, espera a que termine
+    _timers->Cancel(_autoSaveTimer);
+    _autoSaveTimer = 0;
+
+    // El thread de guardado escribe lo que quede pendiente y sale
+    _saveQueueMutex.lock();
+    _isSaveThreadStopping = true;
+    _saveQueueMutex.unlock();
+    _saveQueueCondition.notify_all();
+
+    if (_saveThread != nullptr)
     {
-        if (_autoSaveThread->joinable())
-            _autoSaveThread->join();
+        if (_saveThread->joinable())
+            _saveThread->join();
 
-        delete _autoSaveThread;
-        _autoSaveThread = nullptr;
+        delete _saveThread;
+        _saveThread = nullptr;
     }
 
     std::cout << "Sistema de autoguardado detenido" << std::endl;
 }
 
-void SaveManager::AutoSaveLoop()
+bool SaveManager::LoadPendingRoom(Room* room)
 {
-    while (_isAutoSaving)
+    if (room == nullptr || !room->HasPendingSegment())
+        return false;
+
+    Snapshot::RoomEntry entry;
+    entry.segment = room->GetPendingSegment();
+
+    // Si el prefetch ya la ha decodificado se aprovecha
+    bool prefetched = false;
+    _prefetchMutex.lock();
+    auto it = _prefetchedRooms.find(room);
+    if (it != _prefetchedRooms.end())
     {
-        // Esperar el intervalo de guardado
-        for (int i = 0; i < _autoSaveIntervalSeconds * 10 && _isAutoSaving; i++)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        entry.room = std::move(it->second);
+        entry.segment = nullptr;
+        _prefetchedRooms.erase(it);
+        prefetched = true;
+    }
+    _prefetchMutex.unlock();
+
+    if (!prefetched && !BinarySaveFormat::DecodeRoomSegment(entry))
+    {
+        std::cerr << "Error: Sala corrupta en el guardado, se generar de nuevo" << std::endl;
+        entry.room = Room::Snapshot();
+        entry.room.initialized = false;
+    }
+
+    room->SetPendingSegment(nullptr);
+    room->ApplySnapshot(entry.room);
+
+    return true;
+}
 
-        if (!_isAutoSaving)
+void SaveManager::PrefetchNeighbours(DungeonMap* dungeonMap, int x, int y)
+{
+    const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+    _prefetchMutex.lock();
+
+    for (const auto& offset : offsets)
+    {
+        Room* room = dungeonMap->GetRoom(x + offset[0], y + offset[1]);
+        if (room == nullptr || !room->HasPendingSegment() || _prefetchedRooms.count(room) > 0)
+            continue;
+
+        _prefetchQueue.push_back({ room, room->GetPendingSegment() });
+    }
+
+    bool hasWork = !_prefetchQueue.empty();
+
+    // El thread solo se crea si alguna vez hay salas pendientes (partida cargada de un binario)
+    if (hasWork && _prefetchThread == nullptr)
+    {
+        _isPrefetching = true;
+        _prefetchThread = new std::thread(&SaveManager::PrefetchLoop, this);
+    }
+
+    _prefetchMutex.unlock();
+
+    if (hasWork)
+        _prefetchCondition.notify_all();
+}
+
+void SaveManager::StopPrefetch()
+{
+    _prefetchMutex.lock();
+    _isPrefetching = false;
+    _prefetchMutex.unlock();
+    _prefetchCondition.notify_all();
+
+    if (_prefetchThread != nullptr)
+    {
+        if (_prefetchThread->joinable())
+            _prefetchThread->join();
+
+        delete _prefetchThread;
+        _prefetchThread = nullptr;
+    }
+}
+
+// Decodifica sin tocar la sala: la aplica LoadPendingRoom() con el lock del juego
+void SaveManager::PrefetchLoop()
+{
+    std::unique_lock<std::mutex> lock(_prefetchMutex);
+
+    while (_isPrefetching)
+    {
+        _prefetchCondition.wait(lock, [this]() { return !_isPrefetching || !_prefetchQueue.empty(); });
+
+        if (!_isPrefetching)
             break;
 
-        // NUEVO: Verificar que las referencias sigan siendo vlidas
-        if (_dungeonMapRef == nullptr || _playerRef == nullptr)
-        {
+        auto job = _prefetchQueue.front();
+        _prefetchQueue.pop_front();
+        lock.unlock();
+
+        Snapshot::RoomEntry entry;
+        entry.segment = job.second;
+        bool decoded = BinarySaveFormat::DecodeRoomSegment(entry);
+
+        lock.lock();
+        if (decoded)
+            _prefetchedRooms[job.first] = std::move(entry.room);
+    }
+}
+
+bool SaveManager::StartJournal(bool discardExisting)
+{
+    return _journal->Open(discardExisting);
+}
+
+void SaveManager::StopJournal()
+{
+    _journal->Close();
+}
+
+// Un autoguardado, lo ejecuta el thread del TimerWheel
+// Solo copia el estado: serializar, escribir y compactar el diario lo hace SaveLoop()
+void SaveManager::AutoSaveTick()
+{
+    if (!_isAutoSaving)
+        return;
+
+    // NUEVO: Verificar que las referencias sigan siendo vlidas
+    if (_dungeonMapRef == nullptr || _playerRef == nullptr)
+    {
+        return;
+    }
+
+    // Fase 1: copia del estado con el juego pausado (lo nico que nota el gameplay)
+    PendingSave save;
+    save.start = std::chrono::steady_clock::now();
+
+    // En binario solo se copian las salas que han cambiado desde el ltimo guardado
+    save.incremental = _saveFormat == SaveFormat::BINARY;
+
+    // Copia de las revisiones, el thread de guardado las actualiza mientras tanto
+    RoomRevisions savedRevisions;
+    if (save.incremental)
+    {
+        _revisionsMutex.lock();
+        savedRevisions = _savedRevisions;
+        _revisionsMutex.unlock();
+    }
+
+    const RoomRevisions* revisions = save.incremental ? &savedRevisions : nullptr;
+
+    if (_snapshotProvider)
+    {
+        save.snapshot = _snapshotProvider(revisions);
+    }
+    else
+    {
+        save.snapshot = TakeSnapshot(_dungeonMapRef, _playerRef, revisions);
+        save.snapshot.journalSequence = _journal->GetLastSequence();
+    }
+
+    save.stallMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - save.start).count();
+
+    // Si el anterior an no se ha escrito se sustituye: este tiene todas sus salas
+    // (se compar con las mismas revisiones guardadas) y un estado ms reciente
+    _saveQueueMutex.lock();
+    _pendingSave = std::move(save);
+    _hasPendingSave = true;
+    _saveQueueMutex.unlock();
+    _saveQueueCondition.notify_all();
+}
+
+// Fase 2: JSON o binario y disco, sin ningn lock del juego ni del TimerWheel
+// Al parar termina el guardado pendiente antes de salir
+void SaveManager::SaveLoop()
+{
+    std::unique_lock<std::mutex> lock(_saveQueueMutex);
+
+    while (true)
+    {
+        _saveQueueCondition.wait(lock, [this]() { return _isSaveThreadStopping || _hasPendingSave; });
+
+        if (!_hasPendingSave)
             break;
-        }
 
-        // Realizar guardado automtico
-        if (SaveGame(_dungeonMapRef, _playerRef))
-        {
-            CC::Lock();
-            CC::SetPosition(MAP_WIDTH, 11);
-            std::cout << "[AutoSave] Partida guardada" << std::endl;
-            CC::Unlock();
-        }
-        else
-        {
-            CC::Lock();
-            CC::SetPosition(MAP_WIDTH, 11);
-            std::cerr << "[AutoSave] Error al guardar" << std::endl;
-            CC::Unlock();
-        }
+        PendingSave save = std::move(_pendingSave);
+        _hasPendingSave = false;
+        lock.unlock();
+
+        WritePendingSave(save);
+
+        lock.lock();
     }
-}
\ No newline at end of file
+}
+
+void SaveManager::WritePendingSave(PendingSave& save)
+{
+    const Snapshot& snapshot = save.snapshot;
+    bool saved = save.incremental ? WriteIncremental(snapshot) : WriteSnapshot(snapshot);
+
+    // Lo que ya est en el checkpoint sobra en el diario
+    if (saved)
+        _journal->Compact(snapshot.journalSequence);
+
+    long long totalMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - save.start).count();
+
+    GameStats::AddTiming(GameStats::AUTOSAVE_STALL, save.stallMicroseconds);
+    GameStats::AddTiming(GameStats::AUTOSAVE_TOTAL, totalMicroseconds);
+    GameStats::Add(GameStats::SAVED_ROOMS, (long long)snapshot.rooms.size());
+
+    if (saved)
+    {
+        CC::Lock();
+        CC::SetPosition(MAP_WIDTH, 11);
+        std::cout << "[AutoSave] Partida guardada (" << snapshot.rooms.size() << " salas, pausa "
+            << save.stallMicroseconds << " us, total " << totalMicroseconds / 1000 << " ms)" << std::endl;
+        CC::Unlock();
+    }
+    else
+    {
+        CC::Lock();
+        CC::SetPosition(MAP_WIDTH, 11);
+        std::cerr << "[AutoSave] Error al guardar" << std::endl;
+        CC::Unlock();
+    }
+}
@@ -6,34 +6,117 @@
 #include <atomic>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
 #include "../dist/json/json.h"
+#include "../Json/CodableStream.h"
 #include "DungeonMap.h"
 #include "Player.h"
 #include "../Utils/GameConstants.h"
+#include "../Utils/TimerWheel.h"
 
 #include "EntityManager.h"
 
+class ActionJournal;
+
+// JSON: legible, el formato original. BINARY: compacto y rapido de leer (BinarySaveFormat)
+enum class SaveFormat
+{
+    JSON,
+    BINARY
+};
+
 class SaveManager
 {
 public:
-    SaveManager(const std::string& saveFilePath = "savegame.json", int autoSaveIntervalSeconds = 10)
-        : _saveFilePath(saveFilePath),
-        _autoSaveIntervalSeconds(autoSaveIntervalSeconds),
-        _autoSaveThread(nullptr),
-        _isAutoSaving(false),
-        _entityManagerRef(nullptr) {
-    }
-
-    ~SaveManager() {
-        StopAutoSave();
-    }
+    // Estado copiado con el juego pausado un instante, se serializa sin bloquear el gameplay
+    struct Snapshot
+    {
+        struct RoomEntry
+        {
+            int x;
+            int y;
+            unsigned int revision;
+            Room::Snapshot room;
+
+            // Carga perezosa: la sala sigue codificada en binario y room est vaco
+            // Se copia tal cual al guardar en binario, BinarySaveFormat::DecodeRoomSegment() la decodifica
+            SaveSegment segment;
+        };
+
+        Player::Snapshot player;
+        int currentX;
+        int currentY;
+        int worldWidth;
+        int worldHeight;
+        std::vector<RoomEntry> rooms;
+
+        // ltimo registro del diario incluido, LoadGame() reaplica solo los posteriores
+        uint64_t journalSequence = 0;
+    };
+
+    // Revisin guardada de cada sala, clave y * worldWidth + x
+    typedef std::map<int, unsigned int> RoomRevisions;
+
+    // Devuelve un Snapshot tomado con los locks del juego (lo da Game)
+    // Si recibe revisiones, solo copia las salas que han cambiado desde entonces
+    typedef std::function<Snapshot(const RoomRevisions*)> SnapshotProvider;
+
+    // Cada autoguardado es un checkpoint, entre dos checkpoints los cambios van al diario (<saveFilePath>.journal)
+    SaveManager(const std::string& saveFilePath = "savegame.json", int autoSaveIntervalSeconds = 10);
+    ~SaveManager();
 
     bool SaveGame(DungeonMap* dungeonMap, Player* player);
-    bool LoadGame(DungeonMap* dungeonMap, Player* player, EntityManager* entityManager);
+
+    // Copia el estado, el llamador debe impedir que cambie mientras tanto
+    // Con savedRevisions se omiten las salas que no han cambiado (snapshot parcial)
+    static Snapshot TakeSnapshot(DungeonMap* dungeonMap, Player* player,
+        const RoomRevisions* savedRevisions = nullptr);
+    // Serializa y escribe a un archivo temporal que luego sustituye al guardado
+    bool WriteSnapshot(const Snapshot& snapshot);
+
+    // Formato JSON de siempre, escrito y ledo en streaming sin construir un Json::Value
+    // Las salas pendientes (carga perezosa) se decodifican de una en una al escribirlas
+    static void EncodeSnapshot(const Snapshot& snapshot, CodableWriter& writer);
+    static bool DecodeSnapshot(CodableReader& reader, Snapshot& snapshot);
+
+    static bool WriteSnapshotFile(const std::string& path, const Snapshot& snapshot, SaveFormat format);
+    // Escribe a un archivo temporal que luego sustituye a path
+    static bool WriteFileAtomically(const std::string& path, const std::string& data);
+    // writeContents escribe directamente en el temporal, false cancela el guardado
+    static bool WriteFileAtomically(const std::string& path, const std::function<bool(std::ostream&)>& writeContents);
+    // Detecta el formato del archivo (JSON o binario)
+    // Con lazyRooms las salas de un binario solo se indexan, quedan en RoomEntry::segment
+    static bool ReadSnapshotFile(const std::string& path, Snapshot& snapshot, bool lazyRooms = false);
+
+    static bool ConvertJsonToBinary(const std::string& jsonPath, const std::string& binaryPath);
+
+    // Formato de los siguientes guardados, la carga lo detecta sola
+    void SetSaveFormat(SaveFormat format) { _saveFormat = format; }
+    SaveFormat GetSaveFormat() const { return _saveFormat; }
+    bool LoadGame(DungeonMap* dungeonMap, Player* player);
+
+    // Decodifica una sala cargada de forma perezosa la primera vez que se entra
+    // Llamar con el lock del juego, antes de activar sus entidades. false si no estaba pendiente
+    bool LoadPendingRoom(Room* room);
+    // Decodifica en segundo plano las salas vecinas que siguen pendientes
+    void PrefetchNeighbours(DungeonMap* dungeonMap, int x, int y);
+    void StopPrefetch();
 
     bool SaveFileExists();
 
-    void StartAutoSave(DungeonMap* dungeonMap, Player* player, EntityManager* entityManager);
+    // Abre el diario de acciones, en una partida nueva se descartan los registros anteriores
+    bool StartJournal(bool discardExisting);
+    void StopJournal();
+    ActionJournal* GetJournal() { return _journal; }
+
+    // El autoguardado es un trabajo de timers: un checkpoint al empezar y luego cada intervalo
+    void StartAutoSave(TimerWheel* timers, DungeonMap* dungeonMap, Player* player, EntityManager* entityManager,
+        SnapshotProvider snapshotProvider = nullptr);
     void StopAutoSave();
 
     void Lock() { _saveMutex.lock(); }
@@ -42,14 +125,59 @@ public:
 private:
     std::string _saveFilePath;
     int _autoSaveIntervalSeconds;
+    std::atomic<SaveFormat> _saveFormat;
 
-    std::thread* _autoSaveThread;
+    TimerWheel* _timers;
+    TimerWheel::TimerId _autoSaveTimer;
     std::atomic<bool> _isAutoSaving;
     std::mutex _saveMutex;
 
     DungeonMap* _dungeonMapRef;
     Player* _playerRef;
     EntityManager* _entityManagerRef;
+    SnapshotProvider _snapshotProvider;
+
+    ActionJournal* _journal;
+
+    // Autoguardado incremental (formato binario)
+    // _savedRevisions lo copia el timer y lo actualiza el thread de guardado (_revisionsMutex)
+    // _roomSegments solo lo usa el thread de guardado
+    RoomRevisions _savedRevisions;
+    std::mutex _revisionsMutex;
+    std::map<int, std::string> _roomSegments;
+
+    bool WriteIncremental(const Snapshot& snapshot);
+
+    // Un autoguardado copiado por AutoSaveTick() a la espera de escribirse
+    struct PendingSave
+    {
+        Snapshot snapshot;
+        bool incremental = false;
+        std::chrono::steady_clock::time_point start;
+        long long stallMicroseconds = 0;
+    };
+
+    // Thread de guardado: el disco no retrasa los dems trabajos del TimerWheel
+    // Solo hay un guardado pendiente, uno nuevo sustituye al que an no se ha escrito
+    std::thread* _saveThread;
+    PendingSave _pendingSave;
+    bool _hasPendingSave;
+    bool _isSaveThreadStopping;
+    std::mutex _saveQueueMutex;
+    std::condition_variable _saveQueueCondition;
+
+    void SaveLoop();
+    void WritePendingSave(PendingSave& save);
+
+    // Prefetch de salas pendientes, el thread solo decodifica a Room::Snapshot (datos planos)
+    std::thread* _prefetchThread;
+    std::atomic<bool> _isPrefetching;
+    std::mutex _prefetchMutex;
+    std::condition_variable _prefetchCondition;
+    std::deque<std::pair<Room*, SaveSegment>> _prefetchQueue;
+    std::map<Room*, Room::Snapshot> _prefetchedRooms;
+
+    void PrefetchLoop();
 
-    void AutoSaveLoop();
+    void AutoSaveTick();
 };
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <cstddef>
+
+// Una sala codificada de un guardado binario (con su prefijo de longitud), para la carga perezosa
+// Apunta dentro del buffer en el que se ley el archivo entero: todas las salas de una carga
+// comparten ese bloque en vez de tener su propia copia, y se libera de una vez cuando ya no
+// queda ninguna sala pendiente que lo use
+class SaveSegment
+{
+public:
+    SaveSegment() : _data(nullptr), _size(0) {}
+    SaveSegment(std::nullptr_t) : SaveSegment() {}
+
+    SaveSegment(const std::shared_ptr<const std::string>& buffer, size_t offset, size_t size)
+        : _buffer(buffer), _data(buffer->data() + offset), _size(size) {}
+
+    const char* GetData() const { return _data; }
+    size_t GetSize() const { return _size; }
+
+    explicit operator bool() const { return _data != nullptr; }
+    bool operator==(std::nullptr_t) const { return _data == nullptr; }
+    bool operator!=(std::nullptr_t) const { return _data != nullptr; }
+
+private:
+    std::shared_ptr<const std::string> _buffer;
+    const char* _data;
+    size_t _size;
+};
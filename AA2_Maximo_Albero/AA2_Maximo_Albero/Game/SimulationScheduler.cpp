@@ -0,0 +1,339 @@
+#include "SimulationScheduler.h"
+#include "Enemy.h"
+#include "../Utils/ConsoleControl.h"
+#include "../Utils/GameStats.h"
+#include "../Utils/GameConstants.h"
+#include "EntityStore.h"
+#include "FlowField.h"
+#include <algorithm>
+
+SimulationScheduler::~SimulationScheduler()
+{
+    Stop();
+}
+
+void SimulationScheduler::Start()
+{
+    _schedulerMutex.lock();
+
+    if (_running)
+    {
+        _schedulerMutex.unlock();
+        return;
+    }
+
+    _running = true;
+    _tickThread = new std::thread(&SimulationScheduler::TickLoop, this);
+    _tickThreadId = _tickThread->get_id();
+
+    _schedulerMutex.unlock();
+}
+
+void SimulationScheduler::Stop()
+{
+    _schedulerMutex.lock();
+
+    if (!_running)
+    {
+        _schedulerMutex.unlock();
+        return;
+    }
+
+    _running = false;
+    _schedulerMutex.unlock(); // Unlock BEFORE join, the tick may be waiting for it
+
+    if (_tickThread != nullptr)
+    {
+        if (_tickThread->joinable())
+            _tickThread->join();
+
+        delete _tickThread;
+        _tickThread = nullptr;
+    }
+}
+
+// Marks the enemy's components as simulated and adds its store to the tick list
+// Called from Enemy::StartMovement()
+void SimulationScheduler::Register(Enemy* enemy)
+{
+    if (enemy == nullptr)
+        return;
+
+    EntityStore* store = enemy->GetStore();
+
+    _schedulerMutex.lock();
+
+    store->Lock();
+    int index = store->Find(enemy->GetComponents());
+    if (index != SlotIndex::NOT_FOUND)
+        store->SetSimulatedAt(index, true);
+    store->Unlock();
+
+    auto it = std::find(_stores.begin(), _stores.end(), store);
+    if (it == _stores.end())
+    {
+        _stores.push_back(store);
+    }
+
+    _schedulerMutex.unlock();
+}
+
+// Stops simulating an enemy, its store leaves the tick list with the last one
+// When it returns the enemy is not being updated anymore, so it can be deleted safely
+// (and so can its store, if no other enemy of it is registered)
+// Never waits if the caller holds Lock(), no room can be mid-update then
+void SimulationScheduler::Unregister(Enemy* enemy)
+{
+    if (enemy == nullptr)
+        return;
+
+    EntityStore* store = enemy->GetStore();
+    EntityHandle components = enemy->GetComponents();
+
+    std::unique_lock<std::mutex> lock(_schedulerMutex);
+
+    store->Lock();
+    int index = store->Find(components);
+    if (index != SlotIndex::NOT_FOUND)
+        store->SetSimulatedAt(index, false);
+    bool storeEmpty = store->GetSimulatedCount() == 0;
+    store->Unlock();
+
+    if (storeEmpty)
+    {
+        auto it = std::find(_stores.begin(), _stores.end(), store);
+        if (it != _stores.end())
+        {
+            _stores.erase(it);
+        }
+    }
+
+    // The tick thread never waits for itself
+    if (std::this_thread::get_id() == _tickThreadId)
+        return;
+
+    // Compared by handle: a recycled pool slot may give another enemy the same address
+    _tickFinished.wait(lock, [this, components, store, storeEmpty]() {
+        bool ticking = _tickingStore == store && _tickingComponents == components;
+        return !ticking && (!storeEmpty || _tickingStore != store);
+        });
+}
+
+void SimulationScheduler::SetEnemyCallbacks(
+    std::function<bool(EntityStore*, EntityHandle, Vector2)> canMoveCallback,
+    std::function<Vector2()> getPlayerPosCallback,
+    std::function<void(EntityStore*, EntityHandle)> onAttackPlayerCallback)
+{
+    _schedulerMutex.lock();
+    _canMoveToCallback = canMoveCallback;
+    _getPlayerPositionCallback = getPlayerPosCallback;
+    _onAttackPlayerCallback = onAttackPlayerCallback;
+    _schedulerMutex.unlock();
+}
+
+// Fixed timestep loop
+// Uses sleep_until so the time spent updating does not drift the tick rate
+void SimulationScheduler::TickLoop()
+{
+    auto nextTick = std::chrono::steady_clock::now();
+
+    while (_running)
+    {
+        nextTick += std::chrono::milliseconds(_tickMs);
+        std::this_thread::sleep_until(nextTick);
+
+        if (!_running)
+            break;
+
+        Tick();
+
+        // All enemy moves of this tick go to the console as one frame
+        CC::Present();
+
+        // If we fell behind (debugger, heavy load) skip the lost ticks instead of bursting
+        auto now = std::chrono::steady_clock::now();
+        if (now > nextTick + std::chrono::milliseconds(_tickMs))
+            nextTick = now;
+    }
+}
+
+// Updates every registered enemy once, one store (room) at a time
+void SimulationScheduler::Tick()
+{
+    _schedulerMutex.lock();
+    auto getPlayerPos = _getPlayerPositionCallback;
+    _schedulerMutex.unlock();
+
+    for (size_t i = 0; ; i++)
+    {
+        _simulationMutex.lock();
+        _schedulerMutex.lock();
+
+        // Stop() only cuts the tick thread short, a direct call runs every store
+        bool stopping = !_running && std::this_thread::get_id() == _tickThreadId;
+        if (i >= _stores.size() || stopping || !getPlayerPos)
+        {
+            _schedulerMutex.unlock();
+            _simulationMutex.unlock();
+            break;
+        }
+
+        EntityStore* store = _stores[i];
+        _tickingStore = store;
+        _schedulerMutex.unlock();
+
+        // The player cannot move while _simulationMutex is held (Game::MovePlayer takes it),
+        // one position is valid for the whole store
+        Vector2 playerPos = getPlayerPos();
+
+        // -1000, -1000: no player (game over)
+        if (playerPos.X != -1000 || playerPos.Y != -1000)
+        {
+            // Only recomputed if the player moved or the obstacles changed
+            FlowField* flowField = store->GetFlowField();
+            if (flowField != nullptr && !flowField->Update(playerPos))
+                flowField = nullptr;
+
+            auto now = std::chrono::steady_clock::now();
+            CollectActions(store, flowField, playerPos, now);
+
+            for (const EnemyAction& action : _actions)
+            {
+                RunAction(store, action, now);
+            }
+        }
+
+        _schedulerMutex.lock();
+        _tickingStore = nullptr;
+        _schedulerMutex.unlock();
+        _tickFinished.notify_all();
+
+        _simulationMutex.unlock();
+    }
+
+    GameStats::Add(GameStats::TICKS);
+}
+
+// Linear pass over the component arrays, with one store lock for every enemy
+// Adjacent to the player: attack. Otherwise: the flow field step towards the player,
+// or a random step if there is no field or the player cannot be reached
+void SimulationScheduler::CollectActions(EntityStore* store, FlowField* flowField, Vector2 playerPos, std::chrono::steady_clock::time_point now)
+{
+    _actions.clear();
+
+    store->Lock();
+
+    size_t count = store->Size();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!store->IsSimulatedAt(i) || store->KindAt(i) != EntityKind::ENEMY)
+            continue;
+
+        // Dead or still in cooldown
+        if (store->HealthAt(i) <= 0 || store->CooldownAt(i) > now)
+            continue;
+
+        Vector2 position = store->PositionAt(i);
+        int distance = abs(position.X - playerPos.X) + abs(position.Y - playerPos.Y);
+
+        EnemyAction action;
+        action.components = store->HandleAt(i);
+        action.enemy = store->RoomHandleAt(i);
+        action.attack = distance == 1;
+        action.target = playerPos;
+        action.fallback = playerPos;
+
+        if (!action.attack)
+        {
+            Vector2 step = flowField != nullptr ? flowField->GetStep(position) : Vector2(0, 0);
+            action.fallback = position + GetRandomDirection();
+            action.target = (step.X != 0 || step.Y != 0) ? position + step : action.fallback;
+        }
+
+        _actions.push_back(action);
+    }
+
+    store->Unlock();
+}
+
+// Runs one action through the callbacks, without the store lock (they take the game locks)
+// On success the enemy waits ENEMY_ACTION_COOLDOWN_MS for the next one, a blocked move is retried next tick
+void SimulationScheduler::RunAction(EntityStore* store, const EnemyAction& action, std::chrono::steady_clock::time_point now)
+{
+    _schedulerMutex.lock();
+
+    // Unregistered or removed since CollectActions()
+    store->Lock();
+    int index = store->Find(action.components);
+    bool simulated = index != SlotIndex::NOT_FOUND && store->IsSimulatedAt(index);
+    store->Unlock();
+
+    auto canMove = _canMoveToCallback;
+    auto onAttackPlayer = _onAttackPlayerCallback;
+    if (simulated)
+        _tickingComponents = action.components;
+    _schedulerMutex.unlock();
+
+    if (!simulated || !canMove || !onAttackPlayer)
+    {
+        _schedulerMutex.lock();
+        _tickingComponents = EntityHandle();
+        _schedulerMutex.unlock();
+        return;
+    }
+
+    bool acted;
+    Vector2 moveTo = action.target;
+    if (action.attack)
+    {
+        onAttackPlayer(store, action.enemy);
+        acted = true;
+        GameStats::Add(GameStats::ATTACKS);
+    }
+    else
+    {
+        // Ask if the enemy can move to the next position
+        acted = canMove(store, action.enemy, moveTo);
+
+        // Another entity is on the path, a random step keeps it from getting stuck behind it
+        if (!acted && (action.fallback.X != action.target.X || action.fallback.Y != action.target.Y))
+        {
+            moveTo = action.fallback;
+            acted = canMove(store, action.enemy, moveTo);
+        }
+
+        if (acted)
+            GameStats::Add(GameStats::MOVES);
+    }
+
+    if (acted)
+    {
+        store->Lock();
+        index = store->Find(action.components);
+        if (index != SlotIndex::NOT_FOUND)
+        {
+            // The position was already moved by the canMove callback
+            store->CooldownAt(index) = now + std::chrono::milliseconds(ENEMY_ACTION_COOLDOWN_MS);
+        }
+        store->Unlock();
+    }
+
+    _schedulerMutex.lock();
+    _tickingComponents = EntityHandle();
+    _schedulerMutex.unlock();
+    _tickFinished.notify_all();
+}
+
+Vector2 SimulationScheduler::GetRandomDirection()
+{
+    int direction = rand() % 4;
+
+    switch (direction)
+    {
+    case 0: return Vector2(0, -1);  // Arriba
+    case 1: return Vector2(0, 1);   // Abajo
+    case 2: return Vector2(-1, 0);  // Izquierda
+    case 3: return Vector2(1, 0);   // Derecha
+    default: return Vector2(0, 0);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+#include "../NodeMap/Vector2.h"
+#include "../Utils/SlotMap.h"
+
+// Forward declarations
+class Enemy;
+class EntityStore;
+class FlowField;
+
+// Enemy system: simulates every registered enemy from a single thread on a fixed timestep
+// Each tick walks the component arrays of the EntityStores that hold registered enemies,
+// decides the actions in one pass with the store locked and then runs them through the callbacks
+// Enemies chase the player along the FlowField of their room, it is updated once per store and tick
+class SimulationScheduler
+{
+public:
+    SimulationScheduler(int tickMs = 100)
+        : _tickMs(tickMs),
+        _tickingStore(nullptr),
+        _tickThread(nullptr),
+        _running(false) {
+    }
+
+    ~SimulationScheduler();
+
+    void Start();
+    void Stop();
+
+    void Register(Enemy* enemy);
+    void Unregister(Enemy* enemy);
+
+    // Updates every registered enemy once. Run by the tick thread, or directly while
+    // the scheduler is not started (SimulationBenchmark times it this way)
+    void Tick();
+
+    // Callbacks to query the world (EntityManager/Game), shared by every enemy
+    // The enemy is passed as its store and its handle in the slot map of the room that owns that store
+    // (handles of different rooms look alike), the callback resolves it under its own lock
+    // canMove also makes the move (grid, map and the position in the store) when it returns true
+    void SetEnemyCallbacks(
+        std::function<bool(EntityStore*, EntityHandle, Vector2)> canMoveCallback,
+        std::function<Vector2()> getPlayerPosCallback,
+        std::function<void(EntityStore*, EntityHandle)> onAttackPlayerCallback);
+
+    // Held while the enemies of a room update. Holding it pauses the simulation between two rooms
+    // Lock order: Spawner -> SimulationScheduler -> Game
+    void Lock() { _simulationMutex.lock(); }
+    void Unlock() { _simulationMutex.unlock(); }
+
+private:
+    // What an enemy does this tick, decided in the linear pass over the store
+    struct EnemyAction
+    {
+        EntityHandle components;
+        EntityHandle enemy; // Handle in the room, for the callbacks
+        bool attack;
+        Vector2 target;   // Cell to move to
+        Vector2 fallback; // Random step if a chasing enemy finds target taken, same as target when wandering
+    };
+
+    int _tickMs;
+
+    // Stores with at least one registered enemy
+    std::vector<EntityStore*> _stores;
+    std::vector<EnemyAction> _actions; // Reused every tick, only the tick thread uses it
+    EntityHandle _tickingComponents; // Enemy whose action runs, in _tickingStore
+    EntityStore* _tickingStore;
+
+    std::function<bool(EntityStore*, EntityHandle, Vector2)> _canMoveToCallback;
+    std::function<Vector2()> _getPlayerPositionCallback;
+    std::function<void(EntityStore*, EntityHandle)> _onAttackPlayerCallback;
+
+    std::thread* _tickThread;
+    std::thread::id _tickThreadId;
+    std::atomic<bool> _running;
+    std::mutex _schedulerMutex;
+    std::mutex _simulationMutex;
+    std::condition_variable _tickFinished;
+
+    void TickLoop();
+
+    // Both with _simulationMutex held
+    void CollectActions(EntityStore* store, FlowField* flowField, Vector2 playerPos, std::chrono::steady_clock::time_point now);
+    void RunAction(EntityStore* store, const EnemyAction& action, std::chrono::steady_clock::time_point now);
+
+    static Vector2 GetRandomDirection();
+};
@@ -12,7 +12,7 @@ Spawner::~Spawner()
 
 //Inicia el sistema de spawn peridico para una sala especfica
 // Parametro room: Sala donde se spawnern las entidades
-// Crea un thread que ejecuta SpawnLoop()
+// Programa SpawnTick() en el TimerWheel cada _spawnIntervalSeconds
 // Se llama al entrar a una sala o iniciar el juego
 void Spawner::Start(Room* room)
 {
@@ -27,7 +27,7 @@ void Spawner::Start(Room* room)
     _currentRoom = room;
     _running = true;
 
-    _spawnThread = new std::thread(&Spawner::SpawnLoop, this);
+    _spawnTimer = _timers->Schedule([this]() { SpawnTick(); }, _spawnIntervalSeconds * 1000);
 
     _spawnerMutex.unlock();
 }
@@ -35,7 +35,8 @@ void Spawner::Start(Room* room)
 //Detiene el sistema de spawn
 // Cuando: 1.El jugador cambia de sala (ChangeRoom) o 2.El juego termina
 // Debe detenerse al cambiar de sala para que no spawnee en sala vaca
-// THREAD-SAFETY: join() espera a que el thread termine antes de continuar
+// THREAD-SAFETY: Cancel() vuelve cuando SpawnTick() ya no se est ejecutando
+// No hay que esperar al intervalo, la cancelacin es inmediata
 void Spawner::Stop()
 {
     _spawnerMutex.lock();
@@ -47,43 +48,30 @@ void Spawner::Stop()
     }
 
     _running = false;
-    _spawnerMutex.unlock(); // IMPORTANTE: Desbloquear ANTES de join
+    TimerWheel::TimerId spawnTimer = _spawnTimer;
+    _spawnTimer = 0;
+    _spawnerMutex.unlock(); // IMPORTANTE: Desbloquear ANTES de Cancel, el tick puede estar esperndolo
 
-    // Esperar un poco para que el loop detecte el cambio
-    std::this_thread::sleep_for(std::chrono::milliseconds(150));
-
-    if (_spawnThread != nullptr)
-    {
-        if (_spawnThread->joinable())
-            _spawnThread->join();
-
-        delete _spawnThread;
-        _spawnThread = nullptr;
-    }
+    _timers->Cancel(spawnTimer);
 }
 
-// Loop principal que ejecuta spawns peridicos
-// EJECUCIN: Thread separado, corre mientras _running == true
+// Un spawn, lo ejecuta el thread del TimerWheel
 // FRECUENCIA: Cada _spawnIntervalSeconds segundos (por defecto 10)
-void Spawner::SpawnLoop()
+void Spawner::SpawnTick()
 {
-    while (_running)
     {
-        // En lugar de sleep(10000), usar sleeps cortos de 100ms
-        // Permite detener el thread rpidamente cuando _running cambie
-        // _spawnIntervalSeconds * 10 = 10 segundos * 10 = 100 sleeps de 100ms
-        for (int i = 0; i < _spawnIntervalSeconds * 10 && _running; i++)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        std::unique_lock<std::mutex> lock(_spawnerMutex);
 
-        // Verificar de nuevo antes de spawner por si se detuvo durante el sleep
+        // Verificar de nuevo por si se detuvo mientras esperaba el lock
         if (!_running)
-            break;
+            return;
 
         // Ejecutar spawn de entidad aleatoria
+        // Con _spawnerMutex bloqueado: el autoguardado no ve la sala a medias
         SpawnRandomEntity();
     }
+
+    CC::Present();
 }
 
 // Genera una entidad aleatoria(enemigo o cofre) en posicin vlida
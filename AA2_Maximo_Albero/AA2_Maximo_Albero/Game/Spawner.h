@@ -1,10 +1,9 @@
 #pragma once
-#include <thread>
 #include <mutex>
 #include <atomic>
-#include <chrono>
 #include <random>
 #include "../NodeMap/Vector2.h"
+#include "../Utils/TimerWheel.h"
 
 // Forward declarations
 class Room;
@@ -13,11 +12,13 @@ class EntityManager;
 class Spawner
 {
 public:
-    Spawner(EntityManager* entityManager, int spawnIntervalSeconds = 10)
+    // The spawns run as a job of timers, no thread of its own
+    Spawner(EntityManager* entityManager, TimerWheel* timers, int spawnIntervalSeconds = 10)
         : _entityManager(entityManager),
+        _timers(timers),
         _spawnIntervalSeconds(spawnIntervalSeconds),
         _running(false),
-        _spawnThread(nullptr) {
+        _spawnTimer(0) {
     }
 
     ~Spawner();
@@ -25,16 +26,21 @@ public:
     void Start(Room* room);
     void Stop();
 
+    // Held while an entity is being spawned
+    void Lock() { _spawnerMutex.lock(); }
+    void Unlock() { _spawnerMutex.unlock(); }
+
 private:
     EntityManager* _entityManager;
     Room* _currentRoom;
+    TimerWheel* _timers;
     int _spawnIntervalSeconds;
 
-    std::thread* _spawnThread;
     std::atomic<bool> _running;
+    TimerWheel::TimerId _spawnTimer;
     std::mutex _spawnerMutex;
 
-    void SpawnLoop();
+    void SpawnTick();
     void SpawnRandomEntity();
     Vector2 GetRandomFreePosition();
     bool IsPositionValid(Vector2 position);
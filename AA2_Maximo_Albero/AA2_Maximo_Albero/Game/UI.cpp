@@ -1,22 +1,24 @@
 #include "UI.h"
 
-void UI::Start(Player* player)
+static const int SIDEBAR_REFRESH_MS = 100;
+
+void UI::Start(Player* player, TimerWheel* timers)
 {
+    if (_refreshTimer != 0)
+        return;
+
     _player = player;
-    _running = true;
-    _uiThread = new std::thread(&UI::UpdateLoop, this);
+    _timers = timers;
+    _refreshTimer = _timers->Schedule([this]() { DrawSidebar(); }, SIDEBAR_REFRESH_MS, 0);
 }
 
 void UI::Stop()
 {
-    _running = false;
+    if (_refreshTimer == 0)
+        return;
 
-    if (_uiThread && _uiThread->joinable())
-    {
-        _uiThread->join();
-        delete _uiThread;
-        _uiThread = nullptr;
-    }
+    _timers->Cancel(_refreshTimer);
+    _refreshTimer = 0;
 }
 
 void UI::DrawSidebar()
@@ -65,13 +67,4 @@ void UI::DrawSidebar()
     std::cout << "p = Pocion  w = Arma                ";
 
     CC::Unlock();
-}
-
-void UI::UpdateLoop()
-{
-    while (_running)
-    {
-        DrawSidebar();
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
 }
\ No newline at end of file
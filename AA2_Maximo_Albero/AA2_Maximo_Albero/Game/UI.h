@@ -3,9 +3,8 @@
 #include "Player.h"
 #include "../Utils/ConsoleControl.h"
 #include "../Utils/GameConstants.h"
+#include "../Utils/TimerWheel.h"
 #include <iostream>
-#include <thread>
-#include <atomic>
 
 #define TOP_UI_TEXT_AREA 0
 #define BOTTOM_UI_TEXT_AREA 13
@@ -13,10 +12,11 @@
 class UI
 {
 public:
-    UI() : _player(nullptr), _uiThread(nullptr), _running(false) {}
+    UI() : _player(nullptr), _timers(nullptr), _refreshTimer(0) {}
     ~UI() { Stop(); }
 
-    void Start(Player* player);
+    // The sidebar is refreshed by a job of timers
+    void Start(Player* player, TimerWheel* timers);
     void Stop();
     void SetMapSize(const Vector2& size) { _mapSize = size; }
     void DrawSidebar();
@@ -24,8 +24,6 @@ public:
 private:
     Player* _player;
     Vector2 _mapSize;
-    std::thread* _uiThread;
-    std::atomic<bool> _running;
-
-    void UpdateLoop();
+    TimerWheel* _timers;
+    TimerWheel::TimerId _refreshTimer;
 };
\ No newline at end of file
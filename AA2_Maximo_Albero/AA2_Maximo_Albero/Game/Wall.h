@@ -6,11 +6,6 @@ class Wall : public INodeContent
 {
 public:
     void Draw(Vector2 pos) override {
-        CC::Lock();
-        CC::SetColor(CC::CYAN);
-        CC::SetPosition(pos.X, pos.Y);
-        std::cout << "#";
-        CC::SetColor(CC::WHITE);
-        CC::Unlock();
+        CC::DrawCell(pos.X, pos.Y, '#', CC::CYAN);
     }
 };
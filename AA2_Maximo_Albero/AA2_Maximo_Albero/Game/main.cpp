@@ -1,15 +1,67 @@
 #include "Game.h"
 #include "../Utils/ConsoleControl.h"
 #include "../Utils/HideConsoleCursor.h"
+#include "../Utils/GameStats.h"
+#include "../InputSystem/ScriptedInput.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <string>
 
-int main()
+// Usage:
+//   AA2_Maximo_Albero [--save-format json|binary]
+//   AA2_Maximo_Albero --headless <seconds> [--script <keys file>] [--save-format json|binary]
+//   AA2_Maximo_Albero --convert-save <save.json> <save.bin>
+
+// Runs the game without a terminal for a number of seconds and prints the stats
+int RunHeadless(int seconds, const std::string& scriptPath, SaveFormat saveFormat)
+{
+    const char* savePath = "headless_savegame.json";
+    std::remove(savePath); // Every run starts from a new game
+
+    CC::SetHeadless(true);
+    GameStats::Reset();
+
+    ScriptedInput input(scriptPath, 100);
+
+    Game game(savePath);
+    game.SetKeySource([&input]() { return input.NextKey(); });
+    game.SetSaveFormat(saveFormat);
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto endTime = startTime + std::chrono::seconds(seconds);
+
+    game.Start();
+
+    while (std::chrono::steady_clock::now() < endTime && !game.IsGameOver())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    game.Stop();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    CC::SetHeadless(false);
+    CC::Lock();
+    std::cout << (game.IsGameOver() ? "Game over" : "Time limit reached") << std::endl;
+    GameStats::PrintSummary(std::cout, elapsed.count());
+
+    InputSystem::LatencyStats latency = game.GetInputLatencyStats();
+    std::cout << "Input latency: " << latency.samples << " keys, avg "
+        << (long long)latency.averageMicroseconds << " us, max "
+        << latency.maxMicroseconds << " us" << std::endl;
+    CC::Unlock();
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
 {
     srand((unsigned int)time(NULL));
-    HideConsoleCursor();
 
     ICodable::SaveDecodeProcess<Player>();
     ICodable::SaveDecodeProcess<Enemy>();
@@ -17,7 +69,37 @@ int main()
     ICodable::SaveDecodeProcess<Item>();
     ICodable::SaveDecodeProcess<Room>();
 
+    if (argc >= 4 && std::string(argv[1]) == "--convert-save")
+    {
+        if (!SaveManager::ConvertJsonToBinary(argv[2], argv[3]))
+            return 1;
+
+        std::cout << "Guardado convertido: " << argv[2] << " -> " << argv[3] << std::endl;
+        return 0;
+    }
+
+    SaveFormat saveFormat = SaveFormat::JSON;
+    std::string scriptPath;
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        std::string argument = argv[i];
+
+        if (argument == "--save-format")
+            saveFormat = std::string(argv[i + 1]) == "binary" ? SaveFormat::BINARY : SaveFormat::JSON;
+        else if (argument == "--script")
+            scriptPath = argv[i + 1];
+    }
+
+    if (argc >= 3 && std::string(argv[1]) == "--headless")
+    {
+        return RunHeadless(atoi(argv[2]), scriptPath, saveFormat);
+    }
+
+    HideConsoleCursor();
+
     Game game;
+    game.SetSaveFormat(saveFormat);
     game.Start();
 
     while (true)
@@ -13,15 +13,18 @@ InputSystem::KeyBinding::~KeyBinding()
 
 InputSystem::InputSystem()
 {
+	_dispatching = false;
 }
 
 InputSystem::~InputSystem()
-{ //En el destructor de l'input system fem un bucle for utilitzant "pair",
-	//per obtenir els valors que n'hi han dins de la llista per eliminar
-	//tots els inputs associats a una acci
-	for (std::pair<int, KeyBindingList> pair : _keyBindingMap)
+{ //En el destructor de l'input system recorrem la taula de dispatch
+	//per eliminar tots els inputs associats a una acci
+	StopListen();
+
+	_bindingsMutex.lock();
+
+	for (KeyBindingList& bindingList : _dispatchTable)
 	{
-		KeyBindingList bindingList = pair.second;
 		for (KeyBinding* binding : bindingList) {
 			delete binding;
 		}
@@ -29,45 +32,43 @@ InputSystem::~InputSystem()
 		bindingList.clear();
 	}
 
-	_keyBindingMap.clear();
+	_bindingsMutex.unlock();
 }
 
 InputSystem::KeyBinding* InputSystem::AddListener(int key, KeyBinding::OnKeyPress onKeyPress)
 {
-	_classMutex.lock();
-
-	//busco la key, sino la trobo la creo
-	if (_keyBindingMap.find(key) == _keyBindingMap.end())
+	if (key < 0 || key >= INPUT_DISPATCH_TABLE_SIZE)
 	{
-		_keyBindingMap[key] = KeyBindingList();
+		return nullptr;
 	}
 
 	KeyBinding* keyBinding = new KeyBinding(key, onKeyPress);
-	_keyBindingMap[key].push_back(keyBinding);
 
-	_classMutex.unlock();
+	_bindingsMutex.lock();
+	_dispatchTable[key].push_back(keyBinding);
+	_bindingsMutex.unlock();
 
 	return keyBinding;
 }
 
 void InputSystem::RemoveAndDeleteListener(KeyBinding* keyBinding)
 {
-	int key = keyBinding->_key;
-	_classMutex.lock();
+	if (keyBinding == nullptr)
+	{
+		return;
+	}
 
-	if (_keyBindingMap.find(key) != _keyBindingMap.end()) {
-		KeyBindingList list = _keyBindingMap[key];
-		list.remove(keyBinding);
-		delete keyBinding;
+	_bindingsMutex.lock();
+	_dispatchTable[keyBinding->_key].remove(keyBinding);
+	_bindingsMutex.unlock();
 
-		if (list.size() <= 0) {
-			_keyBindingMap.erase(key);
-		}
-		{
-
-		}
-	}
+	delete keyBinding;
+}
 
+void InputSystem::SetKeySource(KeySource keySource)
+{
+	_classMutex.lock();
+	_keySource = keySource;
 	_classMutex.unlock();
 }
 
@@ -83,8 +84,10 @@ void InputSystem::StartListen()
 
 	_state = Starting;
 
-	std::thread* listenLoopThread = new std::thread(&InputSystem::ListenLoop, this);
-	listenLoopThread->detach();
+	_dispatching = true;
+	_dispatchThread = new std::thread(&InputSystem::DispatchLoop, this);
+
+	_listenThread = new std::thread(&InputSystem::ListenLoop, this);
 
 	_classMutex.unlock();
 }
@@ -93,48 +96,87 @@ void InputSystem::StopListen()
 {
 	_classMutex.lock();
 
-	if (_state != Listening)
+	if (_state == Listening || _state == Starting)
 	{
-		_classMutex.unlock();
-		return;
+		_state = Stopping;
 	}
 
-	_state = Stopping;
+	std::thread* listenThread = _listenThread;
+	_listenThread = nullptr;
+	std::thread* dispatchThread = _dispatchThread;
+	_dispatchThread = nullptr;
 
 	_classMutex.unlock();
+
+	//La lectura de teclas no fa spin: es desperta el poll perque el thread acabi ara
+	if (listenThread != nullptr)
+	{
+		CC::WakeInput();
+
+		if (listenThread->joinable())
+			listenThread->join();
+
+		delete listenThread;
+	}
+
+	//El thread de dispatch acaba de seguida, no depen de que es premi una tecla
+	if (dispatchThread != nullptr)
+	{
+		_queueMutex.lock();
+		_dispatching = false;
+		_queueMutex.unlock();
+		_queueCondition.notify_all();
+
+		if (dispatchThread->joinable())
+			dispatchThread->join();
+
+		delete dispatchThread;
+	}
+}
+
+InputSystem::LatencyStats InputSystem::GetLatencyStats()
+{
+	LatencyStats stats;
+
+	_latencyMutex.lock();
+	stats.samples = _latencySamples;
+	stats.maxMicroseconds = _latencyMaxMicroseconds;
+	if (_latencySamples > 0)
+	{
+		stats.averageMicroseconds = (double)_latencyTotalMicroseconds / _latencySamples;
+	}
+	_latencyMutex.unlock();
+
+	return stats;
 }
 
 void InputSystem::ListenLoop()
 {
 	_classMutex.lock();
 
-	_state = Listening;
+	if (_state == Starting)
+	{
+		_state = Listening;
+	}
 	State currentState = _state;
-	CC::ClearKeyBuffer();
+	KeySource keySource = _keySource;
+
+	if (!keySource)
+	{
+		keySource = []() { return CC::ReadNextKey(INPUT_POLL_TIMEOUT_MS); };
+		CC::ClearKeyBuffer();
+	}
 
 	_classMutex.unlock();
 
 	while (currentState == Listening)
 	{
-		int key = CC::ReadNextKey(); //Llegeixo quina tecla s'ha apetat
+		int key = keySource(); //Llegeixo quina tecla s'ha apetat
 
 		if (key != 0) {
-			_classMutex.lock();
-
-			if (_keyBindingMap.find(key) != _keyBindingMap.end())
-			{
-				KeyBindingList list = _keyBindingMap[key];
-
-				for (KeyBinding* binding : list) {
-					std::thread* onKeyPressThread = new std::thread(binding->_onKeyPress);
-					onKeyPressThread->detach();
-				}
-			}
-
-			_classMutex.unlock();
+			EnqueueKey(key);
 		}
 
-
 		_classMutex.lock();
 		currentState = _state;
 		_classMutex.unlock();
@@ -147,3 +189,82 @@ void InputSystem::ListenLoop()
 	}
 	_classMutex.unlock();
 }
+
+//Afegeix la tecla a la cua. Si la cua esta plena (tecla mantinguda) es descarta
+void InputSystem::EnqueueKey(int key)
+{
+	KeyCommand command;
+	command.key = key;
+	command.readTime = std::chrono::steady_clock::now();
+
+	_queueMutex.lock();
+
+	if (_commandQueue.size() >= INPUT_QUEUE_CAPACITY)
+	{
+		_queueMutex.unlock();
+		return;
+	}
+
+	_commandQueue.push_back(command);
+	_queueMutex.unlock();
+
+	_queueCondition.notify_one();
+}
+
+void InputSystem::DispatchLoop()
+{
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(_queueMutex);
+		_queueCondition.wait(lock, [this]() { return !_dispatching || !_commandQueue.empty(); });
+
+		if (!_dispatching)
+		{
+			_commandQueue.clear();
+			break;
+		}
+
+		KeyCommand command = _commandQueue.front();
+		_commandQueue.pop_front();
+		lock.unlock();
+
+		Dispatch(command);
+	}
+}
+
+void InputSystem::Dispatch(const KeyCommand& command)
+{
+	if (command.key < 0 || command.key >= INPUT_DISPATCH_TABLE_SIZE)
+	{
+		return;
+	}
+
+	bool handled = false;
+
+	_bindingsMutex.lock();
+
+	for (KeyBinding* binding : _dispatchTable[command.key]) {
+		binding->_onKeyPress();
+		handled = true;
+	}
+
+	_bindingsMutex.unlock();
+
+	if (!handled)
+	{
+		return;
+	}
+
+	long long latency = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - command.readTime
+	).count();
+
+	_latencyMutex.lock();
+	_latencySamples++;
+	_latencyTotalMicroseconds += latency;
+	if (latency > _latencyMaxMicroseconds)
+	{
+		_latencyMaxMicroseconds = latency;
+	}
+	_latencyMutex.unlock();
+}
\ No newline at end of file
@@ -1,11 +1,18 @@
 #pragma once
 #include "InputsConsts.h"
 #include <list>
-#include <map>
+#include <deque>
 #include <mutex>
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 
+#define INPUT_DISPATCH_TABLE_SIZE 256
+#define INPUT_QUEUE_CAPACITY 16
+#define INPUT_POLL_TIMEOUT_MS 500
+
 class InputSystem
 {
 public:
@@ -27,7 +34,15 @@ public:
 	};
 	
 	typedef std::list<KeyBinding*> KeyBindingList;
-	typedef std::map<int, KeyBindingList> KeyBindingMap;
+	typedef std::function<int()> KeySource;
+
+	//Temps des de que es llegeix la tecla fins que s'ha executat l'accio
+	struct LatencyStats
+	{
+		long long samples = 0;
+		double averageMicroseconds = 0;
+		long long maxMicroseconds = 0;
+	};
 
 public:
 	InputSystem();
@@ -39,6 +54,11 @@ public:
 	void StartListen();
 	void StopListen();
 
+	//Por defecto las teclas vienen de CC::ReadNextKey(), el modo headless usa un script
+	void SetKeySource(KeySource keySource);
+
+	LatencyStats GetLatencyStats();
+
 private:
 	enum State
 	{
@@ -48,10 +68,38 @@ private:
 		Stopped = 3
 	};
 
+	struct KeyCommand
+	{
+		int key;
+		std::chrono::steady_clock::time_point readTime;
+	};
+
 	State _state = Stopped;
 
 	std::mutex _classMutex;
-	KeyBindingMap _keyBindingMap;
+	KeySource _keySource;
+
+	//Taula plana: una llista de bindings per cada codi de tecla (0-255)
+	//Es protegeix amb _bindingsMutex, que es manté durant el dispatch,
+	//per tant un callback no pot afegir ni treure listeners
+	KeyBindingList _dispatchTable[INPUT_DISPATCH_TABLE_SIZE];
+	std::mutex _bindingsMutex;
+
+	//Cua limitada de tecles llegides, la buida un sol thread de dispatch
+	std::deque<KeyCommand> _commandQueue;
+	std::mutex _queueMutex;
+	std::condition_variable _queueCondition;
+	std::thread* _listenThread = nullptr;
+	std::thread* _dispatchThread = nullptr;
+	std::atomic<bool> _dispatching;
+
+	std::mutex _latencyMutex;
+	long long _latencySamples = 0;
+	long long _latencyTotalMicroseconds = 0;
+	long long _latencyMaxMicroseconds = 0;
 
 	void ListenLoop();
-};
\ No newline at end of file
+	void DispatchLoop();
+	void EnqueueKey(int key);
+	void Dispatch(const KeyCommand& command);
+};
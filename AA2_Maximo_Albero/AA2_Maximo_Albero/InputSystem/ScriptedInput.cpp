@@ -0,0 +1,54 @@
+#include "ScriptedInput.h"
+#include "InputsConsts.h"
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+
+ScriptedInput::ScriptedInput(const std::string& scriptPath, int keyIntervalMs)
+{
+	_nextKey = 0;
+	_keyIntervalMs = keyIntervalMs;
+
+	if (scriptPath.empty())
+		return;
+
+	//Cada caracter del archivo es una tecla, los saltos de linea se ignoran
+	std::ifstream file(scriptPath);
+	char c;
+
+	while (file.get(c))
+	{
+		if (c != '\n' && c != '\r')
+		{
+			_keys.push_back((unsigned char)c);
+		}
+	}
+}
+
+int ScriptedInput::NextKey()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(_keyIntervalMs));
+
+	if (_keys.empty())
+		return RandomKey();
+
+	_inputMutex.lock();
+	int key = _keys[_nextKey];
+	_nextKey = (_nextKey + 1) % _keys.size();
+	_inputMutex.unlock();
+
+	return key;
+}
+
+int ScriptedInput::RandomKey()
+{
+	switch (rand() % 9)
+	{
+	case 0: case 1: return K_W;
+	case 2: case 3: return K_A;
+	case 4: case 5: return K_S;
+	case 6: case 7: return K_D;
+	default: return K_SPACE;
+	}
+}
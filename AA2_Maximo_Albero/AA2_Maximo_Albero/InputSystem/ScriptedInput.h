@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+
+// Key source for the headless mode, replaces CC::ReadNextKey()
+// Plays the keys of a script file in a loop, or random WASD/space keys if there is no script
+class ScriptedInput
+{
+public:
+	ScriptedInput(const std::string& scriptPath = "", int keyIntervalMs = 100);
+
+	// Waits keyIntervalMs and returns the next key
+	int NextKey();
+
+	bool HasScript() const { return !_keys.empty(); }
+
+private:
+	std::vector<int> _keys;
+	size_t _nextKey;
+	int _keyIntervalMs;
+	std::mutex _inputMutex;
+
+	int RandomKey();
+};
@@ -0,0 +1,214 @@
+#include "BinaryCodableStream.h"
+#include <cstring>
+
+static const size_t FLUSH_SIZE = 64 * 1024;
+
+static const uint8_t TOKEN_BEGIN_OBJECT = 'O';
+static const uint8_t TOKEN_END_OBJECT = 'o';
+static const uint8_t TOKEN_BEGIN_ARRAY = 'A';
+static const uint8_t TOKEN_END_ARRAY = 'a';
+static const uint8_t TOKEN_KEY = 'K';
+static const uint8_t TOKEN_INT = 'I';
+static const uint8_t TOKEN_BOOL = 'B';
+
+// ===== WRITER =====
+
+void BinaryCodableWriter::BeginObject()
+{
+	_writer.WriteU8(TOKEN_BEGIN_OBJECT);
+}
+
+void BinaryCodableWriter::EndObject()
+{
+	_writer.WriteU8(TOKEN_END_OBJECT);
+	FlushIfFull();
+}
+
+void BinaryCodableWriter::BeginArray()
+{
+	_writer.WriteU8(TOKEN_BEGIN_ARRAY);
+}
+
+void BinaryCodableWriter::EndArray()
+{
+	_writer.WriteU8(TOKEN_END_ARRAY);
+	FlushIfFull();
+}
+
+void BinaryCodableWriter::Key(const char* key)
+{
+	size_t length = strlen(key);
+
+	_writer.WriteU8(TOKEN_KEY);
+	_writer.WriteU16((uint16_t)length);
+	_writer.WriteBytes(key, length);
+}
+
+void BinaryCodableWriter::WriteInt(long long value)
+{
+	_writer.WriteU8(TOKEN_INT);
+	_writer.WriteU64((uint64_t)value);
+}
+
+void BinaryCodableWriter::WriteBool(bool value)
+{
+	_writer.WriteU8(TOKEN_BOOL);
+	_writer.WriteU8(value ? 1 : 0);
+}
+
+void BinaryCodableWriter::FlushIfFull()
+{
+	if (_buffer.size() >= FLUSH_SIZE)
+		Flush();
+}
+
+void BinaryCodableWriter::Flush()
+{
+	if (_buffer.empty())
+		return;
+
+	_output.write(_buffer.c_str(), _buffer.size());
+	_buffer.clear();
+}
+
+// ===== READER =====
+
+bool BinaryCodableReader::Fail()
+{
+	_failed = true;
+	return false;
+}
+
+uint8_t BinaryCodableReader::Peek()
+{
+	if (_reader.GetRemaining() == 0)
+		return 0;
+
+	return (uint8_t)*_reader.GetCurrent();
+}
+
+bool BinaryCodableReader::Consume(uint8_t marker)
+{
+	if (_failed || Peek() != marker)
+		return Fail();
+
+	_reader.Skip(1);
+	return true;
+}
+
+bool BinaryCodableReader::BeginObject()
+{
+	return Consume(TOKEN_BEGIN_OBJECT);
+}
+
+bool BinaryCodableReader::NextKey(std::string& key)
+{
+	if (_failed)
+		return false;
+
+	if (Peek() == TOKEN_END_OBJECT)
+	{
+		_reader.Skip(1);
+		return false;
+	}
+
+	uint16_t length;
+	if (!Consume(TOKEN_KEY) || !_reader.ReadU16(length) || _reader.GetRemaining() < length)
+		return Fail();
+
+	key.assign(_reader.GetCurrent(), length);
+	_reader.Skip(length);
+	return true;
+}
+
+bool BinaryCodableReader::BeginArray()
+{
+	return Consume(TOKEN_BEGIN_ARRAY);
+}
+
+bool BinaryCodableReader::NextElement()
+{
+	if (_failed)
+		return false;
+
+	uint8_t next = Peek();
+
+	if (next == TOKEN_END_ARRAY)
+	{
+		_reader.Skip(1);
+		return false;
+	}
+
+	if (next == 0)
+		return Fail();
+
+	return true;
+}
+
+bool BinaryCodableReader::ReadInt64(long long& value)
+{
+	uint64_t raw;
+	if (!Consume(TOKEN_INT) || !_reader.ReadU64(raw))
+		return Fail();
+
+	value = (long long)raw;
+	return true;
+}
+
+bool BinaryCodableReader::ReadBool(bool& value)
+{
+	uint8_t raw;
+	if (!Consume(TOKEN_BOOL) || !_reader.ReadU8(raw))
+		return Fail();
+
+	value = raw != 0;
+	return true;
+}
+
+bool BinaryCodableReader::Skip()
+{
+	if (_failed)
+		return false;
+
+	size_t depth = 0;
+
+	do
+	{
+		uint8_t marker;
+		if (!_reader.ReadU8(marker))
+			return Fail();
+
+		switch (marker)
+		{
+		case TOKEN_BEGIN_OBJECT:
+		case TOKEN_BEGIN_ARRAY:
+			depth++;
+			break;
+		case TOKEN_END_OBJECT:
+		case TOKEN_END_ARRAY:
+			if (depth == 0)
+				return Fail();
+			depth--;
+			break;
+		case TOKEN_KEY:
+		{
+			uint16_t length;
+			if (depth == 0 || !_reader.ReadU16(length) || !_reader.Skip(length))
+				return Fail();
+			break;
+		}
+		case TOKEN_INT:
+			if (!_reader.Skip(8))
+				return Fail();
+			break;
+		case TOKEN_BOOL:
+			if (!_reader.Skip(1))
+				return Fail();
+			break;
+		default:
+			return Fail();
+		}
+	} while (depth > 0);
+
+	return true;
+}
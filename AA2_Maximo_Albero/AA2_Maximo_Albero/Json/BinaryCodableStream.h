@@ -0,0 +1,58 @@
+#pragma once
+#include "CodableStream.h"
+#include "../Utils/ByteStream.h"
+#include <ostream>
+#include <string>
+#include <cstdint>
+
+// Compact binary sink for CodableWriter, same structure as the JSON one
+// Every token is a u8 marker followed by its data (little-endian, ByteStream):
+//   'O' / 'o' begin / end object, 'A' / 'a' begin / end array
+//   'K' u16 length + bytes, 'I' u64 (two's complement), 'B' u8
+class BinaryCodableWriter : public CodableWriter
+{
+public:
+	BinaryCodableWriter(std::ostream& output) : _output(output), _writer(_buffer) {}
+	~BinaryCodableWriter() { Flush(); }
+
+	void BeginObject() override;
+	void EndObject() override;
+	void BeginArray() override;
+	void EndArray() override;
+	void Key(const char* key) override;
+	void WriteInt(long long value) override;
+	void WriteBool(bool value) override;
+
+	void Flush();
+
+private:
+	std::ostream& _output;
+	std::string _buffer;
+	ByteWriter _writer;
+
+	void FlushIfFull();
+};
+
+class BinaryCodableReader : public CodableReader
+{
+public:
+	BinaryCodableReader(const char* data, size_t size) : _reader(data, size), _failed(false) {}
+
+	bool BeginObject() override;
+	bool NextKey(std::string& key) override;
+	bool BeginArray() override;
+	bool NextElement() override;
+	bool ReadInt64(long long& value) override;
+	bool ReadBool(bool& value) override;
+	bool Skip() override;
+	bool Failed() const override { return _failed; }
+
+private:
+	ByteReader _reader;
+	bool _failed;
+
+	bool Consume(uint8_t marker);
+	// Marker of the next token without consuming it, 0 at the end of the data
+	uint8_t Peek();
+	bool Fail();
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+
+// Streaming encoder: the codables write straight to the output, no Json::Value tree is built
+// Sinks: JsonCodableWriter (text), BinaryCodableWriter (compact tokens)
+class CodableWriter
+{
+public:
+	virtual ~CodableWriter() {}
+
+	virtual void BeginObject() = 0;
+	virtual void EndObject() = 0;
+	virtual void BeginArray() = 0;
+	virtual void EndArray() = 0;
+	virtual void Key(const char* key) = 0;
+	virtual void WriteInt(long long value) = 0;
+	virtual void WriteBool(bool value) = 0;
+
+	void IntField(const char* key, long long value) { Key(key); WriteInt(value); }
+	void BoolField(const char* key, bool value) { Key(key); WriteBool(value); }
+};
+
+// Pull decoder, the mirror of CodableWriter
+// Any malformed input makes the call return false and Failed() true from then on
+//   reader.BeginObject();
+//   while (reader.NextKey(key)) { ... read or Skip() the value ... }
+//   if (reader.Failed()) ...
+class CodableReader
+{
+public:
+	virtual ~CodableReader() {}
+
+	virtual bool BeginObject() = 0;
+	// Reads the next key of the current object, false (and consumes the end) when there are no more
+	virtual bool NextKey(std::string& key) = 0;
+	virtual bool BeginArray() = 0;
+	// true if the current array has another element, false (and consumes the end) when there are no more
+	virtual bool NextElement() = 0;
+	virtual bool ReadInt64(long long& value) = 0;
+	virtual bool ReadBool(bool& value) = 0;
+	// Skips a value of any type, used for unknown keys and the type key of old saves
+	virtual bool Skip() = 0;
+	virtual bool Failed() const = 0;
+
+	bool ReadInt(int& value)
+	{
+		long long wide;
+		if (!ReadInt64(wide))
+			return false;
+
+		value = (int)wide;
+		return true;
+	}
+};
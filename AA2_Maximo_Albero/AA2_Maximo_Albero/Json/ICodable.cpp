@@ -1,17 +1,72 @@
 #include "ICodable.h"
 
+const char* const ICodable::TYPE_KEY = "ICodableType";
+
 std::string ICodable::DecodeKey()
 {
-	return "ICodableType";
+	return TYPE_KEY;
 }
 
-void ICodable::SaveDecodeProcess(std::string className, SubClassDecode decodeProcess)
+void ICodable::SaveDecodeProcess(uint8_t typeId, const char* typeName, const char* compilerTypeName, SubClassDecode decodeProcess)
 {
-	ICodable::GetDecodeMap()->emplace(className, decodeProcess);
+	if (typeId == CODABLE_NONE || typeId >= CODABLE_MAX_TYPES)
+		return;
+
+	GetDecodeTable()[typeId] = decodeProcess;
+
+	// Names written by older builds: typeid(T).name() of this compiler, MSVC ("class Enemy") and GCC/Clang ("5Enemy")
+	std::string name = typeName;
+	TypeNameMap* names = GetTypeNameMap();
+	names->emplace(name, typeId);
+	names->emplace(compilerTypeName, typeId);
+	names->emplace("class " + name, typeId);
+	names->emplace(std::to_string(name.size()) + name, typeId);
 }
 
-ICodable::DecodeMap* ICodable::GetDecodeMap() {
-	static DecodeMap* map = new DecodeMap();
+uint8_t ICodable::GetTypeId(const Json::Value& json)
+{
+	const Json::Value& type = json[TYPE_KEY];
+
+	if (type.isIntegral())
+	{
+		int typeId = type.asInt();
+		if (typeId <= CODABLE_NONE || typeId >= CODABLE_MAX_TYPES || GetDecodeTable()[typeId] == nullptr)
+			return CODABLE_NONE;
+
+		return (uint8_t)typeId;
+	}
+
+	if (type.isString())
+	{
+		TypeNameMap* names = GetTypeNameMap();
+		auto it = names->find(type.asString());
+		if (it != names->end())
+			return it->second;
+	}
+
+	return CODABLE_NONE;
+}
+
+ICodable* ICodable::FromJson(const Json::Value& json)
+{
+	uint8_t typeId = GetTypeId(json);
+	if (typeId == CODABLE_NONE)
+		return nullptr;
+
+	ICodable* codable = GetDecodeTable()[typeId]();
+	codable->Decode(json);
+
+	return codable;
+}
+
+ICodable::SubClassDecode* ICodable::GetDecodeTable() {
+	static SubClassDecode table[CODABLE_MAX_TYPES] = {};
+
+	return table;
+}
+
+ICodable::TypeNameMap* ICodable::GetTypeNameMap() {
+	static TypeNameMap* map = new TypeNameMap();
 
 	return map;
-}
\ No newline at end of file
+}
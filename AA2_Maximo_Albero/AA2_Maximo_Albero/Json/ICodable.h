@@ -1,56 +1,87 @@
 #pragma once
 #include "../dist/json/json.h"
-#include <functional>
+#include "CodableStream.h"
+#include <map>
 #include <string>
-
+#include <cstdint>
+#include <typeinfo>
+#include <type_traits>
+
+// Every codable class declares its stable id and name:
+//   static constexpr uint8_t CODABLE_TYPE_ID = ICodable::CODABLE_ENEMY;
+//   static constexpr const char* CODABLE_TYPE_NAME = "Enemy";
+// The id is what the saves store, never renumber or reuse one
 class ICodable
 {
 public:
-	typedef std::function<ICodable* ()> SubClassDecode;
-	typedef std::map<std::string, SubClassDecode> DecodeMap;
+	enum CodableTypeId : uint8_t
+	{
+		CODABLE_NONE = 0,
+		CODABLE_PLAYER = 1,
+		CODABLE_ENEMY = 2,
+		CODABLE_CHEST = 3,
+		CODABLE_ITEM = 4,
+		CODABLE_ROOM = 5,
+		CODABLE_MAX_TYPES = 32
+	};
+
+	typedef ICodable* (*SubClassDecode)();
+	// Old saves store a type name, only used to resolve them to an id
+	typedef std::map<std::string, uint8_t> TypeNameMap;
 public:
 
+	// Key of the type id inside every encoded object
+	static const char* const TYPE_KEY;
+
 	static std::string DecodeKey();
-	static void SaveDecodeProcess(std::string className, SubClassDecode decodeProcess);
+	static void SaveDecodeProcess(uint8_t typeId, const char* typeName, const char* compilerTypeName, SubClassDecode decodeProcess);
 
 	template<typename T, typename = typename std::enable_if<std::is_base_of<ICodable, T>::value>::type>
 	static void SaveDecodeProcess() {
-		SaveDecodeProcess(typeid(T).name(), []() {
+		SaveDecodeProcess(T::CODABLE_TYPE_ID, T::CODABLE_TYPE_NAME, typeid(T).name(), []() -> ICodable* {
 			return new T();
 		});
 	}
 
 	virtual Json::Value Code() = 0;
-	virtual void Decode(Json::Value json) = 0;
-
-
-	template<typename T, typename = typename std::enable_if<std::is_base_of<ICodable, T>::value>::type>
-	static T* FromJson(Json::Value json) {
-		std::string className = json[DecodeKey()].asString();
+	virtual void Decode(const Json::Value& json) = 0;
 
-		ICodable* codable = (*GetDecodeMap())[className]();
+	// Streaming versions of Code() / Decode(), no Json::Value is built
+	// Decode(reader) returns false if the data is malformed, the object is left unchanged
+	virtual void Encode(CodableWriter& writer) = 0;
+	virtual bool Decode(CodableReader& reader) = 0;
 
-		//DecodeMap* decodeMap = GetDecodeMap();
-		//SubClassDecode decodeLambda = (*decodeMap)[className];
-		//ICodable codable = decodeLambda();
+	// Type id stored in json, CODABLE_NONE if missing or unknown
+	// Accepts the ids and the typeid(T).name() strings of older saves (MSVC and GCC spellings)
+	static uint8_t GetTypeId(const Json::Value& json);
 
-		T* codableCasted = dynamic_cast<T*>(codable);
+	// Any registered type, nullptr if unknown
+	static ICodable* FromJson(const Json::Value& json);
 
-		codableCasted->Decode(json);
+	// nullptr if json holds another type, so no dynamic_cast is needed
+	template<typename T, typename = typename std::enable_if<std::is_base_of<ICodable, T>::value>::type>
+	static T* FromJson(const Json::Value& json) {
+		if (GetTypeId(json) != T::CODABLE_TYPE_ID)
+			return nullptr;
 
-		return codableCasted;
+		return static_cast<T*>(FromJson(json));
 	}
 
 
 protected:
 
 	template<typename T, typename = typename std::enable_if<std::is_base_of<ICodable, T>::value>::type>
-	void CodeSubClassType(Json::Value& json) {
-		json[DecodeKey()] = typeid(T).name();
+	static void CodeSubClassType(Json::Value& json) {
+		json[DecodeKey()] = T::CODABLE_TYPE_ID;
+	}
+
+	template<typename T, typename = typename std::enable_if<std::is_base_of<ICodable, T>::value>::type>
+	static void CodeSubClassType(CodableWriter& writer) {
+		writer.IntField(TYPE_KEY, T::CODABLE_TYPE_ID);
 	}
 
 private:
 
-	static DecodeMap* GetDecodeMap();
+	static SubClassDecode* GetDecodeTable();
+	static TypeNameMap* GetTypeNameMap();
 };
-
@@ -0,0 +1,376 @@
+#include "JsonCodableStream.h"
+
+static const size_t FLUSH_SIZE = 64 * 1024;
+static const size_t MAX_DEPTH = 64; // Skip() recursion limit on malformed input
+
+// ===== WRITER =====
+
+void JsonCodableWriter::BeforeValue()
+{
+	// The value of a key goes on the same line
+	if (_afterKey)
+	{
+		_afterKey = false;
+		return;
+	}
+
+	if (_elementCounts.empty())
+		return;
+
+	if (_elementCounts.back()++ > 0)
+		_buffer += ',';
+
+	NewLine();
+}
+
+void JsonCodableWriter::NewLine()
+{
+	_buffer += '\n';
+	_buffer.append(_elementCounts.size() * 3, ' ');
+}
+
+void JsonCodableWriter::EndContainer(char closing)
+{
+	int elementCount = _elementCounts.back();
+	_elementCounts.pop_back();
+
+	if (elementCount > 0)
+		NewLine();
+
+	_buffer += closing;
+
+	if (_elementCounts.empty())
+		_buffer += '\n';
+
+	FlushIfFull();
+}
+
+void JsonCodableWriter::BeginObject()
+{
+	BeforeValue();
+	_buffer += '{';
+	_elementCounts.push_back(0);
+}
+
+void JsonCodableWriter::EndObject()
+{
+	EndContainer('}');
+}
+
+void JsonCodableWriter::BeginArray()
+{
+	BeforeValue();
+	_buffer += '[';
+	_elementCounts.push_back(0);
+}
+
+void JsonCodableWriter::EndArray()
+{
+	EndContainer(']');
+}
+
+void JsonCodableWriter::Key(const char* key)
+{
+	BeforeValue();
+
+	_buffer += '"';
+	for (const char* c = key; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			_buffer += '\\';
+		_buffer += *c;
+	}
+	_buffer += "\" : ";
+
+	_afterKey = true;
+}
+
+void JsonCodableWriter::WriteInt(long long value)
+{
+	BeforeValue();
+
+	// Digits written backwards into a stack buffer, no temporary string and no locale
+	char digits[24];
+	char* end = digits + sizeof(digits);
+	char* begin = end;
+
+	unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+	do
+	{
+		*--begin = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+
+	if (value < 0)
+		*--begin = '-';
+
+	_buffer.append(begin, end - begin);
+	FlushIfFull();
+}
+
+void JsonCodableWriter::WriteBool(bool value)
+{
+	BeforeValue();
+	_buffer += value ? "true" : "false";
+	FlushIfFull();
+}
+
+void JsonCodableWriter::FlushIfFull()
+{
+	if (_buffer.size() >= FLUSH_SIZE)
+		Flush();
+}
+
+void JsonCodableWriter::Flush()
+{
+	if (_buffer.empty())
+		return;
+
+	_output.write(_buffer.c_str(), _buffer.size());
+	_buffer.clear();
+}
+
+// ===== READER =====
+
+bool JsonCodableReader::Fail()
+{
+	_failed = true;
+	return false;
+}
+
+void JsonCodableReader::SkipWhitespace()
+{
+	while (_offset < _size && (_data[_offset] == ' ' || _data[_offset] == '\n' ||
+		_data[_offset] == '\r' || _data[_offset] == '\t'))
+	{
+		_offset++;
+	}
+}
+
+// Next significant character, '\0' at the end of the data
+char JsonCodableReader::Peek()
+{
+	SkipWhitespace();
+	return _offset < _size ? _data[_offset] : '\0';
+}
+
+bool JsonCodableReader::Consume(char expected)
+{
+	if (_failed || Peek() != expected)
+		return Fail();
+
+	_offset++;
+	return true;
+}
+
+bool JsonCodableReader::ConsumeLiteral(const char* literal)
+{
+	SkipWhitespace();
+
+	for (const char* c = literal; *c != '\0'; c++)
+	{
+		if (_offset >= _size || _data[_offset] != *c)
+			return Fail();
+		_offset++;
+	}
+
+	return true;
+}
+
+bool JsonCodableReader::ReadString(std::string& value)
+{
+	if (!Consume('"'))
+		return false;
+
+	value.clear();
+
+	while (_offset < _size)
+	{
+		char c = _data[_offset++];
+
+		if (c == '"')
+			return true;
+
+		if (c == '\\')
+		{
+			if (_offset >= _size)
+				break;
+
+			char escaped = _data[_offset++];
+			switch (escaped)
+			{
+			case 'n': value += '\n'; break;
+			case 't': value += '\t'; break;
+			case 'r': value += '\r'; break;
+			case 'b': value += '\b'; break;
+			case 'f': value += '\f'; break;
+			case 'u': _offset += 4; value += '?'; break; // The saves only have ASCII keys
+			default: value += escaped; break;
+			}
+			continue;
+		}
+
+		value += c;
+	}
+
+	return Fail();
+}
+
+bool JsonCodableReader::BeginObject()
+{
+	return Consume('{');
+}
+
+bool JsonCodableReader::NextKey(std::string& key)
+{
+	if (_failed)
+		return false;
+
+	char next = Peek();
+
+	if (next == '}')
+	{
+		_offset++;
+		return false;
+	}
+
+	if (next == ',')
+		_offset++;
+
+	return ReadString(key) && Consume(':');
+}
+
+bool JsonCodableReader::BeginArray()
+{
+	return Consume('[');
+}
+
+bool JsonCodableReader::NextElement()
+{
+	if (_failed)
+		return false;
+
+	char next = Peek();
+
+	if (next == ']')
+	{
+		_offset++;
+		return false;
+	}
+
+	if (next == '\0')
+		return Fail();
+
+	if (next == ',')
+		_offset++;
+
+	return true;
+}
+
+bool JsonCodableReader::ReadInt64(long long& value)
+{
+	if (_failed)
+		return false;
+
+	SkipWhitespace();
+
+	bool negative = false;
+	if (_offset < _size && _data[_offset] == '-')
+	{
+		negative = true;
+		_offset++;
+	}
+
+	if (_offset >= _size || _data[_offset] < '0' || _data[_offset] > '9')
+		return Fail();
+
+	unsigned long long magnitude = 0;
+	while (_offset < _size && _data[_offset] >= '0' && _data[_offset] <= '9')
+	{
+		magnitude = magnitude * 10 + (unsigned long long)(_data[_offset] - '0');
+		_offset++;
+	}
+
+	// A fraction or exponent is not expected in a save, it is skipped and the integer part kept
+	while (_offset < _size && (_data[_offset] == '.' || _data[_offset] == 'e' || _data[_offset] == 'E' ||
+		_data[_offset] == '+' || _data[_offset] == '-' || (_data[_offset] >= '0' && _data[_offset] <= '9')))
+	{
+		_offset++;
+	}
+
+	value = negative ? -(long long)magnitude : (long long)magnitude;
+	return true;
+}
+
+bool JsonCodableReader::ReadBool(bool& value)
+{
+	char next = Peek();
+
+	if (next == 't')
+	{
+		value = true;
+		return ConsumeLiteral("true");
+	}
+
+	if (next == 'f')
+	{
+		value = false;
+		return ConsumeLiteral("false");
+	}
+
+	return Fail();
+}
+
+bool JsonCodableReader::Skip()
+{
+	if (_failed)
+		return false;
+
+	// Nested containers are skipped with a depth counter instead of recursion
+	size_t depth = 0;
+	std::string ignored;
+
+	do
+	{
+		char next = Peek();
+
+		switch (next)
+		{
+		case '{':
+		case '[':
+			if (++depth > MAX_DEPTH)
+				return Fail();
+			_offset++;
+			break;
+		case '}':
+		case ']':
+			if (depth == 0)
+				return Fail();
+			depth--;
+			_offset++;
+			break;
+		case ',':
+		case ':':
+			if (depth == 0)
+				return Fail();
+			_offset++;
+			break;
+		case '"':
+			if (!ReadString(ignored))
+				return false;
+			break;
+		case 't': if (!ConsumeLiteral("true")) return false; break;
+		case 'f': if (!ConsumeLiteral("false")) return false; break;
+		case 'n': if (!ConsumeLiteral("null")) return false; break;
+		default:
+		{
+			long long number;
+			if (!ReadInt64(number))
+				return false;
+			break;
+		}
+		}
+	} while (depth > 0);
+
+	return true;
+}
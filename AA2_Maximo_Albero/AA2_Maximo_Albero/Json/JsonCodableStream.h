@@ -0,0 +1,65 @@
+#pragma once
+#include "CodableStream.h"
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Writes indented JSON text, readable by Json::Reader and JsonCodableReader
+// Output is buffered and handed to the stream in chunks, memory does not grow with the document
+class JsonCodableWriter : public CodableWriter
+{
+public:
+	JsonCodableWriter(std::ostream& output) : _output(output), _afterKey(false) {}
+	~JsonCodableWriter() { Flush(); }
+
+	void BeginObject() override;
+	void EndObject() override;
+	void BeginArray() override;
+	void EndArray() override;
+	void Key(const char* key) override;
+	void WriteInt(long long value) override;
+	void WriteBool(bool value) override;
+
+	void Flush();
+
+private:
+	std::ostream& _output;
+	std::string _buffer;
+	std::vector<int> _elementCounts; // One per open object or array
+	bool _afterKey;
+
+	void BeforeValue();
+	void NewLine();
+	void EndContainer(char closing);
+	void FlushIfFull();
+};
+
+// Reads JSON text token by token, without building a Json::Value tree
+class JsonCodableReader : public CodableReader
+{
+public:
+	JsonCodableReader(const char* data, size_t size) : _data(data), _size(size), _offset(0), _failed(false) {}
+
+	bool BeginObject() override;
+	bool NextKey(std::string& key) override;
+	bool BeginArray() override;
+	bool NextElement() override;
+	bool ReadInt64(long long& value) override;
+	bool ReadBool(bool& value) override;
+	bool Skip() override;
+	bool Failed() const override { return _failed; }
+
+private:
+	const char* _data;
+	size_t _size;
+	size_t _offset;
+	bool _failed;
+
+	void SkipWhitespace();
+	char Peek();
+	bool Consume(char expected);
+	bool ConsumeLiteral(const char* literal);
+	bool ReadString(std::string& value);
+	bool Fail();
+};
@@ -1,4 +1,4 @@
-#include "node.h"
+#include "Node.h"
 #include "../Utils/ConsoleControl.h"
 
 Node::Node(Vector2 position) {
@@ -18,20 +18,9 @@ void Node::DrawContent(Vector2 offset)
 {
 	Vector2 pos = offset + _position;
 	if (_content == nullptr) {
-		CC::Lock();
-		CC::SetPosition(pos.X, pos.Y);
-		std::cout << " ";
-		CC::Unlock();
+		CC::DrawCell(pos.X, pos.Y, ' ');
 		return;
 	}
 
 	_content->Draw(pos);
-}
-
-
-void Node::Lock() {
-	_classMutex.lock();
-}
-void Node::Unlock() {
-	_classMutex.unlock();
 }
\ No newline at end of file
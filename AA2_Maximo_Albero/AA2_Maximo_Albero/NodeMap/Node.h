@@ -1,6 +1,6 @@
 #pragma once
 
-#include <mutex>
+#include <type_traits>
 
 #include "Vector2.h"
 #include "INodeContent.h"
@@ -40,12 +40,10 @@ public:
 	void SetContent(INodeContent* nodeCOntent);
 	void DrawContent(Vector2 offset);
 
-	void Lock();
-	void Unlock();
-
+	//El lock del node ahora lo guarda el NodeMap (lock striping), asi el Node
+	//es un registro pequeno y el grid se puede guardar en un solo bloque
 private:
 	Vector2 _position;
-	INodeContent* _content;
-	std::mutex _classMutex;
+	INodeContent* _content = nullptr;
 };
 
@@ -1,100 +1,96 @@
 #include "NodeMap.h"
+#include <algorithm>
 
 NodeMap::NodeMap(Vector2 size, Vector2 offset)
 {
 	_size = size;
 	_offset = offset;
 
-	for (int x = 0; x < _size.X; x++) {
-		NodeColumn* column = new NodeColumn();
+	_grid.reserve(_size.X * _size.Y);
 
-		for (int y = 0; y < _size.Y; y++) {
-			column->push_back(new Node(Vector2(x, y)));
+	for (int y = 0; y < _size.Y; y++) {
+		for (int x = 0; x < _size.X; x++) {
+			_grid.push_back(Node(Vector2(x, y)));
 		}
-
-		_grid.push_back(column);
 	}
 }
 
 Vector2 NodeMap::GetSize()
 {
-	_sizeMutex.lock();
-	Vector2 size = _size;
-	_sizeMutex.unlock();
-
-	return size;
+	return _size;
 }
 
 void NodeMap::UnSafeDraw() //Este draw es unsafe ya que no usa mutex para proteger los nodes
 {
-	for (NodeColumn* column : _grid) {
-		for (Node* node : *column) {
-			node->DrawContent(_offset);
-		}
+	for (Node& node : _grid) {
+		node.DrawContent(_offset);
 	}
 }
 
 void NodeMap::SafePickNode(Vector2 position, SafePick safePickAction)
 {
-	_sizeMutex.lock();
-	_gridMutex.lock();
+	int index = GetNodeIndex(position);
 
-	Node* node = UnSafeGetNode(position);
-
-
-	_gridMutex.unlock();
-	_sizeMutex.unlock();
+	if (index < 0) {
+		safePickAction(nullptr);
+		return;
+	}
 
-	node->Lock();
-	safePickAction(node);
-	node->Unlock();
+	std::mutex& nodeLock = _nodeLocks[index % NODE_LOCK_STRIPES];
 
+	nodeLock.lock();
+	safePickAction(&_grid[index]);
+	nodeLock.unlock();
 }
 
 void NodeMap::SafeMultiPickNode(std::list<Vector2> positions, SafeMultiPick safeMultiPickAction)
 {
 	std::list<Node*> nodes = std::list<Node*>();
-
-	_sizeMutex.lock();
-	_gridMutex.lock();
+	std::vector<int> stripes;
 
 	for (Vector2 pos : positions) {
-		//Node* node = UnSafeGetNode(pos);
-		nodes.push_back(UnSafeGetNode(pos));
-	}
-
-	_gridMutex.unlock();
-	_sizeMutex.unlock();
+		int index = GetNodeIndex(pos);
 
-	_safeMultiPickNodeMutex.lock();
-
-	for (Node* node : nodes) {
-		if (node != nullptr) {
-			node->Lock();
+		if (index < 0) {
+			nodes.push_back(nullptr);
+			continue;
 		}
+
+		nodes.push_back(&_grid[index]);
+		stripes.push_back(index % NODE_LOCK_STRIPES);
 	}
 
-	_safeMultiPickNodeMutex.unlock();
+	//Bloquear siempre en el mismo orden y sin repetir, asi no hay deadlocks
+	std::sort(stripes.begin(), stripes.end());
+	stripes.erase(std::unique(stripes.begin(), stripes.end()), stripes.end());
+
+	for (int stripe : stripes) {
+		_nodeLocks[stripe].lock();
+	}
 
 	safeMultiPickAction(nodes);
 
-	for (Node* node : nodes) {
-		if (node != nullptr) {
-			node->Unlock();
-		}
+	for (int stripe : stripes) {
+		_nodeLocks[stripe].unlock();
 	}
 }
 
+int NodeMap::GetNodeIndex(Vector2 position)
+{
+	if (position.X >= _size.X || position.Y >= _size.Y || position.X < 0 || position.Y < 0) {
+		return -1;
+	}
+
+	return position.Y * _size.X + position.X;
+}
 
 Node* NodeMap::UnSafeGetNode(Vector2 position)
 {
-	if (position.X >= _size.X || position.Y >= _size.Y ||position.X < 0 || position.Y < 0) {
+	int index = GetNodeIndex(position);
+
+	if (index < 0) {
 		return nullptr;
 	}
 
-	NodeColumn* column = _grid[position.X]; //a la grid le cojo la posicin X para las columnas
-	Node* node = (*column)[position.Y]; //acceder a los datos de position.Y des de la lista de verdad
-
-	return node;
-	//return (*(_grid[position.X]))[position.Y];
-}
+	return &_grid[index];
+}
\ No newline at end of file
@@ -2,13 +2,17 @@
 #include <vector>
 #include <functional>
 #include <list>
+#include <mutex>
 
 #include "Node.h"
+
+#define NODE_LOCK_STRIPES 64
+
 class NodeMap
 {
 public:
-	typedef std::vector<Node*> NodeColumn;
-	typedef std::vector<NodeColumn*> NodeGrid;
+	//Grid row-major en un solo bloque contiguo: index = y * width + x
+	typedef std::vector<Node> NodeGrid;
 
 	typedef std::function<void(Node* node)> SafePick;
 	typedef std::function<void(std::list<Node*> nodes)> SafeMultiPick
@@ -25,14 +29,13 @@ private:
 
 	Vector2 _offset;
 
+	//El tamano y el grid no cambian despues del constructor, no necesitan mutex
 	Vector2 _size;
-	std::mutex _sizeMutex;
-
 	NodeGrid _grid;
-	std::mutex _gridMutex;
 
-	std::mutex _safeMultiPickNodeMutex;
+	//Cada node usa el mutex (index % NODE_LOCK_STRIPES)
+	std::mutex _nodeLocks[NODE_LOCK_STRIPES];
 
+	int GetNodeIndex(Vector2 position);
 	Node* UnSafeGetNode(Vector2 position);
 };
-
@@ -0,0 +1,193 @@
+#include "../Game/FlowField.h"
+#include "../Game/Wall.h"
+#include "../NodeMap/NodeMap.h"
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstdlib>
+
+// Follows the FlowField steps from the four corners of a walled room and checks that they reach
+// the target in exactly its BFS distance, at 20x10 (the game rooms), 200x200 and 1000x1000
+// Checked again after the target moves and after a wall is added (MarkObstaclesDirty)
+// Fails (exit code 1) if a walk enters a wall, is longer or shorter, or a distance is wrong
+
+// Room like the game's: a wall border and walls on some inner cells
+class TestRoom
+{
+public:
+    TestRoom(Vector2 size, int wallPercent) : _size(size), _map(size, Vector2(0, 0))
+    {
+        for (int y = 0; y < size.Y; y++)
+        {
+            for (int x = 0; x < size.X; x++)
+            {
+                bool border = x == 0 || y == 0 || x == size.X - 1 || y == size.Y - 1;
+                if (border || rand() % 100 < wallPercent)
+                    AddWall(Vector2(x, y));
+            }
+        }
+    }
+
+    NodeMap* GetMap() { return &_map; }
+
+    void AddWall(Vector2 position)
+    {
+        _walls.push_back(std::unique_ptr<Wall>(new Wall()));
+        Wall* wall = _walls.back().get();
+        _map.SafePickNode(position, [wall](Node* node) { node->SetContent(wall); });
+    }
+
+    void ClearCell(Vector2 position)
+    {
+        _map.SafePickNode(position, [](Node* node) { node->SetContent(nullptr); });
+    }
+
+    bool IsWall(Vector2 position)
+    {
+        bool wall = true;
+        _map.SafePickNode(position, [&wall](Node* node) { wall = node != nullptr && node->GetContent<Wall>() != nullptr; });
+        return wall;
+    }
+
+    // Reference BFS from target, -1 if it cannot be reached
+    int Distance(Vector2 from, Vector2 target)
+    {
+        std::vector<int> distance((size_t)_size.X * _size.Y, -1);
+        std::deque<Vector2> open;
+        distance[target.Y * _size.X + target.X] = 0;
+        open.push_back(target);
+
+        const Vector2 steps[] = { Vector2(0, -1), Vector2(0, 1), Vector2(-1, 0), Vector2(1, 0) };
+
+        while (!open.empty())
+        {
+            Vector2 cell = open.front();
+            open.pop_front();
+
+            int cellDistance = distance[cell.Y * _size.X + cell.X];
+            if (cell.X == from.X && cell.Y == from.Y)
+                return cellDistance;
+
+            for (Vector2 step : steps)
+            {
+                Vector2 next(cell.X + step.X, cell.Y + step.Y);
+                if (next.X < 0 || next.Y < 0 || next.X >= _size.X || next.Y >= _size.Y || IsWall(next))
+                    continue;
+
+                int& nextDistance = distance[next.Y * _size.X + next.X];
+                if (nextDistance < 0)
+                {
+                    nextDistance = cellDistance + 1;
+                    open.push_back(next);
+                }
+            }
+        }
+
+        return -1;
+    }
+
+private:
+    Vector2 _size;
+    NodeMap _map;
+    std::vector<std::unique_ptr<Wall>> _walls;
+};
+
+// Walks the steps from every inner corner, returns the wrong walks
+static int CheckCorners(TestRoom& room, FlowField& field, Vector2 size, Vector2 target, int& checked)
+{
+    const Vector2 corners[] = { Vector2(1, 1), Vector2(size.X - 2, 1), Vector2(1, size.Y - 2), Vector2(size.X - 2, size.Y - 2) };
+    int wrong = 0;
+
+    for (Vector2 corner : corners)
+    {
+        int expected = room.Distance(corner, target);
+        checked++;
+
+        if (field.GetDistance(corner) != (expected < 0 ? FlowField::UNREACHABLE : expected))
+        {
+            wrong++;
+            continue;
+        }
+
+        if (expected < 0)
+            continue;
+
+        Vector2 position = corner;
+        int steps = 0;
+
+        // A correct field never takes more than expected steps
+        while ((position.X != target.X || position.Y != target.Y) && steps <= expected)
+        {
+            Vector2 step = field.GetStep(position);
+            position = Vector2(position.X + step.X, position.Y + step.Y);
+            steps++;
+
+            if ((step.X == 0 && step.Y == 0) || room.IsWall(position))
+            {
+                steps = -1;
+                break;
+            }
+        }
+
+        if (steps != expected)
+            wrong++;
+    }
+
+    return wrong;
+}
+
+static int Run(Vector2 size, int& checked)
+{
+    TestRoom room(size, 15);
+
+    // The corners and the target are kept free, the rest of the room is random
+    const Vector2 corners[] = { Vector2(1, 1), Vector2(size.X - 2, 1), Vector2(1, size.Y - 2), Vector2(size.X - 2, size.Y - 2) };
+    for (Vector2 corner : corners)
+        room.ClearCell(corner);
+
+    Vector2 target(size.X / 2, size.Y / 2);
+    Vector2 movedTarget(size.X / 2 + 1, size.Y / 2);
+    room.ClearCell(target);
+    room.ClearCell(movedTarget);
+
+    FlowField field(room.GetMap());
+    int wrong = 0;
+
+    // First update (obstacles read from the map)
+    field.Update(target);
+    wrong += CheckCorners(room, field, size, target, checked);
+
+    // Target moved: BFS again with the same obstacles
+    field.Update(movedTarget);
+    wrong += CheckCorners(room, field, size, movedTarget, checked);
+
+    // A wall where the old target was, only seen after MarkObstaclesDirty()
+    room.AddWall(target);
+    field.MarkObstaclesDirty();
+    field.Update(movedTarget);
+    wrong += CheckCorners(room, field, size, movedTarget, checked);
+
+    return wrong;
+}
+
+int main()
+{
+    srand(1234);
+
+    bool passed = true;
+    const Vector2 sizes[] = { Vector2(20, 10), Vector2(200, 200), Vector2(1000, 1000) };
+
+    for (Vector2 size : sizes)
+    {
+        int checked = 0;
+        int wrong = Run(size, checked);
+
+        std::cout << size.X << "x" << size.Y << ": " << wrong << " of " << checked
+            << " walks wrong " << (wrong == 0 ? "OK" : "FAILED") << std::endl;
+
+        passed = passed && wrong == 0;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#include "../Game/SaveManager.h"
+#include "../Game/DungeonMap.h"
+#include "../Game/Player.h"
+#include "../Game/Room.h"
+#include "../Utils/ConsoleControl.h"
+#include "../Utils/GameConstants.h"
+#include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Counts the heap allocations of the load path, to check that no Json::Value subtree is copied
+// A copy of an entity object costs at least one allocation per member, so the allocations
+// that each extra entity adds to LoadGame() and Room::Decode() must stay under ENTITY_BUDGET
+// Fails (exit code 1) if they do not
+
+// Vector growth of the snapshots and the EntityStore, measured at 3.2 with nothing copied
+static const double ENTITY_BUDGET = 4.0;
+
+// Only allocations of the thread that measures (the prefetch thread is not part of the load)
+static thread_local bool t_counting = false;
+static std::atomic<long long> s_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    if (t_counting)
+        s_allocations++;
+
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+static const char* SAVE_PATH = "load_allocation_test.json";
+
+static void FillRoom(Room::Snapshot& room, int enemyCount, int chestCount, int itemCount)
+{
+    room.initialized = true;
+    int cell = 0;
+
+    // Distinct cells inside the walls of a 20x10 room
+    auto nextPosition = [&cell]() { Vector2 position(1 + cell % 18, 1 + cell / 18); cell++; return position; };
+
+    for (int i = 0; i < enemyCount; i++)
+        room.enemies.push_back({ nextPosition(), 30, 10 });
+    for (int i = 0; i < chestCount; i++)
+        room.chests.push_back({ nextPosition(), 20, false });
+    for (int i = 0; i < itemCount; i++)
+        room.items.push_back({ nextPosition(), ItemType::COIN });
+}
+
+static void WriteSave(int enemyCount, int chestCount, int itemCount)
+{
+    SaveManager::Snapshot snapshot;
+    snapshot.player = { Vector2(2, 2), 50, 50, 0, 1, 0 };
+    snapshot.currentX = 0;
+    snapshot.currentY = 0;
+    snapshot.worldWidth = WORLD_WIDTH;
+    snapshot.worldHeight = WORLD_HEIGHT;
+
+    for (int y = 0; y < WORLD_HEIGHT; y++)
+    {
+        for (int x = 0; x < WORLD_WIDTH; x++)
+        {
+            SaveManager::Snapshot::RoomEntry entry = { x, y, 0, Room::Snapshot(), SaveSegment() };
+            FillRoom(entry.room, enemyCount, chestCount, itemCount);
+            snapshot.rooms.push_back(entry);
+        }
+    }
+
+    SaveManager::WriteSnapshotFile(SAVE_PATH, snapshot, SaveFormat::JSON);
+}
+
+// Allocations of one LoadGame() of a save with that many entities per room
+static long long CountLoadGame(int enemyCount, int chestCount, int itemCount)
+{
+    WriteSave(enemyCount, chestCount, itemCount);
+    std::remove((std::string(SAVE_PATH) + ".journal").c_str());
+
+    DungeonMap dungeonMap(WORLD_WIDTH, WORLD_HEIGHT);
+    for (int y = 0; y < WORLD_HEIGHT; y++)
+    {
+        for (int x = 0; x < WORLD_WIDTH; x++)
+            dungeonMap.SetRoom(x, y, new Room(Vector2(20, 10), Vector2(0, 0)));
+    }
+
+    Player player;
+    SaveManager saveManager(SAVE_PATH, 10);
+
+    s_allocations = 0;
+    t_counting = true;
+    bool loaded = saveManager.LoadGame(&dungeonMap, &player);
+    t_counting = false;
+
+    saveManager.StopPrefetch();
+
+    if (!loaded)
+    {
+        std::cerr << "LoadGame failed" << std::endl;
+        std::exit(1);
+    }
+
+    return s_allocations;
+}
+
+// Allocations of one Room::Decode() of a room with that many entities
+static long long CountRoomDecode(int enemyCount, int chestCount, int itemCount)
+{
+    Room::Snapshot snapshot;
+    FillRoom(snapshot, enemyCount, chestCount, itemCount);
+
+    Room source(Vector2(20, 10), Vector2(0, 0));
+    source.ApplySnapshot(snapshot);
+    const Json::Value json = source.Code();
+
+    Room room(Vector2(20, 10), Vector2(0, 0));
+
+    s_allocations = 0;
+    t_counting = true;
+    room.Decode(json);
+    t_counting = false;
+
+    return s_allocations;
+}
+
+// Allocations of copying one encoded enemy, what a by-value Decode would add per entity
+static long long CountEntityCopy()
+{
+    Room::Snapshot snapshot;
+    FillRoom(snapshot, 1, 0, 0);
+
+    Room source(Vector2(20, 10), Vector2(0, 0));
+    source.ApplySnapshot(snapshot);
+    const Json::Value json = source.Code();
+    const Json::Value& enemyJson = json["enemies"][0];
+
+    s_allocations = 0;
+    t_counting = true;
+    Json::Value copy = enemyJson;
+    t_counting = false;
+
+    return copy.isObject() ? (long long)s_allocations : 0;
+}
+
+static bool Check(const char* name, long long small, long long large, int extraEntities)
+{
+    double perEntity = (double)(large - small) / extraEntities;
+    bool passed = perEntity <= ENTITY_BUDGET;
+
+    std::cout << name << ": " << small << " -> " << large << " allocations, "
+        << perEntity << " per extra entity (budget " << ENTITY_BUDGET << ") "
+        << (passed ? "OK" : "FAILED") << std::endl;
+
+    return passed;
+}
+
+int main()
+{
+    // LoadGame() writes to std::cout, headless keeps it quiet until the results
+    CC::SetHeadless(true);
+
+    // 3 -> 16 entities per room, the pools hold ROOM_ENTITY_CAPACITY without allocating
+    long long loadSmall = CountLoadGame(1, 1, 1);
+    long long loadLarge = CountLoadGame(12, 2, 2);
+    long long decodeSmall = CountRoomDecode(1, 1, 1);
+    long long decodeLarge = CountRoomDecode(12, 2, 2);
+
+    long long copyCost = CountEntityCopy();
+
+    CC::SetHeadless(false);
+
+    std::cout << "Copy of one encoded enemy: " << copyCost << " allocations" << std::endl;
+
+    bool passed = Check("LoadGame", loadSmall, loadLarge, 13 * WORLD_WIDTH * WORLD_HEIGHT);
+    passed = Check("Room::Decode", decodeSmall, decodeLarge, 13) && passed;
+
+    std::remove(SAVE_PATH);
+    std::remove((std::string(SAVE_PATH) + ".journal").c_str());
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+#include "../Game/PathService.h"
+#include "../NodeMap/NodeMap.h"
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cstdlib>
+
+// Checks every path of the PathService against a reference BFS, before and after cells change
+// The cached pairs are queried again after each change, so most answers are LPA* repairs
+// (PathSearch::ComputeShortestPath/ExtractPath on a search that already ran)
+// Fails (exit code 1) if a path is invalid, not the shortest, or found/not found wrongly
+
+static const int PAIR_COUNT = 24;     // Fewer than PATH_CACHE_CAPACITY, every pair stays cached
+static const int ROUND_COUNT = 12;
+static const int TOGGLES_PER_ROUND = 6;
+
+// Distance from start to goal with the same rules as PathSearch (entering a blocked cell is not
+// allowed, leaving one is), -1 if it cannot be reached
+static int ReferenceDistance(const PathService& service, Vector2 size, Vector2 start, Vector2 goal)
+{
+    if (service.IsBlocked(goal))
+        return -1;
+
+    std::vector<int> distance((size_t)size.X * size.Y, -1);
+    std::deque<Vector2> open;
+    distance[start.Y * size.X + start.X] = 0;
+    open.push_back(start);
+
+    const Vector2 steps[] = { Vector2(0, -1), Vector2(0, 1), Vector2(-1, 0), Vector2(1, 0) };
+
+    while (!open.empty())
+    {
+        Vector2 cell = open.front();
+        open.pop_front();
+
+        int cellDistance = distance[cell.Y * size.X + cell.X];
+        if (cell.X == goal.X && cell.Y == goal.Y)
+            return cellDistance;
+
+        for (Vector2 step : steps)
+        {
+            Vector2 next(cell.X + step.X, cell.Y + step.Y);
+            if (next.X < 0 || next.Y < 0 || next.X >= size.X || next.Y >= size.Y || service.IsBlocked(next))
+                continue;
+
+            int& nextDistance = distance[next.Y * size.X + next.X];
+            if (nextDistance < 0)
+            {
+                nextDistance = cellDistance + 1;
+                open.push_back(next);
+            }
+        }
+    }
+
+    return -1;
+}
+
+// The path walks free neighbour cells from start to goal and has the BFS length
+static bool IsCorrect(const PathService& service, Vector2 size, Vector2 start, Vector2 goal, bool found, const std::vector<Vector2>& path)
+{
+    int expected = ReferenceDistance(service, size, start, goal);
+
+    if (!found)
+        return expected < 0;
+
+    if (expected < 0 || (int)path.size() != expected)
+        return false;
+
+    Vector2 previous = start;
+    for (Vector2 cell : path)
+    {
+        if (abs(cell.X - previous.X) + abs(cell.Y - previous.Y) != 1 || service.IsBlocked(cell))
+            return false;
+        previous = cell;
+    }
+
+    return previous.X == goal.X && previous.Y == goal.Y;
+}
+
+static Vector2 RandomCell(Vector2 size)
+{
+    return Vector2(rand() % size.X, rand() % size.Y);
+}
+
+// Returns the wrong answers, checked is increased by the answers checked
+static int Run(Vector2 size, int obstaclePercent, int& checked)
+{
+    NodeMap map(size, Vector2(0, 0));
+    PathService service(&map);
+
+    for (int y = 0; y < size.Y; y++)
+    {
+        for (int x = 0; x < size.X; x++)
+            service.SetBlocked(Vector2(x, y), rand() % 100 < obstaclePercent);
+    }
+
+    std::vector<PathService::PathQuery> queries;
+    for (int i = 0; i < PAIR_COUNT; i++)
+    {
+        queries.push_back({ RandomCell(size), RandomCell(size) });
+    }
+
+    int wrong = 0;
+    std::vector<Vector2> path;
+
+    for (int round = 0; round < ROUND_COUNT; round++)
+    {
+        // Odd rounds go through the worker threads
+        if (round % 2 == 1)
+        {
+            std::vector<PathService::PathResult> results;
+            service.Start(2);
+            service.FindPaths(queries, results);
+            service.Stop();
+
+            for (size_t i = 0; i < queries.size(); i++)
+            {
+                wrong += !IsCorrect(service, size, queries[i].start, queries[i].goal, results[i].found, results[i].path);
+                checked++;
+            }
+        }
+        else
+        {
+            for (const PathService::PathQuery& query : queries)
+            {
+                bool found = service.FindPath(query.start, query.goal, path);
+                wrong += !IsCorrect(service, size, query.start, query.goal, found, path);
+                checked++;
+            }
+        }
+
+        // Half of the changes on the current paths, so the repairs have something to do
+        for (int i = 0; i < TOGGLES_PER_ROUND; i++)
+        {
+            Vector2 cell = RandomCell(size);
+
+            if (i % 2 == 0)
+            {
+                const PathService::PathQuery& query = queries[rand() % queries.size()];
+                if (service.FindPath(query.start, query.goal, path) && !path.empty())
+                    cell = path[rand() % path.size()];
+            }
+
+            service.SetBlocked(cell, !service.IsBlocked(cell));
+        }
+    }
+
+    return wrong;
+}
+
+int main()
+{
+    srand(1234);
+
+    bool passed = true;
+
+    struct Case { Vector2 size; int obstaclePercent; };
+    const Case cases[] = { { Vector2(20, 10), 10 }, { Vector2(200, 200), 20 } };
+
+    for (const Case& testCase : cases)
+    {
+        int checked = 0;
+        int wrong = Run(testCase.size, testCase.obstaclePercent, checked);
+
+        std::cout << testCase.size.X << "x" << testCase.size.Y << ": " << wrong << " of " << checked
+            << " paths wrong " << (wrong == 0 ? "OK" : "FAILED") << std::endl;
+
+        passed = passed && wrong == 0;
+    }
+
+    return passed ? 0 : 1;
+}
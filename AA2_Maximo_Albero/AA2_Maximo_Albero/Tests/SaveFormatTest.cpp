@@ -0,0 +1,234 @@
+#include "../Game/SaveManager.h"
+#include "../Game/BinarySaveFormat.h"
+#include "../Game/DungeonMap.h"
+#include "../Game/Player.h"
+#include "../Game/Room.h"
+#include "../Utils/ConsoleControl.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+// Round trip of a save through the game's --convert-save, and format detection on load
+//   SaveFormatTest <path of AA2_Maximo_Albero>
+// A JSON save is converted by the game executable, the binary file must hold the same snapshot
+// ReadSnapshotFile() and LoadGame() must read both files by their contents, whatever the
+// file name or the format set in the SaveManager
+// Fails (exit code 1) on any difference, or if a missing or corrupt save does not fail cleanly
+
+static const char* JSON_PATH = "save_format_test.json";
+static const char* BINARY_PATH = "save_format_test.bin";
+// Binary contents under a .json name, detection must not trust the extension
+static const char* RENAMED_PATH = "save_format_test_renamed.json";
+static const char* CORRUPT_PATH = "save_format_test_corrupt.bin";
+
+static const int WORLD_SIDE = 4;
+
+static int s_failures = 0;
+
+static void Check(bool passed, const std::string& name)
+{
+    std::cout << name << ": " << (passed ? "OK" : "FAILED") << std::endl;
+    if (!passed)
+        s_failures++;
+}
+
+static bool SamePosition(Vector2 a, Vector2 b)
+{
+    return a.X == b.X && a.Y == b.Y;
+}
+
+// Every room has a different mix, so a room written in the wrong place is caught
+static SaveManager::Snapshot MakeWorld()
+{
+    SaveManager::Snapshot snapshot;
+    snapshot.player = { Vector2(3, 4), 37, 60, 15, 2, 1 };
+    snapshot.currentX = 1;
+    snapshot.currentY = 2;
+    snapshot.worldWidth = WORLD_SIDE;
+    snapshot.worldHeight = WORLD_SIDE;
+
+    for (int y = 0; y < WORLD_SIDE; y++)
+    {
+        for (int x = 0; x < WORLD_SIDE; x++)
+        {
+            int index = y * WORLD_SIDE + x;
+            SaveManager::Snapshot::RoomEntry entry = { x, y, 1, Room::Snapshot(), SaveSegment() };
+            entry.room.initialized = index % 5 != 0;
+
+            for (int i = 0; i < index % 4; i++)
+                entry.room.enemies.push_back({ Vector2(1 + i, 1 + index % 8), 10 + index, 3 + i });
+            // A broken chest is saved with 0 hp, as Chest::GetSnapshot() gives it
+            for (int i = 0; i < index % 3; i++)
+                entry.room.chests.push_back({ Vector2(10 + i, 2), i == 1 ? 0 : 20, i == 1 });
+            for (int i = 0; i < index % 2 + 1; i++)
+                entry.room.items.push_back({ Vector2(15, 1 + i), (ItemType)((index + i) % 3) });
+
+            snapshot.rooms.push_back(entry);
+        }
+    }
+
+    return snapshot;
+}
+
+static bool SameRoom(const Room::Snapshot& a, const Room::Snapshot& b)
+{
+    if (a.initialized != b.initialized || a.enemies.size() != b.enemies.size() ||
+        a.chests.size() != b.chests.size() || a.items.size() != b.items.size())
+        return false;
+
+    for (size_t i = 0; i < a.enemies.size(); i++)
+    {
+        if (!SamePosition(a.enemies[i].position, b.enemies[i].position) ||
+            a.enemies[i].hp != b.enemies[i].hp || a.enemies[i].damage != b.enemies[i].damage)
+            return false;
+    }
+
+    for (size_t i = 0; i < a.chests.size(); i++)
+    {
+        if (!SamePosition(a.chests[i].position, b.chests[i].position) ||
+            a.chests[i].hp != b.chests[i].hp || a.chests[i].broken != b.chests[i].broken)
+            return false;
+    }
+
+    for (size_t i = 0; i < a.items.size(); i++)
+    {
+        if (!SamePosition(a.items[i].position, b.items[i].position) || a.items[i].type != b.items[i].type)
+            return false;
+    }
+
+    return true;
+}
+
+static bool SamePlayer(const Player::Snapshot& a, const Player::Snapshot& b)
+{
+    return SamePosition(a.position, b.position) && a.hp == b.hp && a.maxHp == b.maxHp &&
+        a.coins == b.coins && a.potionCount == b.potionCount && a.weapon == b.weapon;
+}
+
+static bool SameSnapshot(const SaveManager::Snapshot& a, const SaveManager::Snapshot& b)
+{
+    if (!SamePlayer(a.player, b.player) || a.currentX != b.currentX || a.currentY != b.currentY ||
+        a.worldWidth != b.worldWidth || a.worldHeight != b.worldHeight || a.rooms.size() != b.rooms.size())
+        return false;
+
+    for (size_t i = 0; i < a.rooms.size(); i++)
+    {
+        if (a.rooms[i].x != b.rooms[i].x || a.rooms[i].y != b.rooms[i].y || !SameRoom(a.rooms[i].room, b.rooms[i].room))
+            return false;
+    }
+
+    return true;
+}
+
+static std::string ReadFile(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+static void WriteFile(const char* path, const std::string& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.c_str(), data.size());
+}
+
+static int RunGame(const std::string& gamePath, const std::string& arguments)
+{
+    std::string command = "\"" + gamePath + "\" " + arguments;
+    return std::system(command.c_str());
+}
+
+// LoadGame() of path into a new world, with the SaveManager set to the other format
+static bool LoadGameMatches(const char* path, SaveFormat configuredFormat, const SaveManager::Snapshot& expected)
+{
+    DungeonMap dungeonMap(WORLD_SIDE, WORLD_SIDE);
+    for (int y = 0; y < WORLD_SIDE; y++)
+    {
+        for (int x = 0; x < WORLD_SIDE; x++)
+            dungeonMap.SetRoom(x, y, new Room(Vector2(20, 10), Vector2(0, 0)));
+    }
+
+    Player player;
+    SaveManager saveManager(path, 10);
+    saveManager.SetSaveFormat(configuredFormat);
+
+    // LoadGame() writes to std::cout, headless keeps it quiet
+    CC::SetHeadless(true);
+    bool loaded = saveManager.LoadGame(&dungeonMap, &player);
+
+    // Lazy rooms of a binary save are decoded as the game does when they are entered
+    for (int y = 0; loaded && y < WORLD_SIDE; y++)
+    {
+        for (int x = 0; x < WORLD_SIDE; x++)
+            saveManager.LoadPendingRoom(dungeonMap.GetRoom(x, y));
+    }
+
+    saveManager.StopPrefetch();
+    CC::SetHeadless(false);
+    std::remove((std::string(path) + ".journal").c_str());
+
+    if (!loaded || !SamePlayer(player.GetSnapshot(), expected.player) ||
+        dungeonMap.GetActiveRoom() != dungeonMap.GetRoom(expected.currentX, expected.currentY))
+        return false;
+
+    for (const SaveManager::Snapshot::RoomEntry& entry : expected.rooms)
+    {
+        if (!SameRoom(dungeonMap.GetRoom(entry.x, entry.y)->GetSnapshot(), entry.room))
+            return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: SaveFormatTest <path of AA2_Maximo_Albero>" << std::endl;
+        return 1;
+    }
+
+    std::string gamePath = argv[1];
+    SaveManager::Snapshot world = MakeWorld();
+
+    Check(SaveManager::WriteSnapshotFile(JSON_PATH, world, SaveFormat::JSON), "Write JSON save");
+    std::remove(BINARY_PATH);
+
+    // Conversion by the game executable
+    Check(RunGame(gamePath, std::string("--convert-save ") + JSON_PATH + " " + BINARY_PATH) == 0, "--convert-save exit code");
+
+    std::string binary = ReadFile(BINARY_PATH);
+    Check(BinarySaveFormat::IsBinary(binary) && !BinarySaveFormat::IsBinary(ReadFile(JSON_PATH)), "--convert-save writes the binary format");
+
+    SaveManager::Snapshot fromJson;
+    SaveManager::Snapshot fromBinary;
+    Check(SaveManager::ReadSnapshotFile(JSON_PATH, fromJson) && SameSnapshot(fromJson, world), "JSON detected and read back");
+    Check(SaveManager::ReadSnapshotFile(BINARY_PATH, fromBinary) && SameSnapshot(fromBinary, world), "Binary detected and read back");
+
+    WriteFile(RENAMED_PATH, binary);
+    SaveManager::Snapshot fromRenamed;
+    Check(SaveManager::ReadSnapshotFile(RENAMED_PATH, fromRenamed) && SameSnapshot(fromRenamed, world), "Binary under a .json name detected");
+
+    // The SaveManager format only chooses how to save, loading follows the file
+    Check(LoadGameMatches(JSON_PATH, SaveFormat::BINARY, world), "LoadGame of the JSON save (binary configured)");
+    Check(LoadGameMatches(BINARY_PATH, SaveFormat::JSON, world), "LoadGame of the converted save (JSON configured)");
+
+    // Errors: a missing source, and a binary file cut in half
+    Check(RunGame(gamePath, std::string("--convert-save save_format_test_missing.json ") + CORRUPT_PATH) != 0, "--convert-save of a missing file fails");
+
+    WriteFile(CORRUPT_PATH, binary.substr(0, binary.size() / 2));
+    SaveManager::Snapshot fromCorrupt;
+    Check(!SaveManager::ReadSnapshotFile(CORRUPT_PATH, fromCorrupt), "Truncated binary save rejected");
+
+    std::remove(JSON_PATH);
+    std::remove(BINARY_PATH);
+    std::remove(RENAMED_PATH);
+    std::remove(CORRUPT_PATH);
+
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include "ByteStream.h"
+
+// ===== WRITER =====
+
+void ByteWriter::WriteU8(uint8_t value)
+{
+	_output.push_back((char)value);
+}
+
+void ByteWriter::WriteU16(uint16_t value)
+{
+	_output.push_back((char)(value & 0xFF));
+	_output.push_back((char)((value >> 8) & 0xFF));
+}
+
+void ByteWriter::WriteU32(uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		_output.push_back((char)((value >> (i * 8)) & 0xFF));
+	}
+}
+
+void ByteWriter::WriteI32(int32_t value)
+{
+	WriteU32((uint32_t)value);
+}
+
+void ByteWriter::WriteU64(uint64_t value)
+{
+	WriteU32((uint32_t)(value & 0xFFFFFFFF));
+	WriteU32((uint32_t)(value >> 32));
+}
+
+void ByteWriter::WriteBytes(const char* bytes, size_t size)
+{
+	_output.append(bytes, size);
+}
+
+void ByteWriter::PatchU32(size_t offset, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		_output[offset + i] = (char)((value >> (i * 8)) & 0xFF);
+	}
+}
+
+// ===== READER =====
+
+bool ByteReader::ReadU8(uint8_t& value)
+{
+	if (GetRemaining() < 1)
+		return false;
+
+	value = (uint8_t)_data[_offset++];
+	return true;
+}
+
+bool ByteReader::ReadU16(uint16_t& value)
+{
+	if (GetRemaining() < 2)
+		return false;
+
+	const unsigned char* bytes = (const unsigned char*)_data + _offset;
+	value = (uint16_t)(bytes[0] | (bytes[1] << 8));
+	_offset += 2;
+	return true;
+}
+
+bool ByteReader::ReadU32(uint32_t& value)
+{
+	if (GetRemaining() < 4)
+		return false;
+
+	const unsigned char* bytes = (const unsigned char*)_data + _offset;
+	value = (uint32_t)bytes[0]
+		| ((uint32_t)bytes[1] << 8)
+		| ((uint32_t)bytes[2] << 16)
+		| ((uint32_t)bytes[3] << 24);
+	_offset += 4;
+	return true;
+}
+
+bool ByteReader::ReadI32(int32_t& value)
+{
+	uint32_t raw;
+	if (!ReadU32(raw))
+		return false;
+
+	value = (int32_t)raw;
+	return true;
+}
+
+bool ByteReader::ReadU64(uint64_t& value)
+{
+	if (GetRemaining() < 8)
+		return false;
+
+	uint32_t low, high;
+	if (!ReadU32(low) || !ReadU32(high))
+		return false;
+
+	value = (uint64_t)low | ((uint64_t)high << 32);
+	return true;
+}
+
+bool ByteReader::Skip(size_t size)
+{
+	if (GetRemaining() < size)
+		return false;
+
+	_offset += size;
+	return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Little-endian integer writer over a std::string, independent of the host byte order
+class ByteWriter
+{
+public:
+	ByteWriter(std::string& output) : _output(output) {}
+
+	void WriteU8(uint8_t value);
+	void WriteU16(uint16_t value);
+	void WriteU32(uint32_t value);
+	void WriteI32(int32_t value);
+	void WriteU64(uint64_t value);
+	void WriteBytes(const char* bytes, size_t size);
+
+	size_t GetSize() const { return _output.size(); }
+
+	//Sobrescribe un U32 ya escrito (prefijos de longitud que se conocen al final)
+	void PatchU32(size_t offset, uint32_t value);
+
+private:
+	std::string& _output;
+};
+
+// Little-endian integer reader with bounds checking
+// Every Read* returns false (and leaves value untouched) if there are not enough bytes
+class ByteReader
+{
+public:
+	ByteReader(const char* data, size_t size) : _data(data), _size(size), _offset(0) {}
+
+	bool ReadU8(uint8_t& value);
+	bool ReadU16(uint16_t& value);
+	bool ReadU32(uint32_t& value);
+	bool ReadI32(int32_t& value);
+	bool ReadU64(uint64_t& value);
+	bool Skip(size_t size);
+
+	size_t GetOffset() const { return _offset; }
+	size_t GetRemaining() const { return _size - _offset; }
+	const char* GetCurrent() const { return _data + _offset; }
+
+private:
+	const char* _data;
+	size_t _size;
+	size_t _offset;
+};
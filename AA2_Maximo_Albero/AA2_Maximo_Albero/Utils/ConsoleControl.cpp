@@ -1,94 +1,119 @@
 #include "ConsoleControl.h"
+#include "GameConstants.h"
+
+//Sink de std::cout en modo headless
+class NullOutputBuffer : public std::streambuf
+{
+protected:
+	int_type overflow(int_type character) override { return character; }
+	std::streamsize xsputn(const char*, std::streamsize size) override { return size; }
+};
 
 
 ConsoleControl ConsoleControl::GetInstance()
 {
-	static ConsoleControl instance;
+	static ConsoleControl instance = []() {
+		ConsoleControl control;
+		control._frameBuffer = new FrameBuffer(MAP_WIDTH, MAP_HEIGHT);
+
+		InitializeBackend(control);
+
+		return control;
+	}();
 
 	return instance;
 }
 
-HANDLE ConsoleControl::GetConsole()
-{
-	return GetInstance()._console;
-}
+void ConsoleControl::Clear() {
+	std::cout << "\033[2J\033[1;1H"; //Comanda directa a la consola que neteja la pantalla
 
-void ConsoleControl::SetColor(ConsoleColor textColor, ConsoleColor backgroundColor) {
-	WORD color = (backgroundColor << 4) | textColor;
-	SetConsoleTextAttribute(GetConsole(), color);
+	//La pantalla ya no coincide con el front buffer, el siguiente Present() lo redibuja todo
+	FrameBuffer* frameBuffer = GetInstance()._frameBuffer;
+	frameBuffer->Lock();
+	frameBuffer->Invalidate();
+	frameBuffer->Unlock();
 }
 
-void ConsoleControl::SetPosition(short int x, short int y) {
-	COORD pos{ x, y };
-	SetConsoleCursorPosition(GetConsole(), pos);
+void ConsoleControl::Lock()
+{
+	GetInstance()._consoleMutex->lock();
 }
 
-void ConsoleControl::Clear() {
-	std::cout << "\033[2J\033[1;1H"; //Comanda directa a la consola que neteja la pantalla
+void ConsoleControl::Unlock()
+{
+	//Todo lo escrito dentro del lock sale junto
+	FlushOutput();
+	GetInstance()._consoleMutex->unlock();
 }
 
-void ConsoleControl::FillWithCharacter(char character, ConsoleColor textColor, ConsoleColor backgroundColor)
+void ConsoleControl::DrawCell(short int x, short int y, char glyph, ConsoleColor textColor, ConsoleColor backgroundColor)
 {
-	COORD topLeft = { 0,0 };
-	CONSOLE_SCREEN_BUFFER_INFO screen;
-	DWORD written;
-	HANDLE console = GetConsole();
-
-	WORD color = (backgroundColor << 4) | textColor;
-	GetConsoleScreenBufferInfo(console, &screen);
-	FillConsoleOutputCharacterA(
-		console, character, screen.dwSize.X * screen.dwSize.Y, topLeft,	&written);
-	FillConsoleOutputAttribute(
-		console, color, screen.dwSize.X * screen.dwSize.Y, topLeft, &written);
-	SetConsoleCursorPosition(console, topLeft);
+	FrameBuffer* frameBuffer = GetInstance()._frameBuffer;
+
+	frameBuffer->Lock();
+	frameBuffer->SetCell(x, y, glyph, (unsigned char)textColor, (unsigned char)backgroundColor);
+	frameBuffer->Unlock();
 }
 
-void ConsoleControl::ClearKeyBuffer()
+void ConsoleControl::Present()
 {
-	while (_kbhit())
+	ConsoleControl instance = GetInstance();
+	std::string frame;
+
+	//Orden de locks: consola -> frame buffer, asi dos Present() no se pueden adelantar
+	Lock();
+	instance._frameBuffer->Lock();
+
+	int changed = instance._frameBuffer->BuildFrame(frame);
+
+	instance._frameBuffer->Unlock();
+
+	if (changed > 0)
 	{
-		_getch();
+		WriteRaw(frame);
+
+		instance._lastFrameStats->cellsChanged = changed;
+		instance._lastFrameStats->bytesWritten = (int)frame.size();
+		instance._lastFrameStats->writeCalls = 1;
 	}
+
+	Unlock();
 }
 
-int ConsoleControl::ReadNextKey()
+FrameBuffer::FrameStats ConsoleControl::GetLastFrameStats()
 {
-	int KB_code = 0;
-
-	while (KB_code == 0)
-	{
-		if (_kbhit())
-		{
-			KB_code = _getch();
-		}
-	}
-	
+	Lock();
+	FrameBuffer::FrameStats stats = *GetInstance()._lastFrameStats;
+	Unlock();
 
-	return KB_code;
+	return stats;
 }
 
-char ConsoleControl::WaitForReadNextChar()
+void ConsoleControl::SetHeadless(bool headless)
 {
-	char c = 0;
+	static NullOutputBuffer nullOutput;
+	ConsoleControl instance = GetInstance();
 
-	while (c == 0)
+	Lock();
+
+	if (*instance._headless != headless)
 	{
-		if (_kbhit())
+		if (headless)
 		{
-			c = _getch();
+			*instance._savedOutput = std::cout.rdbuf(&nullOutput);
+		}
+		else
+		{
+			std::cout.rdbuf(*instance._savedOutput);
 		}
-	}
-
 
-	return c;
-}
+		*instance._headless = headless;
+	}
 
-void ConsoleControl::Lock()
-{
-	GetInstance()._consoleMutex->lock();
+	Unlock();
 }
 
-void ConsoleControl::Unlock()
+bool ConsoleControl::IsHeadless()
 {
-	GetInstance()._consoleMutex->unlock();
+	return *GetInstance()._headless;
 }
\ No newline at end of file
@@ -1,19 +1,46 @@
 #pragma once
 #include <mutex>
+#include <atomic>
 #include <iostream>
 #include <sstream>
+#include "FrameBuffer.h"
+
+#ifdef _WIN32
 #include <Windows.h>
 #include <conio.h>
-
-static class ConsoleControl
+#else
+class ConsoleOutputBuffer;
+#endif
+
+//Interfaz estatica de la consola con dos backends:
+//  - ConsoleControlWin.cpp: API de consola de Windows (_WIN32)
+//  - ConsoleControlAnsi.cpp: secuencias ANSI + termios (Linux), toda la salida
+//    se acumula en memoria y se escribe con un solo write(2) en Unlock()
+class ConsoleControl
 {
 private:
+#ifdef _WIN32
 	HANDLE _console = GetStdHandle(STD_OUTPUT_HANDLE);
+#else
+	ConsoleOutputBuffer* _output = nullptr;
+#endif
 	std::mutex* _consoleMutex = new std::mutex;
+	std::atomic<bool>* _headless = new std::atomic<bool>(false);
+	std::streambuf** _savedOutput = new std::streambuf*(nullptr);
+	FrameBuffer* _frameBuffer;
+	FrameBuffer::FrameStats* _lastFrameStats = new FrameBuffer::FrameStats;
 	static ConsoleControl GetInstance();
 
+#ifdef _WIN32
 	static HANDLE GetConsole();
+#endif
+
+	// ===== BACKEND =====
+	static void InitializeBackend(ConsoleControl& control);
 
+	static void WriteRaw(const std::string& text);
+
+	static void FlushOutput();
 
 	
 public:
@@ -35,6 +62,13 @@ public:
 
 	static int ReadNextKey();
 
+	//Espera una tecla sin consumir CPU (poll / WaitForMultipleObjects)
+	//Devuelve 0 si pasa timeoutMs (-1 = sin limite) o si se llama a WakeInput()
+	static int ReadNextKey(int timeoutMs);
+
+	//Despierta a quien este esperando en ReadNextKey(timeoutMs)
+	static void WakeInput();
+
 	static int WaitForReadNextKey();
 
 	static char WaitForReadNextChar();
@@ -42,6 +76,21 @@ public:
 	static void Lock();
 
 	static void Unlock();
+
+	// ===== FRAME BUFFER =====
+	//Escribe una celda en el back buffer, no toca la consola hasta Present()
+	static void DrawCell(short int x, short int y, char glyph, ConsoleColor textColor = WHITE, ConsoleColor backgroundColor = BLACK);
+
+	//Escribe en un solo write las celdas que han cambiado desde el ultimo Present()
+	static void Present();
+
+	static FrameBuffer::FrameStats GetLastFrameStats();
+
+	// ===== HEADLESS =====
+	//Sin terminal: todo lo que se dibuja o se escribe con std::cout se descarta
+	static void SetHeadless(bool headless);
+
+	static bool IsHeadless();
 };
 
 
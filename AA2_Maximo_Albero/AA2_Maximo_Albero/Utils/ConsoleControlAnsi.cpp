@@ -0,0 +1,272 @@
+#ifndef _WIN32
+#include "ConsoleControl.h"
+#include <streambuf>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+
+//Backend ANSI/termios para Linux
+//SetColor, SetPosition y todo lo que se escribe con std::cout se acumula en
+//ConsoleOutputBuffer y se envia con un solo write(2) al hacer CC::Unlock() o flush
+
+class ConsoleOutputBuffer : public std::streambuf
+{
+public:
+	void Append(const char* text, size_t size)
+	{
+		_bufferMutex.lock();
+		_buffer.append(text, size);
+		_bufferMutex.unlock();
+	}
+
+	void Append(const std::string& text)
+	{
+		Append(text.c_str(), text.size());
+	}
+
+	void Flush()
+	{
+		_bufferMutex.lock();
+
+		size_t offset = 0;
+		while (offset < _buffer.size())
+		{
+			ssize_t written = ::write(STDOUT_FILENO, _buffer.c_str() + offset, _buffer.size() - offset);
+			if (written <= 0)
+				break;
+
+			offset += written;
+		}
+
+		_buffer.clear();
+		_bufferMutex.unlock();
+	}
+
+	void Discard()
+	{
+		_bufferMutex.lock();
+		_buffer.clear();
+		_bufferMutex.unlock();
+	}
+
+protected:
+	int_type overflow(int_type character) override
+	{
+		if (character != traits_type::eof())
+		{
+			char c = (char)character;
+			Append(&c, 1);
+		}
+
+		return character;
+	}
+
+	std::streamsize xsputn(const char* text, std::streamsize size) override
+	{
+		Append(text, (size_t)size);
+		return size;
+	}
+
+	int sync() override
+	{
+		Flush();
+		return 0;
+	}
+
+private:
+	std::string _buffer;
+	std::mutex _bufferMutex;
+};
+
+static termios originalTerminal;
+static bool terminalIsRaw = false;
+static ConsoleOutputBuffer* outputBuffer = nullptr;
+
+//Self-pipe: WakeInput() escribe un byte para despertar el poll() de ReadNextKey()
+static int wakePipe[2] = { -1, -1 };
+static bool stdinClosed = false;
+
+static void RestoreTerminal()
+{
+	if (outputBuffer != nullptr && isatty(STDOUT_FILENO))
+	{
+		outputBuffer->Append("\033[0m\033[?25h");
+		outputBuffer->Flush();
+	}
+
+	if (terminalIsRaw)
+	{
+		tcsetattr(STDIN_FILENO, TCSANOW, &originalTerminal);
+		terminalIsRaw = false;
+	}
+}
+
+void ConsoleControl::InitializeBackend(ConsoleControl& control)
+{
+	control._output = new ConsoleOutputBuffer();
+	outputBuffer = control._output;
+
+	//std::cout escribe en el buffer en memoria
+	std::cout.rdbuf(control._output);
+
+	//Entrada sin eco y tecla a tecla, como _getch()
+	if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &originalTerminal) == 0)
+	{
+		termios raw = originalTerminal;
+		raw.c_lflag &= ~(ICANON | ECHO);
+		raw.c_cc[VMIN] = 1;
+		raw.c_cc[VTIME] = 0;
+
+		if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0)
+			terminalIsRaw = true;
+	}
+
+	atexit(RestoreTerminal);
+
+	if (pipe(wakePipe) == 0)
+	{
+		fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+		fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+	}
+}
+
+void ConsoleControl::SetColor(ConsoleColor textColor, ConsoleColor backgroundColor) {
+	std::string sequence = "\033[";
+	FrameBuffer::AppendNumber(sequence, FrameBuffer::ToAnsiColor((unsigned char)textColor));
+	sequence += ';';
+	FrameBuffer::AppendNumber(sequence, FrameBuffer::ToAnsiColor((unsigned char)backgroundColor) + 10);
+	sequence += 'm';
+
+	GetInstance()._output->Append(sequence);
+}
+
+void ConsoleControl::SetPosition(short int x, short int y) {
+	std::string sequence = "\033[";
+	FrameBuffer::AppendNumber(sequence, y + 1);
+	sequence += ';';
+	FrameBuffer::AppendNumber(sequence, x + 1);
+	sequence += 'H';
+
+	GetInstance()._output->Append(sequence);
+}
+
+void ConsoleControl::FillWithCharacter(char character, ConsoleColor textColor, ConsoleColor backgroundColor)
+{
+	winsize screen;
+	int columns = 80;
+	int rows = 25;
+
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &screen) == 0 && screen.ws_col > 0)
+	{
+		columns = screen.ws_col;
+		rows = screen.ws_row;
+	}
+
+	SetColor(textColor, backgroundColor);
+	SetPosition(0, 0);
+	GetInstance()._output->Append(std::string(columns * rows, character));
+	SetPosition(0, 0);
+	FlushOutput();
+}
+
+void ConsoleControl::ClearKeyBuffer()
+{
+	tcflush(STDIN_FILENO, TCIFLUSH);
+}
+
+int ConsoleControl::ReadNextKey()
+{
+	int key = 0;
+
+	while (key == 0)
+	{
+		key = ReadNextKey(-1);
+	}
+
+	return key;
+}
+
+int ConsoleControl::ReadNextKey(int timeoutMs)
+{
+	GetInstance(); //El self-pipe se crea en InitializeBackend
+
+	pollfd fds[2];
+	int count = 0;
+
+	fds[count].fd = wakePipe[0];
+	fds[count].events = POLLIN;
+	count++;
+
+	//Con stdin cerrado (EOF) solo se espera a WakeInput() o al timeout
+	if (!stdinClosed)
+	{
+		fds[count].fd = STDIN_FILENO;
+		fds[count].events = POLLIN;
+		count++;
+	}
+
+	int ready = poll(fds, count, timeoutMs);
+	if (ready <= 0)
+		return 0;
+
+	if (fds[0].revents & POLLIN)
+	{
+		char drain[16];
+		while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+		return 0;
+	}
+
+	if (count > 1 && (fds[1].revents & (POLLIN | POLLHUP)))
+	{
+		unsigned char key = 0;
+		if (read(STDIN_FILENO, &key, 1) == 1)
+			return key;
+
+		stdinClosed = true;
+	}
+
+	return 0;
+}
+
+void ConsoleControl::WakeInput()
+{
+	GetInstance();
+
+	if (wakePipe[1] < 0)
+		return;
+
+	char wake = 1;
+	if (write(wakePipe[1], &wake, 1) < 0)
+	{
+		//Pipe lleno: ya hay un wakeup pendiente
+	}
+}
+
+char ConsoleControl::WaitForReadNextChar()
+{
+	return (char)ReadNextKey();
+}
+
+void ConsoleControl::WriteRaw(const std::string& text)
+{
+	//Se envia junto con el resto del buffer en el siguiente Unlock()
+	GetInstance()._output->Append(text);
+}
+
+void ConsoleControl::FlushOutput()
+{
+	if (IsHeadless())
+	{
+		GetInstance()._output->Discard();
+		return;
+	}
+
+	GetInstance()._output->Flush();
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifdef _WIN32
+#include "ConsoleControl.h"
+
+//Backend de la consola de Windows
+
+//Evento que WakeInput() activa para despertar la espera de ReadNextKey()
+static HANDLE wakeEvent = NULL;
+
+void ConsoleControl::InitializeBackend(ConsoleControl& control)
+{
+	//Activar las secuencias ANSI para que Present() pueda hacer un solo write
+	DWORD mode = 0;
+	GetConsoleMode(control._console, &mode);
+	SetConsoleMode(control._console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+	wakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+}
+
+HANDLE ConsoleControl::GetConsole()
+{
+	return GetInstance()._console;
+}
+
+void ConsoleControl::SetColor(ConsoleColor textColor, ConsoleColor backgroundColor) {
+	if (IsHeadless())
+		return;
+
+	WORD color = (backgroundColor << 4) | textColor;
+	SetConsoleTextAttribute(GetConsole(), color);
+}
+
+void ConsoleControl::SetPosition(short int x, short int y) {
+	if (IsHeadless())
+		return;
+
+	COORD pos{ x, y };
+	SetConsoleCursorPosition(GetConsole(), pos);
+}
+
+void ConsoleControl::FillWithCharacter(char character, ConsoleColor textColor, ConsoleColor backgroundColor)
+{
+	if (IsHeadless())
+		return;
+
+	COORD topLeft = { 0,0 };
+	CONSOLE_SCREEN_BUFFER_INFO screen;
+	DWORD written;
+	HANDLE console = GetConsole();
+
+	WORD color = (backgroundColor << 4) | textColor;
+	GetConsoleScreenBufferInfo(console, &screen);
+	FillConsoleOutputCharacterA(
+		console, character, screen.dwSize.X * screen.dwSize.Y, topLeft,	&written);
+	FillConsoleOutputAttribute(
+		console, color, screen.dwSize.X * screen.dwSize.Y, topLeft, &written);
+	SetConsoleCursorPosition(console, topLeft);
+}
+
+void ConsoleControl::ClearKeyBuffer()
+{
+	while (_kbhit())
+	{
+		_getch();
+	}
+}
+
+int ConsoleControl::ReadNextKey()
+{
+	int KB_code = 0;
+
+	while (KB_code == 0)
+	{
+		KB_code = ReadNextKey(-1);
+	}
+
+	return KB_code;
+}
+
+int ConsoleControl::ReadNextKey(int timeoutMs)
+{
+	GetInstance(); //El evento se crea en InitializeBackend
+
+	HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+	HANDLE handles[2] = { wakeEvent, input };
+	DWORD timeout = timeoutMs < 0 ? INFINITE : (DWORD)timeoutMs;
+	ULONGLONG start = GetTickCount64();
+
+	while (true)
+	{
+		if (_kbhit())
+			return _getch();
+
+		DWORD result = WaitForMultipleObjects(2, handles, FALSE, timeout);
+
+		if (result != WAIT_OBJECT_0 + 1)
+			return 0; //WakeInput(), timeout o error
+
+		//El handle de entrada tambien se activa con eventos de raton, foco o teclas soltadas,
+		//se descartan para que no vuelva a quedar senyalizado
+		INPUT_RECORD record;
+		DWORD events = 0;
+		while (PeekConsoleInput(input, &record, 1, &events) && events > 0)
+		{
+			if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown)
+				break;
+
+			ReadConsoleInput(input, &record, 1, &events);
+		}
+
+		if (timeoutMs >= 0)
+		{
+			ULONGLONG elapsed = GetTickCount64() - start;
+			if (elapsed >= (ULONGLONG)timeoutMs)
+				return _kbhit() ? _getch() : 0;
+
+			timeout = (DWORD)(timeoutMs - elapsed);
+		}
+	}
+}
+
+void ConsoleControl::WakeInput()
+{
+	GetInstance();
+
+	if (wakeEvent != NULL)
+		SetEvent(wakeEvent);
+}
+
+char ConsoleControl::WaitForReadNextChar()
+{
+	return (char)ReadNextKey();
+}
+
+void ConsoleControl::WriteRaw(const std::string& text)
+{
+	if (IsHeadless())
+		return;
+
+	std::cout.flush();
+
+	DWORD written = 0;
+	WriteConsoleA(GetConsole(), text.c_str(), (DWORD)text.size(), &written, NULL);
+}
+
+void ConsoleControl::FlushOutput()
+{
+	//La consola de Windows escribe directamente, no hay nada acumulado
+}
+
+#endif
\ No newline at end of file
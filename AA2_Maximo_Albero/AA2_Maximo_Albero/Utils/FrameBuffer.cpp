@@ -0,0 +1,112 @@
+#include "FrameBuffer.h"
+
+FrameBuffer::FrameBuffer(int width, int height)
+{
+	_width = width;
+	_height = height;
+
+	_front.resize(width * height);
+	_back.resize(width * height);
+
+	Invalidate();
+}
+
+void FrameBuffer::SetCell(int x, int y, char glyph, unsigned char textColor, unsigned char backgroundColor)
+{
+	if (x < 0 || y < 0 || x >= _width || y >= _height) {
+		return;
+	}
+
+	Cell& cell = _back[y * _width + x];
+	cell.glyph = glyph;
+	cell.textColor = textColor;
+	cell.backgroundColor = backgroundColor;
+}
+
+void FrameBuffer::Invalidate()
+{
+	for (Cell& cell : _front) {
+		cell.glyph = 0; //Ninguna celda del back buffer tiene glyph 0, asi todas cuentan como cambiadas
+	}
+}
+
+int FrameBuffer::BuildFrame(std::string& out)
+{
+	int changed = 0;
+	int cursorX = -1;
+	int cursorY = -1;
+	int currentText = -1;
+	int currentBackground = -1;
+
+	for (int y = 0; y < _height; y++) {
+		for (int x = 0; x < _width; x++) {
+			int index = y * _width + x;
+			Cell& back = _back[index];
+
+			if (back == _front[index]) {
+				continue;
+			}
+
+			//Solo movemos el cursor si la celda no es la siguiente a la ultima escrita
+			if (cursorX != x || cursorY != y) {
+				out += "\033[";
+				AppendNumber(out, y + 1);
+				out += ';';
+				AppendNumber(out, x + 1);
+				out += 'H';
+			}
+
+			//Solo cambiamos el color si es diferente al de la ultima celda
+			if (currentText != back.textColor || currentBackground != back.backgroundColor) {
+				out += "\033[";
+				AppendNumber(out, ToAnsiColor(back.textColor));
+				out += ';';
+				AppendNumber(out, ToAnsiColor(back.backgroundColor) + 10);
+				out += 'm';
+
+				currentText = back.textColor;
+				currentBackground = back.backgroundColor;
+			}
+
+			out += back.glyph;
+			cursorX = x + 1;
+			cursorY = y;
+
+			_front[index] = back;
+			changed++;
+		}
+	}
+
+	//Dejar el color por defecto (blanco sobre negro) para el texto que se escribe con std::cout
+	if (currentText != -1 && (currentText != 15 || currentBackground != 0)) {
+		out += "\033[97;40m";
+	}
+
+	return changed;
+}
+
+void FrameBuffer::AppendNumber(std::string& out, int number)
+{
+	char digits[12];
+	int count = 0;
+
+	do {
+		digits[count++] = (char)('0' + number % 10);
+		number /= 10;
+	} while (number > 0);
+
+	while (count > 0) {
+		out += digits[--count];
+	}
+}
+
+//Los colores de la consola de Windows van en orden BGR, los de ANSI en RGB
+int FrameBuffer::ToAnsiColor(unsigned char consoleColor)
+{
+	static const int ansiColors[16] = {
+		30, 34, 32, 36, 31, 35, 33, 37,
+		90, 94, 92, 96, 91, 95, 93, 97
+	};
+
+	return ansiColors[consoleColor & 0x0F];
+}
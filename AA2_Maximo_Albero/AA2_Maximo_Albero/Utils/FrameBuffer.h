@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+
+// Double buffer of console cells (glyph, text colour, background colour)
+// Entities draw into the back buffer, ConsoleControl::Present() diffs it
+// against the front buffer and writes only the cells that changed
+class FrameBuffer
+{
+public:
+	struct Cell
+	{
+		char glyph = ' ';
+		unsigned char textColor = 15;
+		unsigned char backgroundColor = 0;
+
+		bool operator==(const Cell& other) const {
+			return glyph == other.glyph && textColor == other.textColor && backgroundColor == other.backgroundColor;
+		}
+		bool operator!=(const Cell& other) const { return !(*this == other); }
+	};
+
+	struct FrameStats
+	{
+		int cellsChanged = 0;
+		int bytesWritten = 0;
+		int writeCalls = 0;
+	};
+
+public:
+	FrameBuffer(int width, int height);
+
+	void SetCell(int x, int y, char glyph, unsigned char textColor, unsigned char backgroundColor);
+
+	//Marca todo el front buffer como desconocido (despues de limpiar la pantalla)
+	void Invalidate();
+
+	//Construye en out los escapes ANSI de las celdas que han cambiado y las copia al front buffer
+	//Devuelve el numero de celdas cambiadas
+	int BuildFrame(std::string& out);
+
+	void Lock() { _bufferMutex.lock(); }
+	void Unlock() { _bufferMutex.unlock(); }
+
+	static void AppendNumber(std::string& out, int number);
+	static int ToAnsiColor(unsigned char consoleColor);
+
+private:
+	int _width;
+	int _height;
+
+	std::vector<Cell> _front;
+	std::vector<Cell> _back;
+
+	std::mutex _bufferMutex;
+};
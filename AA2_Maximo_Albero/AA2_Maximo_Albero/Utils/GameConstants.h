@@ -9,5 +9,14 @@
 #define BOTTOM_UI_TEXT_AREA 13
 
 
+// Enemigos, cofres e items que cada sala reserva al crearse (ObjectPool), si se llenan crecen
+#define ROOM_ENTITY_CAPACITY 16
+
+// Milisegundos entre dos acciones (mover o atacar) de un enemigo
+#define ENEMY_ACTION_COOLDOWN_MS 1000
+
+// Caminos que guarda cada PathService para repararlos en vez de buscarlos de nuevo
+#define PATH_CACHE_CAPACITY 32
+
 #define WORLD_WIDTH 3
 #define WORLD_HEIGHT 3
\ No newline at end of file
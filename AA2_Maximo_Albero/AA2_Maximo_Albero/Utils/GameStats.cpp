@@ -0,0 +1,108 @@
+#include "GameStats.h"
+#include <algorithm>
+
+std::atomic<long long>* GameStats::GetCounters()
+{
+	static std::atomic<long long> counters[COUNTER_COUNT] = {};
+
+	return counters;
+}
+
+std::vector<long long>* GameStats::GetTimings()
+{
+	static std::vector<long long> timings[TIMING_COUNT];
+
+	return timings;
+}
+
+std::mutex& GameStats::GetTimingsMutex()
+{
+	static std::mutex timingsMutex;
+
+	return timingsMutex;
+}
+
+void GameStats::Add(Counter counter, long long amount)
+{
+	GetCounters()[counter] += amount;
+}
+
+long long GameStats::Get(Counter counter)
+{
+	return GetCounters()[counter].load();
+}
+
+void GameStats::Reset()
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		GetCounters()[i] = 0;
+	}
+
+	GetTimingsMutex().lock();
+	for (int i = 0; i < TIMING_COUNT; i++)
+	{
+		GetTimings()[i].clear();
+	}
+	GetTimingsMutex().unlock();
+}
+
+void GameStats::AddTiming(Timing timing, long long microseconds)
+{
+	GetTimingsMutex().lock();
+	GetTimings()[timing].push_back(microseconds);
+	GetTimingsMutex().unlock();
+}
+
+long long GameStats::GetPercentile(Timing timing, double percentile)
+{
+	GetTimingsMutex().lock();
+	std::vector<long long> samples = GetTimings()[timing];
+	GetTimingsMutex().unlock();
+
+	if (samples.empty())
+		return 0;
+
+	// Nearest rank
+	size_t rank = (size_t)(percentile * (samples.size() - 1) + 0.5);
+	std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+
+	return samples[rank];
+}
+
+size_t GameStats::GetSampleCount(Timing timing)
+{
+	GetTimingsMutex().lock();
+	size_t count = GetTimings()[timing].size();
+	GetTimingsMutex().unlock();
+
+	return count;
+}
+
+void GameStats::PrintSummary(std::ostream& out, double elapsedSeconds)
+{
+	static const char* names[COUNTER_COUNT] = {
+		"ticks", "moves", "attacks", "spawns", "room changes", "saved rooms", "journal records", "timer wakeups",
+		"pool hits", "pool heap allocations", "flow field updates"
+	};
+
+	out << "Simulated " << elapsedSeconds << " s" << std::endl;
+
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		long long value = Get((Counter)i);
+		double perSecond = elapsedSeconds > 0 ? value / elapsedSeconds : 0;
+
+		out << names[i] << ": " << value << " (" << perSecond << "/s)" << std::endl;
+	}
+
+	static const char* timingNames[TIMING_COUNT] = {
+		"room change latency", "autosave stall", "autosave total", "time to first frame"
+	};
+
+	for (int i = 0; i < TIMING_COUNT; i++)
+	{
+		out << timingNames[i] << ": p50 " << GetPercentile((Timing)i, 0.5) << " us, p99 "
+			<< GetPercentile((Timing)i, 0.99) << " us (" << GetSampleCount((Timing)i) << " samples)" << std::endl;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <ostream>
+#include <vector>
+#include <mutex>
+
+// Global counters of game events
+// Used by the headless mode summary and for perf regression tracking
+class GameStats
+{
+public:
+	enum Counter {
+		TICKS, MOVES, ATTACKS, SPAWNS, ROOM_CHANGES, SAVED_ROOMS, JOURNAL_RECORDS, TIMER_WAKEUPS,
+		POOL_HITS,        // Objects created in a free ObjectPool slot
+		POOL_ALLOCATIONS, // Blocks an ObjectPool had to allocate after its preallocated one ran out
+		FLOW_FIELD_UPDATES, // BFS recomputations of a room's FlowField (player moved or obstacles changed)
+		COUNTER_COUNT
+	};
+
+	// Durations sampled in microseconds, reported as p50/p99
+	enum Timing {
+		ROOM_CHANGE_LATENCY,
+		AUTOSAVE_STALL,
+		AUTOSAVE_TOTAL,
+		TIME_TO_FIRST_FRAME, // Game::Start() until the first room is presented, includes loading
+		TIMING_COUNT
+	};
+
+	static void Add(Counter counter, long long amount = 1);
+	static long long Get(Counter counter);
+	static void Reset();
+
+	static void AddTiming(Timing timing, long long microseconds);
+	// percentile in [0, 1], 0 if there are no samples
+	static long long GetPercentile(Timing timing, double percentile);
+	static size_t GetSampleCount(Timing timing);
+
+	// Prints every counter and its rate per second, then every timing
+	static void PrintSummary(std::ostream& out, double elapsedSeconds);
+
+private:
+	static std::atomic<long long>* GetCounters();
+	static std::vector<long long>* GetTimings();
+	static std::mutex& GetTimingsMutex();
+};
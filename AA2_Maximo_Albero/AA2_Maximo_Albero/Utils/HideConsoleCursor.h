@@ -1,3 +1,4 @@
+#ifdef _WIN32
 #include <windows.h>
 
 void HideConsoleCursor()
@@ -8,4 +9,14 @@ void HideConsoleCursor()
     GetConsoleCursorInfo(hOut, &cursorInfo);
     cursorInfo.bVisible = false;
     SetConsoleCursorInfo(hOut, &cursorInfo);
-}
\ No newline at end of file
+}
+#else
+#include "ConsoleControl.h"
+
+void HideConsoleCursor()
+{
+    CC::Lock();
+    std::cout << "\033[?25l";
+    CC::Unlock();
+}
+#endif
\ No newline at end of file
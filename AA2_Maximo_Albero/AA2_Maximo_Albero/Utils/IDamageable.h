@@ -2,5 +2,6 @@
 class IDamageable {
 public:
 	virtual ~IDamageable() = default;
-	virtual void ReceiveDamage(int damageToAdd) = 0;
+	// False if the entity no longer exists (its state was removed)
+	virtual bool ReceiveDamage(int damageToAdd) = 0;
 };
\ No newline at end of file
@@ -2,38 +2,48 @@
 #include "ConsoleControl.h"
 #include "GameConstants.h"
 #include <iostream>
-#include <chrono>
-#include <thread>
+#include <algorithm>
 
-MessageSystem::MessageSystem() : _running(false), _thread(nullptr), _needsRedraw(false) {}
+MessageSystem::MessageSystem() : _timers(nullptr), _updateTimer(0), _needsRedraw(false) {}
 
 MessageSystem::~MessageSystem() 
 {
     Stop();
 }
 
-void MessageSystem::Start() 
+void MessageSystem::Start(TimerWheel* timers) 
 {
-    _running = true;
-    _thread = new std::thread(&MessageSystem::ThreadLoop, this);
+    _mutex.lock();
+
+    if (_updateTimer != 0)
+    {
+        _mutex.unlock();
+        return;
+    }
+
+    // Sin intervalo: solo se ejecuta cuando PushMessage() o la proxima caducidad lo piden
+    _timers = timers;
+    _updateTimer = _timers->Schedule([this]() { Update(); }, 0, _needsRedraw ? 0 : -1);
+
+    _mutex.unlock();
 }
 
 void MessageSystem::Stop() 
 {
-    _running = false;
-    if (_thread) 
-    {
-        _thread->join();
-        delete _thread;
-        _thread = nullptr;
-    }
+    _mutex.lock();
+    TimerWheel::TimerId updateTimer = _updateTimer;
+    _updateTimer = 0;
+    _mutex.unlock(); // Update() necesita el mutex, Cancel() puede esperar a que termine
+
+    if (updateTimer != 0)
+        _timers->Cancel(updateTimer);
 }
 
-void MessageSystem::PushMessage(const std::string& text, int durationMs) 
+void MessageSystem::PushMessage(const std::string& text, int durationSeconds) 
 {
     _mutex.lock();
 
-    _messages.insert(_messages.begin(), { text, durationMs });
+    _messages.insert(_messages.begin(), { text, std::chrono::steady_clock::now() + std::chrono::seconds(durationSeconds) });
 
     if (_messages.size() > _maxLines)
     {
@@ -41,20 +51,44 @@ void MessageSystem::PushMessage(const std::string& text, int durationMs)
     }
 
     _needsRedraw = true;
+    TimerWheel::TimerId updateTimer = _updateTimer;
     _mutex.unlock();
+
+    if (updateTimer != 0)
+        _timers->RunAfter(updateTimer, 0);
 }
 
-void MessageSystem::ThreadLoop() 
+// Quita los mensajes caducados, redibuja si algo ha cambiado
+// y se vuelve a programar para la siguiente caducidad
+void MessageSystem::Update()
 {
-    while (_running) 
+    _mutex.lock();
+
+    auto now = std::chrono::steady_clock::now();
+    size_t previousCount = _messages.size();
+
+    _messages.erase(std::remove_if(_messages.begin(), _messages.end(),
+        [now](const Message& message) { return message.expiresAt <= now; }), _messages.end());
+
+    bool redraw = _needsRedraw || _messages.size() != previousCount;
+    _needsRedraw = false;
+
+    int nextExpiryMs = -1;
+    for (const Message& message : _messages)
     {
-        if (_needsRedraw) 
-        {
-            DrawMessages();
-            _needsRedraw = false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        int remainingMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(message.expiresAt - now).count() + 1;
+        if (nextExpiryMs < 0 || remainingMs < nextExpiryMs)
+            nextExpiryMs = remainingMs;
     }
+
+    TimerWheel::TimerId updateTimer = _updateTimer;
+    _mutex.unlock();
+
+    if (redraw)
+        DrawMessages();
+
+    if (nextExpiryMs >= 0 && updateTimer != 0)
+        _timers->RunAfter(updateTimer, nextExpiryMs);
 }
 
 void MessageSystem::DrawMessages()
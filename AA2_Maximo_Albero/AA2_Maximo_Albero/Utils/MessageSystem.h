@@ -2,11 +2,12 @@
 #include <string>
 #include <vector>
 #include <mutex>
-#include <thread>
+#include <chrono>
+#include "TimerWheel.h"
 
 struct Message {
     std::string text;
-    int durationMs;
+    std::chrono::steady_clock::time_point expiresAt;
 };
 
 class MessageSystem {
@@ -14,18 +15,19 @@ public:
     MessageSystem();
     ~MessageSystem();
 
-    void Start();
+    // Drawing and expiry run as a job of timers, only when a message arrives or expires
+    void Start(TimerWheel* timers);
     void Stop();
-    void PushMessage(const std::string& text, int durationMs = 20);
+    void PushMessage(const std::string& text, int durationSeconds = 20);
 
 private:
     std::vector<Message> _messages;
     std::mutex _mutex;
-    std::thread* _thread;
+    TimerWheel* _timers;
+    TimerWheel::TimerId _updateTimer;
     bool _needsRedraw;
-    bool _running;
     const int _maxLines = 5;
 
-    void ThreadLoop();
+    void Update();
     void DrawMessages();
 };
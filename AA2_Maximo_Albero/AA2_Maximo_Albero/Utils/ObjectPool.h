@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <utility>
+#include <new>
+#include <cstddef>
+#include <cassert>
+#include "GameStats.h"
+
+// Typed pool of objects of T, allocated in blocks of blockSize
+// Create() constructs in a recycled slot, Destroy() runs the destructor and gives the slot back
+// The free list is threaded through the unused slots, so recycling never touches the heap
+// The first block is allocated in the constructor, later blocks only when the pool runs out
+// (counted in GameStats::POOL_ALLOCATIONS, it should stay at 0 in steady state)
+// A recycled slot has the same address as the object it held, so pointers say nothing about
+// identity: callers compare handles (SlotMap) and Destroy() asserts the slot is still live
+//
+// Lock order: the pool mutex is a leaf, constructors and destructors run without it
+template<typename T>
+class ObjectPool
+{
+public:
+	ObjectPool(size_t blockSize);
+	// Every object must have been destroyed already
+	~ObjectPool();
+
+	template<typename... Args>
+	T* Create(Args&&... args);
+
+	// Only for a live object of this pool, destroying it twice is a bug (asserted)
+	void Destroy(T* object);
+
+private:
+	struct Slot
+	{
+		union
+		{
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+		bool live; // Holds an object, between Create() and Destroy()
+	};
+
+	size_t _blockSize;
+	std::vector<Slot*> _blocks;
+	Slot* _freeList;
+	std::mutex _poolMutex;
+
+	void AllocateBlock();
+};
+
+// ===== TEMPLATE IMPLEMENTATIONS =====
+
+template<typename T>
+inline ObjectPool<T>::ObjectPool(size_t blockSize)
+	: _blockSize(blockSize > 0 ? blockSize : 1), _freeList(nullptr)
+{
+	AllocateBlock();
+}
+
+template<typename T>
+inline ObjectPool<T>::~ObjectPool()
+{
+	for (Slot* block : _blocks)
+	{
+		delete[] block;
+	}
+}
+
+template<typename T>
+inline void ObjectPool<T>::AllocateBlock()
+{
+	Slot* block = new Slot[_blockSize];
+	_blocks.push_back(block);
+
+	for (size_t i = 0; i < _blockSize; i++)
+	{
+		block[i].live = false;
+		block[i].next = _freeList;
+		_freeList = &block[i];
+	}
+}
+
+template<typename T>
+template<typename... Args>
+inline T* ObjectPool<T>::Create(Args&&... args)
+{
+	_poolMutex.lock();
+
+	if (_freeList == nullptr)
+	{
+		AllocateBlock();
+		GameStats::Add(GameStats::POOL_ALLOCATIONS);
+	}
+	else
+	{
+		GameStats::Add(GameStats::POOL_HITS);
+	}
+
+	Slot* slot = _freeList;
+	_freeList = slot->next;
+	slot->live = true;
+
+	_poolMutex.unlock();
+
+	return new (slot->storage) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+inline void ObjectPool<T>::Destroy(T* object)
+{
+	if (object == nullptr)
+		return;
+
+	// The storage is the first member of the slot
+	Slot* slot = reinterpret_cast<Slot*>(object);
+
+	// Checked and cleared before the destructor, a second Destroy() of the same slot fails here
+	_poolMutex.lock();
+	assert(slot->live && "ObjectPool::Destroy() of a slot that is not live");
+	slot->live = false;
+	_poolMutex.unlock();
+
+	object->~T();
+
+	_poolMutex.lock();
+	slot->next = _freeList;
+	_freeList = slot;
+	_poolMutex.unlock();
+}
@@ -0,0 +1,216 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Index of a slot plus the generation it had when the entity was inserted
+// Removing the entity bumps the generation, so old copies of the handle stop resolving
+struct EntityHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0; // 0 is never a live generation, a default handle is invalid
+
+	bool IsValid() const { return generation != 0; }
+
+	bool operator==(const EntityHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+// Handle <-> dense index bookkeeping of a slot map, without the values
+// The owner keeps its values in dense arrays (one or several, see EntityStore) and mirrors
+// what this class does: Insert() appends at Size() - 1, Remove() moves the last element
+// into the removed index (swap and pop)
+class SlotIndex
+{
+public:
+	static const int NOT_FOUND = -1;
+
+	EntityHandle Insert();
+
+	// Dense index of the handle, NOT_FOUND if it is invalid or was removed
+	int Find(EntityHandle handle) const;
+
+	// Returns the dense index that was removed, NOT_FOUND for a stale handle
+	// The owner must then move its last element to that index and pop the back
+	int Remove(EntityHandle handle);
+
+	// Invalidates every handle
+	void Clear();
+
+	size_t Size() const { return _denseToSlot.size(); }
+	EntityHandle GetHandleAt(size_t denseIndex) const;
+
+private:
+	struct Slot
+	{
+		uint32_t generation;
+		uint32_t denseIndex;
+	};
+
+	std::vector<Slot> _slots;
+	std::vector<uint32_t> _freeSlots;
+	std::vector<uint32_t> _denseToSlot;
+
+	void Release(uint32_t slotIndex);
+};
+
+// Slot map: handles point to slots, slots point into a dense array of values
+// Insert, Get and Remove are O(1). Remove moves the last value into the hole (swap and pop),
+// so the dense order changes and iteration by index must not advance after a removal
+//
+// Stores pointers and does not own them, the caller deletes what Remove() returns
+// Not thread-safe, the owner decides which lock guards it
+template<typename T>
+class SlotMap
+{
+public:
+	EntityHandle Insert(T* value);
+
+	// nullptr if the handle is invalid or its entity was removed
+	T* Get(EntityHandle handle) const;
+
+	// Returns the removed value, nullptr for a stale handle
+	T* Remove(EntityHandle handle);
+
+	// Invalidates every handle
+	void Clear();
+
+	size_t Size() const { return _dense.size(); }
+	bool Empty() const { return _dense.empty(); }
+
+	T* operator[](size_t denseIndex) const { return _dense[denseIndex]; }
+	EntityHandle GetHandleAt(size_t denseIndex) const { return _index.GetHandleAt(denseIndex); }
+
+	typename std::vector<T*>::const_iterator begin() const { return _dense.begin(); }
+	typename std::vector<T*>::const_iterator end() const { return _dense.end(); }
+
+private:
+	SlotIndex _index;
+	std::vector<T*> _dense;
+};
+
+// ===== SLOT INDEX =====
+
+inline EntityHandle SlotIndex::Insert()
+{
+	uint32_t slotIndex;
+
+	if (!_freeSlots.empty())
+	{
+		slotIndex = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = (uint32_t)_slots.size();
+		_slots.push_back(Slot{ 1, 0 });
+	}
+
+	Slot& slot = _slots[slotIndex];
+	slot.denseIndex = (uint32_t)_denseToSlot.size();
+	_denseToSlot.push_back(slotIndex);
+
+	EntityHandle handle;
+	handle.index = slotIndex;
+	handle.generation = slot.generation;
+	return handle;
+}
+
+inline int SlotIndex::Find(EntityHandle handle) const
+{
+	if (!handle.IsValid() || handle.index >= _slots.size())
+		return NOT_FOUND;
+
+	const Slot& slot = _slots[handle.index];
+	if (slot.generation != handle.generation)
+		return NOT_FOUND;
+
+	return (int)slot.denseIndex;
+}
+
+inline int SlotIndex::Remove(EntityHandle handle)
+{
+	int denseIndex = Find(handle);
+	if (denseIndex == NOT_FOUND)
+		return NOT_FOUND;
+
+	// The last element fills the hole and its slot is pointed at the new position
+	uint32_t lastIndex = (uint32_t)_denseToSlot.size() - 1;
+	if ((uint32_t)denseIndex != lastIndex)
+	{
+		_denseToSlot[denseIndex] = _denseToSlot[lastIndex];
+		_slots[_denseToSlot[denseIndex]].denseIndex = (uint32_t)denseIndex;
+	}
+
+	_denseToSlot.pop_back();
+
+	Release(handle.index);
+	return denseIndex;
+}
+
+inline void SlotIndex::Clear()
+{
+	for (uint32_t slotIndex : _denseToSlot)
+	{
+		Release(slotIndex);
+	}
+
+	_denseToSlot.clear();
+}
+
+inline EntityHandle SlotIndex::GetHandleAt(size_t denseIndex) const
+{
+	EntityHandle handle;
+	handle.index = _denseToSlot[denseIndex];
+	handle.generation = _slots[handle.index].generation;
+	return handle;
+}
+
+inline void SlotIndex::Release(uint32_t slotIndex)
+{
+	Slot& slot = _slots[slotIndex];
+
+	// Generation 0 marks invalid handles, it is skipped when the counter wraps
+	slot.generation++;
+	if (slot.generation == 0)
+		slot.generation = 1;
+
+	_freeSlots.push_back(slotIndex);
+}
+
+// ===== SLOT MAP =====
+
+template<typename T>
+inline EntityHandle SlotMap<T>::Insert(T* value)
+{
+	_dense.push_back(value);
+	return _index.Insert();
+}
+
+template<typename T>
+inline T* SlotMap<T>::Get(EntityHandle handle) const
+{
+	int denseIndex = _index.Find(handle);
+	return denseIndex != SlotIndex::NOT_FOUND ? _dense[denseIndex] : nullptr;
+}
+
+template<typename T>
+inline T* SlotMap<T>::Remove(EntityHandle handle)
+{
+	int denseIndex = _index.Remove(handle);
+	if (denseIndex == SlotIndex::NOT_FOUND)
+		return nullptr;
+
+	T* value = _dense[denseIndex];
+	_dense[denseIndex] = _dense.back();
+	_dense.pop_back();
+
+	return value;
+}
+
+template<typename T>
+inline void SlotMap<T>::Clear()
+{
+	_index.Clear();
+	_dense.clear();
+}
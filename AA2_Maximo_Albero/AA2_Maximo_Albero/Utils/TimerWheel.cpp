@@ -0,0 +1,300 @@
+#include "TimerWheel.h"
+#include "GameStats.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(int resolutionMs)
+	: _resolutionMs(resolutionMs > 0 ? resolutionMs : 1),
+	_startTime(std::chrono::steady_clock::now()),
+	_currentTick(0),
+	_nextId(0),
+	_runningTimer(nullptr),
+	_thread(nullptr),
+	_running(false)
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+	Stop();
+
+	for (auto& entry : _timers)
+	{
+		delete entry.second;
+	}
+}
+
+void TimerWheel::Start()
+{
+	_wheelMutex.lock();
+
+	if (_running)
+	{
+		_wheelMutex.unlock();
+		return;
+	}
+
+	_running = true;
+	_thread = new std::thread(&TimerWheel::Run, this);
+	_threadId = _thread->get_id();
+
+	_wheelMutex.unlock();
+}
+
+void TimerWheel::Stop()
+{
+	_wheelMutex.lock();
+
+	if (!_running)
+	{
+		_wheelMutex.unlock();
+		return;
+	}
+
+	_running = false;
+	_wheelMutex.unlock(); // Unlock BEFORE join, the thread needs it to see the stop
+
+	_wakeCondition.notify_all();
+
+	if (_thread != nullptr)
+	{
+		if (_thread->joinable())
+			_thread->join();
+
+		delete _thread;
+		_thread = nullptr;
+	}
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(Callback callback, int intervalMs, int firstDelayMs)
+{
+	std::unique_lock<std::mutex> lock(_wheelMutex);
+
+	Timer* timer = new Timer();
+	timer->id = ++_nextId;
+	timer->callback = callback;
+	timer->intervalTicks = intervalMs > 0 ? std::max(1, (intervalMs + _resolutionMs - 1) / _resolutionMs) : 0;
+	timer->dueTick = 0;
+	timer->armed = false;
+	timer->pendingRun = false;
+	timer->cancelled = false;
+
+	_timers[timer->id] = timer;
+
+	if (firstDelayMs < 0 && intervalMs > 0)
+		firstDelayMs = intervalMs;
+
+	if (firstDelayMs >= 0)
+	{
+		Arm(timer, DelayToTick(firstDelayMs));
+		_wakeCondition.notify_all();
+	}
+
+	return timer->id;
+}
+
+void TimerWheel::RunAfter(TimerId id, int delayMs)
+{
+	std::unique_lock<std::mutex> lock(_wheelMutex);
+
+	auto it = _timers.find(id);
+	if (it == _timers.end())
+		return;
+
+	Timer* timer = it->second;
+
+	// Already collected, it runs before anything else can be due
+	if (timer->pendingRun)
+		return;
+
+	uint64_t dueTick = DelayToTick(delayMs);
+	if (timer->armed && timer->dueTick <= dueTick)
+		return;
+
+	Arm(timer, dueTick);
+	_wakeCondition.notify_all();
+}
+
+void TimerWheel::Cancel(TimerId id)
+{
+	std::unique_lock<std::mutex> lock(_wheelMutex);
+
+	auto it = _timers.find(id);
+	if (it == _timers.end())
+		return;
+
+	Timer* timer = it->second;
+	_timers.erase(it);
+	Disarm(timer);
+
+	if (timer->pendingRun)
+	{
+		_dueTimers.erase(std::find(_dueTimers.begin(), _dueTimers.end(), timer));
+		timer->pendingRun = false;
+	}
+
+	if (timer != _runningTimer)
+	{
+		delete timer;
+		return;
+	}
+
+	// Running now: Run() deletes it when the callback returns
+	timer->cancelled = true;
+
+	// The wheel thread never waits for itself
+	if (std::this_thread::get_id() == _threadId)
+		return;
+
+	_callbackFinished.wait(lock, [this, timer]() { return _runningTimer != timer; });
+}
+
+void TimerWheel::Run()
+{
+	std::unique_lock<std::mutex> lock(_wheelMutex);
+
+	while (_running)
+	{
+		CollectDue(GetNowTick());
+
+		while (!_dueTimers.empty() && _running)
+		{
+			Timer* timer = _dueTimers.front();
+			_dueTimers.erase(_dueTimers.begin());
+			timer->pendingRun = false;
+			_runningTimer = timer;
+
+			lock.unlock();
+			timer->callback();
+			lock.lock();
+
+			_runningTimer = nullptr;
+
+			if (timer->cancelled)
+			{
+				delete timer;
+			}
+			else if (timer->intervalTicks > 0 && !timer->armed)
+			{
+				// Periods lost while the thread was busy are skipped, not run in a burst
+				uint64_t nextTick = timer->dueTick + timer->intervalTicks;
+				uint64_t nowTick = GetNowTick();
+				if (nextTick <= nowTick)
+					nextTick = nowTick + 1;
+
+				Arm(timer, nextTick);
+			}
+
+			_callbackFinished.notify_all();
+		}
+
+		if (!_running)
+			break;
+
+		uint64_t nextDueTick = GetNextDueTick();
+		if (nextDueTick == UINT64_MAX)
+			_wakeCondition.wait(lock);
+		else
+			_wakeCondition.wait_until(lock, _startTime + std::chrono::milliseconds(nextDueTick * _resolutionMs));
+
+		GameStats::Add(GameStats::TIMER_WAKEUPS);
+	}
+}
+
+uint64_t TimerWheel::GetNowTick() const
+{
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _startTime);
+	return (uint64_t)(elapsed.count() / _resolutionMs);
+}
+
+uint64_t TimerWheel::DelayToTick(int delayMs) const
+{
+	if (delayMs < 0)
+		delayMs = 0;
+
+	return GetNowTick() + (uint64_t)((delayMs + _resolutionMs - 1) / _resolutionMs);
+}
+
+void TimerWheel::Arm(Timer* timer, uint64_t dueTick)
+{
+	Disarm(timer);
+
+	// Ticks before _currentTick were already processed
+	if (dueTick < _currentTick)
+		dueTick = _currentTick;
+
+	timer->dueTick = dueTick;
+	timer->armed = true;
+	_slots[dueTick % SLOT_COUNT].push_back(timer);
+}
+
+void TimerWheel::Disarm(Timer* timer)
+{
+	if (!timer->armed)
+		return;
+
+	std::vector<Timer*>& slot = _slots[timer->dueTick % SLOT_COUNT];
+	slot.erase(std::find(slot.begin(), slot.end(), timer));
+	timer->armed = false;
+}
+
+// Moves every job due up to nowTick to _dueTimers
+// After a long sleep each slot is visited once, not once per elapsed tick
+void TimerWheel::CollectDue(uint64_t nowTick)
+{
+	if (nowTick < _currentTick)
+		return;
+
+	uint64_t lastTick = std::min(nowTick, _currentTick + SLOT_COUNT - 1);
+
+	for (uint64_t tick = _currentTick; tick <= lastTick; tick++)
+	{
+		std::vector<Timer*>& slot = _slots[tick % SLOT_COUNT];
+
+		for (size_t i = 0; i < slot.size(); )
+		{
+			Timer* timer = slot[i];
+
+			if (timer->dueTick > nowTick)
+			{
+				i++;
+				continue;
+			}
+
+			slot[i] = slot.back();
+			slot.pop_back();
+			timer->armed = false;
+			timer->pendingRun = true;
+			_dueTimers.push_back(timer);
+		}
+	}
+
+	_currentTick = nowTick + 1;
+
+	std::stable_sort(_dueTimers.begin(), _dueTimers.end(),
+		[](const Timer* a, const Timer* b) { return a->dueTick < b->dueTick; });
+}
+
+uint64_t TimerWheel::GetNextDueTick() const
+{
+	// Nearest slots first, a job due in this turn of the wheel ends the search
+	for (uint64_t tick = _currentTick; tick < _currentTick + SLOT_COUNT; tick++)
+	{
+		for (const Timer* timer : _slots[tick % SLOT_COUNT])
+		{
+			if (timer->dueTick == tick)
+				return tick;
+		}
+	}
+
+	// Only jobs more than a turn away (autosave, spawns)
+	uint64_t nextDueTick = UINT64_MAX;
+	for (const std::vector<Timer*>& slot : _slots)
+	{
+		for (const Timer* timer : slot)
+		{
+			nextDueTick = std::min(nextDueTick, timer->dueTick);
+		}
+	}
+
+	return nextDueTick;
+}
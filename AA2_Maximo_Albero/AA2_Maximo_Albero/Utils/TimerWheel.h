@@ -0,0 +1,84 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+
+// Runs the periodic jobs of the game (spawns, autosave, sidebar, messages) from a single thread
+// Hashed timing wheel: SLOT_COUNT slots of resolutionMs, a job goes to the slot of its due tick
+// and longer delays simply wrap around. The thread sleeps until the next due job, it does not
+// wake up on every slot, and Schedule() / RunAfter() / Cancel() wake it when that changes
+//
+// Callbacks run without the wheel mutex, so they can call back into the wheel
+// Lock order: the wheel mutex is a leaf, never held while a callback runs
+class TimerWheel
+{
+public:
+	typedef uint64_t TimerId; // 0 is never a valid id
+	typedef std::function<void()> Callback;
+
+	static const int SLOT_COUNT = 256;
+
+	TimerWheel(int resolutionMs = 10);
+	~TimerWheel();
+
+	void Start();
+	// Jobs still registered stay registered, they just stop running
+	void Stop();
+
+	// intervalMs > 0: runs every intervalMs, first after firstDelayMs (interval if negative)
+	// intervalMs <= 0: runs once after firstDelayMs, never if negative, RunAfter() arms it again
+	TimerId Schedule(Callback callback, int intervalMs, int firstDelayMs = -1);
+
+	// Arms the job to run in delayMs, unless it is already due sooner
+	void RunAfter(TimerId id, int delayMs);
+
+	// Once it returns the callback is not running and will not run again
+	// Called from the job's own callback it does not wait, the job is removed when it returns
+	void Cancel(TimerId id);
+
+private:
+	struct Timer
+	{
+		TimerId id;
+		Callback callback;
+		int intervalTicks; // 0 for one-shot jobs
+		uint64_t dueTick;
+		bool armed;        // In a slot
+		bool pendingRun;   // Collected as due, waiting in _dueTimers
+		bool cancelled;
+	};
+
+	int _resolutionMs;
+	std::chrono::steady_clock::time_point _startTime;
+
+	std::vector<Timer*> _slots[SLOT_COUNT];
+	std::map<TimerId, Timer*> _timers;
+	std::vector<Timer*> _dueTimers;
+	uint64_t _currentTick; // Next tick to process
+	TimerId _nextId;
+
+	Timer* _runningTimer;
+	std::thread* _thread;
+	std::thread::id _threadId;
+	std::atomic<bool> _running;
+	std::mutex _wheelMutex;
+	std::condition_variable _wakeCondition;
+	std::condition_variable _callbackFinished;
+
+	void Run();
+	uint64_t GetNowTick() const;
+	uint64_t DelayToTick(int delayMs) const;
+
+	// With _wheelMutex held
+	void Arm(Timer* timer, uint64_t dueTick);
+	void Disarm(Timer* timer);
+	void CollectDue(uint64_t nowTick);
+	// UINT64_MAX if no job is armed
+	uint64_t GetNextDueTick() const;
+};
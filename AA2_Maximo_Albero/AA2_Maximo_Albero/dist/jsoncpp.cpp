@@ -105,6 +105,17 @@ license you like.
 #include <clocale>
 #endif
 
+// std::to_chars / std::from_chars for doubles: locale independent and much
+// faster than snprintf and istringstream. Needs C++17 and a standard library
+// with floating point <charconv> (__cpp_lib_to_chars), otherwise the
+// original paths are used.
+#if !defined(JSONCPP_HAS_CHARCONV) && __cplusplus >= 201703L
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define JSONCPP_HAS_CHARCONV 1
+#endif
+#endif
+
 /* This header provides common string manipulation support, such as UTF-8,
  * portable conversion from/to string...
  *
@@ -820,6 +831,16 @@ bool Reader::decodeDouble(Token& token) {
 
 bool Reader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
+#if JSONCPP_HAS_CHARCONV
+  std::from_chars_result result =
+      std::from_chars(token.start_, token.end_, value);
+  if (result.ec == std::errc() && result.ptr == token.end_) {
+    decoded = value;
+    return true;
+  }
+  // Out of range values keep the stream behaviour (clamped to infinity)
+  value = 0;
+#endif
   IStringStream is(String(token.start_, token.end_));
   if (!(is >> value)) {
     if (value == std::numeric_limits<double>::max())
@@ -1854,6 +1875,16 @@ bool OurReader::decodeDouble(Token& token) {
 
 bool OurReader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
+#if JSONCPP_HAS_CHARCONV
+  std::from_chars_result result =
+      std::from_chars(token.start_, token.end_, value);
+  if (result.ec == std::errc() && result.ptr == token.end_) {
+    decoded = value;
+    return true;
+  }
+  // Out of range values keep the stream behaviour (clamped to infinity)
+  value = 0;
+#endif
   IStringStream is(String(token.start_, token.end_));
   if (!(is >> value)) {
     if (value == std::numeric_limits<double>::max())
@@ -4281,20 +4312,37 @@ String valueToString(double value, bool useSpecialFloats,
     return useSpecialFloats ? "Infinity" : "1e+9999";
   }
 
-  String buffer(size_t(36), '\0');
-  while (true) {
-    int len = jsoncpp_snprintf(
-        &*buffer.begin(), buffer.size(),
-        (precisionType == PrecisionType::significantDigits) ? "%.*g" : "%.*f",
-        precision, value);
-    assert(len >= 0);
-    auto wouldPrint = static_cast<size_t>(len);
-    if (wouldPrint >= buffer.size()) {
-      buffer.resize(wouldPrint + 1);
-      continue;
+  String buffer;
+#if JSONCPP_HAS_CHARCONV
+  // Same output as "%.*g" / "%.*f" in the C locale
+  char chars[64];
+  std::to_chars_result result = std::to_chars(
+      chars, chars + sizeof(chars), value,
+      (precisionType == PrecisionType::significantDigits)
+          ? std::chars_format::general
+          : std::chars_format::fixed,
+      static_cast<int>(precision));
+  if (result.ec == std::errc())
+    buffer.assign(chars, result.ptr);
+#endif
+  // Large fixed notation values do not fit in chars
+  if (buffer.empty()) {
+    buffer.assign(size_t(36), '\0');
+    while (true) {
+      int len = jsoncpp_snprintf(
+          &*buffer.begin(), buffer.size(),
+          (precisionType == PrecisionType::significantDigits) ? "%.*g"
+                                                              : "%.*f",
+          precision, value);
+      assert(len >= 0);
+      auto wouldPrint = static_cast<size_t>(len);
+      if (wouldPrint >= buffer.size()) {
+        buffer.resize(wouldPrint + 1);
+        continue;
+      }
+      buffer.resize(wouldPrint);
+      break;
     }
-    buffer.resize(wouldPrint);
-    break;
   }
 
   buffer.erase(fixNumericLocale(buffer.begin(), buffer.end()), buffer.end());